@@ -6,7 +6,13 @@
 #include <cmath>
 #include <cassert>
 #include <numeric>
-#include "euclidean.hpp"
+#include <span>
+#include "discrete_math/euclidean_algorithm/euclidean.hpp"
+#include "discrete_math/number_theory/crt.hpp"
+#include "discrete_math/number_theory/factorization.hpp"
+#include "discrete_math/number_theory/linear_sieve.hpp"
+#include "discrete_math/number_theory/modint.hpp"
+#include "discrete_math/number_theory/sieve.hpp"
 namespace number_theory
 {
     // Function to check if a vector of numbers are pairwise coprime.
@@ -22,35 +28,20 @@ namespace number_theory
         return true;
     }
     /*finds num ^ exponent modulo mod, ensure that it is of O(log(exponent))
-     * complexity*/
+     * complexity; products are reduced in 128 bits by static_modint, so any
+     * 64-bit mod works and negative num is taken modulo mod*/
     template <std::size_t mod>
     inline auto modular_pow(std::integral auto num, std::size_t exponent)
     {
         using T = std::remove_cvref_t<decltype(num)>;
-        if (mod == 1) return 0;
-        T result{ 1 };
-        num %= mod;
-        while (exponent > 0) {
-            if (exponent % 2 == 1)
-                result = (result * num) % mod;
-            num = (num * num) % mod;
-            exponent /= 2;
-        }
-        return result;
+        return static_cast<T>(number_theory::static_modint<mod>{ num }.pow(exponent).value());
     }
     /*finds (if exists) modular inverse of num,that is a number inv such that
      * num * inv = 1 modulo mod*/
-     // extended_gcd?
     template <std::size_t mod>
     inline auto modular_inverse(std::integral auto num) {
-        auto [result, _] = algorithms::gcd_extended(num, mod);
-        auto [coefficients, gcd] = result;
-        auto [x, _unused] = coefficients;
-        int modulo = mod;
-        if (gcd != 1) {
-            throw std::invalid_argument("Inverse does not exist.");
-        }
-        return ((x % modulo) + modulo) % modulo;
+        using T = std::remove_cvref_t<decltype(num)>;
+        return static_cast<T>(number_theory::static_modint<mod>{ num }.inverse().value());
     }
     /*find a solution x of ax = b modulo mod*/
     template <std::size_t mod>
@@ -60,52 +51,64 @@ namespace number_theory
         }
         return (b * number_theory::modular_inverse<mod>(a) % mod);
     }
-    /*returns primes smaller than up_to*/
+    /*returns primes smaller than up_to, streamed from the segmented sieve of
+     * sieve.hpp into a vector reserved for the bound pi(x) < 1.26 x / ln(x)*/
     inline auto sieve_of_eratosthenes(std::size_t up_to) {
-        std::vector<bool> is_prime(up_to + 1, true);
+        constexpr double prime_density_bound = 1.26;
         std::vector<size_t> primes;
-        for (size_t i = 2; i < up_to; i++) {
-            if (is_prime[i]) {
-                for (size_t j = 2 * i; j < up_to; j += i) {
-                    is_prime[j] = false;
-                }
-            }
-        }
-        for (size_t i = 2; i < up_to; i++) {
-            if (is_prime[i]) {
-                primes.push_back(i);
-            }
+        if (up_to > 2) {
+            primes.reserve(static_cast<std::size_t>(prime_density_bound * static_cast<double>(up_to) /
+                                                    std::log(static_cast<double>(up_to))));
         }
+        for_each_prime(0, up_to, [&primes](std::uint64_t p) { primes.push_back(static_cast<std::size_t>(p)); });
         return primes;
     }
-    /*decomposes a number into powers of primes*/
+    /*decomposes a number into powers of primes, in increasing order; values
+     * below 2 have no factors. Looked up in the smallest-prime-factor table of
+     * linear_sieve.hpp in O(log(value)) up to factor_table_bound, larger values
+     * are split by Pollard's rho of factorization.hpp*/
     inline auto decompose(std::integral auto value) {
-        std::vector<std::pair<int, int>> primeFactors;
-        for (int i = 2; i <= value / i; ++i) {
-            int count = 0;
-            while (value % i == 0) {
-                ++count;
-                value /= i;
-            }
-            if (count > 0) {
-                primeFactors.emplace_back(i, count);
-            }
+        using T = decltype(value);
+        std::vector<std::pair<T, int>> primeFactors;
+        if (value < 2) {
+            return primeFactors;
         }
-        if (value > 1) {
-            primeFactors.emplace_back(value, 1);
+        for (const auto& [prime, power] : default_factor_table().decompose(static_cast<std::uint64_t>(value))) {
+            primeFactors.emplace_back(static_cast<T>(prime), static_cast<int>(power));
         }
         return primeFactors;
     }
-    /*calculates Euler’s Totient Function*/
+    /*checks if a number is prime, by the smallest-prime-factor table up to
+     * factor_table_bound and by deterministic Miller-Rabin above it*/
+    inline auto is_prime(std::integral auto value) {
+        if (value < 2) {
+            return false;
+        }
+        const auto n = static_cast<std::uint64_t>(value);
+        const auto& table = default_factor_table();
+        return n <= table.bound ? table.smallest_prime_factors[n] == n : miller_rabin(n);
+    }
+    /*calculates Euler’s Totient Function, 0 for values below 1*/
     inline auto euler_totient(std::integral auto value) {
-    std:size_t result = 0;
-        for (int i = 1; i <= value; i++) {
-            if (std::gcd(i, value) == 1) {
-                result++;
-            }
+        std::size_t result = 0;
+        if (value >= 1) {
+            result = static_cast<std::size_t>(default_factor_table().totient(static_cast<std::uint64_t>(value)));
         }
         return result;
     }
+    /*Euler's totient of every value, out.size() == values.size()*/
+    inline auto euler_totient(std::span<const std::uint64_t> values, std::span<std::uint64_t> out) {
+        default_factor_table().totient(values, out);
+    }
+    /*calculates the Moebius function, 0 if a square divides value and
+     * (-1)^(number of prime factors) otherwise*/
+    inline auto moebius(std::integral auto value) {
+        return value < 1 ? 0 : default_factor_table().moebius(static_cast<std::uint64_t>(value));
+    }
+    /*Moebius function of every value, out.size() == values.size()*/
+    inline auto moebius(std::span<const std::uint64_t> values, std::span<int> out) {
+        default_factor_table().moebius(values, out);
+    }
     /*finds the largest power pow of prime such that prime^pow divides value*/
     inline auto largest_power_of_prime_dividing_factorial(std::integral auto value, std::integral auto prime) {
         using I = decltype(prime);
@@ -116,26 +119,35 @@ namespace number_theory
         }
         return pow;
     }
-    // Function to solve a system of linear congruences
+    /*solves the system as[i] x = bs[i] modulo mods[i]: every congruence is
+     * divided by g = gcd(as[i], mods[i]) into x = c modulo mods[i] / g with
+     * the inverse of as[i] / g, and the congruences, coprime or not, are
+     * merged by Garner's algorithm of crt.hpp in word-sized arithmetic.
+     * Returns the least nonnegative solution, which has to fit in 64 bits;
+     * throws std::invalid_argument if there is none*/
     template <std::integral I>
     inline auto linear_congruence_solver(std::vector<I> as, std::vector<I> bs, std::vector<std::size_t> mods) {
         assert(as.size() == bs.size() && bs.size() == mods.size());
         using T = std::common_type_t<I, std::size_t>;
-        T x = 0;
-        T M = 1;
-        for (const auto& mod : mods) {
-            M *= static_cast<T>(mod);
-        }
+        std::vector<number_theory::congruence> congruences;
         for (std::size_t i = 0; i < as.size(); ++i) {
-            T a = static_cast<T>(as[i]);
-            T b = static_cast<T>(bs[i]);
-            T mod = static_cast<T>(mods[i]);
-
-            T Mi = M / mod;
-            T Mi_inv = static_cast<T>(number_theory::modular_inverse<static_cast<std::size_t>(mod)>(Mi));
-            x = (x + b * Mi * Mi_inv) % M;
+            const std::uint64_t mod = mods[i];
+            const std::uint64_t a = number_theory::residue_of(as[i], mod);
+            const std::uint64_t b = number_theory::residue_of(bs[i], mod);
+            const std::uint64_t g = std::gcd(a, mod);
+            if (b % g != 0) {
+                throw std::invalid_argument("Solution does not exist.");
+            }
+            const std::uint64_t reduced_mod = mod / g;
+            const number_theory::barrett reduction{ reduced_mod };
+            const std::uint64_t a_inverse = *number_theory::inverse_modulo(a / g, reduced_mod);
+            congruences.push_back({ reduction.reduce(number_theory::uint128{ b / g } * a_inverse), reduced_mod });
+        }
+        const auto solution = number_theory::chinese_remainder(congruences);
+        if (!solution) {
+            throw std::invalid_argument("Solution does not exist.");
         }
-        return (x % M + M) % M;
+        return static_cast<T>(solution->residue);
     }
 }
 namespace tests {
@@ -173,6 +185,18 @@ namespace tests {
         assert(primes == expected_primes);
         return true;
     }
+    bool test_prime_streaming_and_counting_functions() {
+        // Test 6b: Streaming over a range far from zero and prime counting agree
+        std::vector<std::uint64_t> primes;
+        number_theory::for_each_prime(1000000, 1000100, [&primes](std::uint64_t p) { primes.push_back(p); });
+        std::vector<std::uint64_t> expected_primes = { 1000003, 1000033, 1000037, 1000039, 1000081, 1000099 };
+        assert(primes == expected_primes);
+        assert(number_theory::prime_pi(1) == 0);
+        assert(number_theory::prime_pi(50) == 15);
+        assert(number_theory::prime_pi(1000000) == 78498);
+        assert(number_theory::prime_pi(10000000000) == 455052511);
+        return true;
+    }
     bool test_prime_factor_decomposition_function() {
         // Test 7: Prime factor decomposition returns correct results
         auto factors = number_theory::decompose(90);
@@ -186,6 +210,36 @@ namespace tests {
         assert(number_theory::euler_totient(15) == 8);
         return true;
     }
+    bool test_factor_table_functions() {
+        // Test 8b: Linear sieve table, batched queries and values above the table bound
+        const number_theory::factor_table table{ 100 };
+        assert(table.smallest_prime_factors[91] == 7);
+        assert(table.totient(36) == 12 && table.moebius(30) == -1 && table.moebius(12) == 0);
+        auto large = number_theory::decompose(std::int64_t{ 600851475143 });
+        std::vector<std::pair<std::int64_t, int>> expected_large = { {71, 1}, {839, 1}, {1471, 1}, {6857, 1} };
+        assert(large == expected_large);
+        std::vector<std::uint64_t> values = { 1, 10, 97, 1000000, 600851475143 };
+        std::vector<std::uint64_t> totients(values.size());
+        std::vector<int> moebius_values(values.size());
+        number_theory::euler_totient(values, totients);
+        number_theory::moebius(values, moebius_values);
+        std::vector<std::uint64_t> expected_totients = { 1, 4, 96, 400000, 70 * 838 * 1470 * std::uint64_t{ 6856 } };
+        std::vector<int> expected_moebius = { 1, 1, -1, 0, 1 };
+        assert(totients == expected_totients && moebius_values == expected_moebius);
+        return true;
+    }
+    bool test_primality_and_large_factorization_functions() {
+        // Test 8c: Miller-Rabin and Pollard's rho on 64-bit values
+        assert(!number_theory::is_prime(-7) && !number_theory::is_prime(1) && number_theory::is_prime(2));
+        assert(number_theory::is_prime(std::uint64_t{ 18446744073709551557U }));
+        assert(!number_theory::is_prime(std::uint64_t{ 3825123056546413051U }));
+        auto factors = number_theory::decompose(std::uint64_t{ 4294967291U } * 4294967279U);
+        std::vector<std::pair<std::uint64_t, int>> expected_factors = { {4294967279U, 1}, {4294967291U, 1} };
+        assert(factors == expected_factors);
+        auto powers = number_theory::factorize(std::uint64_t{ 1 } << 63);
+        assert(powers.size() == 1 && powers[0].first == 2 && powers[0].second == 63);
+        return true;
+    }
     bool test_largest_power_of_prime_dividing_factorial_function() {
         // Test 9: Largest power of prime dividing factorial is calculated correctly
         assert(number_theory::largest_power_of_prime_dividing_factorial(10, 2) == 1);
@@ -201,6 +255,71 @@ namespace tests {
         assert(number_theory::linear_congruence_solver(as, bs, mods) == 31);
         return true;
     }
+    bool test_modint_functions() {
+        // Test 11: Modular arithmetic with compile-time and runtime moduli, batched pow and inverse
+        constexpr std::uint64_t mersenne61 = (std::uint64_t{ 1 } << 61) - 1;
+        using field = number_theory::static_modint<mersenne61>;
+        assert(field{ 2 }.pow(61) == field{ 1 });
+        assert(field{ -1 }.value() == mersenne61 - 1);
+        assert(field{ 123456789 } * field{ 123456789 }.inverse() == field{ 1 });
+        assert(number_theory::modular_pow<mersenne61>(std::uint64_t{ 3 }, mersenne61 - 1) == 1);
+        assert(number_theory::modular_pow<10>(-3, 3) == 3);
+        using residue = number_theory::dynamic_modint<>;
+        number_theory::runtime_modulus<0>::set(1000000007);
+        assert(residue{ 10 }.pow(9) == residue{ -7 });
+        assert(residue{ 6 } / residue{ 3 } == residue{ 2 });
+        number_theory::runtime_modulus<0>::set(std::uint64_t{ 0xFFFFFFFFFFFFFFC5 });
+        std::vector<residue> values;
+        for (std::uint64_t v = 1; v <= 20; v++) {
+            values.emplace_back(v * 0x9E3779B97F4A7C15);
+        }
+        std::vector<residue> inverses(values.size());
+        std::vector<residue> squares(values.size());
+        number_theory::inverse(std::span<const residue>{ values }, std::span<residue>{ inverses });
+        number_theory::pow(std::span<const residue>{ values }, 2, std::span<residue>{ squares });
+        for (std::size_t i = 0; i < values.size(); i++) {
+            assert(values[i] * inverses[i] == residue{ 1 });
+            assert(squares[i] == values[i] * values[i]);
+        }
+        std::vector<long long> as = { 1, -1, 5 };
+        std::vector<long long> bs = { 4294967290, 5, 7 };
+        std::vector<size_t> mods = { 4294967291, 1000003, 97 };
+        const auto x = number_theory::linear_congruence_solver(as, bs, mods);
+        assert(x % 4294967291 == 4294967290 && x % 1000003 == 1000003 - 5 && 5 * x % 97 == 7);
+        return true;
+    }
+    bool test_garner_crt_functions() {
+        // Test 12: Garner's algorithm with non-coprime moduli, big reconstruction and batches
+        std::vector<number_theory::congruence> congruences = { { 2, 4 }, { 4, 6 }, { 1, 9 } };
+        const auto solution = number_theory::chinese_remainder(congruences);
+        assert(solution && solution->residue == 10 && solution->modulus == 36);
+        congruences.push_back({ 3, 8 });
+        assert(!number_theory::chinese_remainder(congruences));
+        std::vector<long long> as = { 2, 3 };
+        std::vector<long long> bs = { 2, 6 };
+        std::vector<size_t> mods = { 10, 9 };
+        assert(number_theory::linear_congruence_solver(as, bs, mods) == 11);
+        std::vector<std::uint64_t> moduli = { 4294967291, 4294967279, 4294967231, 4294967197, 4294967189 };
+        const number_theory::garner plan{ moduli };
+        algorithms::big_integer x{ 1 };
+        for (int k = 0; k < 3; k++) {
+            x = x * algorithms::big_integer{ 1234567891011 } + algorithms::big_integer{ k };
+        }
+        std::vector<std::vector<std::uint64_t>> batch(100);
+        for (std::size_t k = 0; k < batch.size(); k++) {
+            const auto shifted = x + algorithms::big_integer{ k };
+            for (const auto m : moduli) {
+                const auto r = (shifted % algorithms::big_integer{ m }).magnitude;
+                batch[k].push_back(r.empty() ? 0 : std::uint64_t{ r[0] } | (r.size() > 1 ? std::uint64_t{ r[1] } << 32 : 0));
+            }
+        }
+        const auto values = plan.values(batch);
+        for (std::size_t k = 0; k < batch.size(); k++) {
+            assert(values[k] && *values[k] == x + algorithms::big_integer{ k });
+        }
+        assert(plan.period() > x);
+        return true;
+    }
     int test() {
         // Invoke all test functions and check if they return true
         assert(test_coprime_function());
@@ -208,10 +327,16 @@ namespace tests {
         assert(test_modular_inverse_function());
         assert(test_linear_congruence_solver_function());
         assert(test_sieve_of_eratosthenes_function());
+        assert(test_prime_streaming_and_counting_functions());
         assert(test_prime_factor_decomposition_function());
         assert(test_euler_totient_function());
+        assert(test_factor_table_functions());
+        assert(test_primality_and_large_factorization_functions());
         assert(test_largest_power_of_prime_dividing_factorial_function());
         assert(test_linear_congruence_solver_multiple_function());
+        assert(test_modint_functions());
+        assert(test_garner_crt_functions());
+        assert(algorithms::test_batch());
         // Print success message if all tests pass
         std::cout << "All tests passed successfully!" << std::endl;
         return 0;
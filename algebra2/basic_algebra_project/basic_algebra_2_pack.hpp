@@ -1,4 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <future>
+
 #include "gaussian_elimination.hpp"
 
 namespace algebra {
@@ -77,10 +81,23 @@ template <typename T> struct solve_result {
   homogeneous_solution_t<T> homogeneous{};
 };
 
+/*
+  description:
+    Solves a square system Ax = y with a kernel chosen by the structure tag of
+  A (triangular, tridiagonal, banded, symmetric). An untagged matrix is scanned
+  for structure first. Returns std::nullopt when no specialised kernel applies
+  or it meets a zero pivot, then dense elimination has to be used.
+*/
+template <typename T, typename LP>
+inline auto structured_solve(ranges::matrix_view<T, LP> coefficients,
+                             std::ranges::range auto y)
+    -> std::optional<solve_result<to_fraction_type<T>>>;
+
 /*
   description:
     A function that is designed to solve systems of linear equations in the form
-  of Ax = y.
+  of Ax = y. Structured coefficient matrices are dispatched to
+  structured_solve.
 */
 template <typename T, typename LP>
 inline auto solve(ranges::matrix_view<T, LP> coefficients,
@@ -172,11 +189,77 @@ inline auto coordinates_in_base(std::ranges::range auto v,
 
 /*
   description:
-    Function performs matrix multiplication
+    Algorithms which can be used by matrix_multiply. automatic picks one of
+  the remaining ones depending on the shape of the multiplied matrices.
+*/
+enum class multiply_algorithm : std::uint8_t {
+  automatic,
+  naive,
+  blocked,
+  strassen
+};
+
+/*
+  description:
+    Thresholds used by matrix_multiply.
+  members:
+    std::size_t blocked_threshold - the smallest dimension for which the packed
+  blocked kernel is chosen instead of the naive triple loop
+    std::size_t strassen_crossover - the smallest dimension for which the
+  Strassen-Winograd recursion is chosen, the recursion switches back to the
+  blocked kernel once the blocks are not larger than this value
+    std::size_t block_size - edge of a tile used by the blocked kernel
+    std::size_t parallel_depth - number of levels of the Strassen-Winograd
+  recursion whose 7 sub-products are run as parallel tasks
+*/
+struct multiply_settings {
+  std::size_t blocked_threshold{32};
+  std::size_t strassen_crossover{256};
+  std::size_t block_size{64};
+  std::size_t parallel_depth{1};
+};
+
+/*
+  description:
+    Copies a matrix into a contiguous row-major vector of shape rows x columns.
+  Entries outside of the matrix are filled with zeros.
+*/
+template <typename T, typename LP>
+auto pack(ranges::matrix_view<T, LP> m, std::size_t rows, std::size_t columns)
+    -> std::vector<T>;
+
+/*
+  description:
+    Adds to the row-major matrix c (n x p) the product of row-major matrices a
+  (n x k) and b (k x p). The loops are tiled so that the tiles of all three
+  matrices stay in cache and the innermost loop walks over contiguous rows.
+*/
+template <typename T>
+auto multiply_blocked(const std::vector<T> &a, const std::vector<T> &b,
+                      std::vector<T> &c, std::size_t n, std::size_t k,
+                      std::size_t p, std::size_t block_size) -> void;
+
+/*
+  description:
+    Multiplies two square row-major matrices of size n x n using the
+  Strassen-Winograd recursion (7 multiplications and 15 additions per level).
+*/
+template <typename T>
+auto strassen_winograd(const std::vector<T> &a, const std::vector<T> &b,
+                       std::size_t n, const multiply_settings &settings,
+                       std::size_t depth = 0) -> std::vector<T>;
+
+/*
+  description:
+    Function performs matrix multiplication. For small matrices it uses the
+  naive triple loop, for medium ones the packed blocked kernel and for large,
+  almost square ones the Strassen-Winograd recursion.
 */
 template <typename T, typename LP, typename LP2>
 auto matrix_multiply(ranges::matrix_view<T, LP> matrix_1,
-                     ranges::matrix_view<T, LP2> matrix_2) -> matrix<T, LP>;
+                     ranges::matrix_view<T, LP2> matrix_2,
+                     multiply_algorithm algorithm = multiply_algorithm::automatic,
+                     multiply_settings settings = {}) -> matrix<T, LP>;
 
 /*
   description:
@@ -303,10 +386,54 @@ inline auto algebra::special_solution(ranges::matrix_view<T, LP> coefficients,
   return solution;
 }
 
+template <typename T, typename LP>
+inline auto algebra::structured_solve(ranges::matrix_view<T, LP> coefficients,
+                                      std::ranges::range auto y)
+    -> std::optional<algebra::solve_result<algebra::to_fraction_type<T>>> {
+  using namespace algorithms::gaussian_elimination;
+  using fraction_type = to_fraction_type<T>;
+  using integer_type = decltype(fraction_type{}.numerator);
+  const std::size_t n{coefficients.number_of_rows()};
+  if (n == 0 || n != coefficients.number_of_columns() ||
+      static_cast<std::size_t>(std::ranges::distance(y)) != n) {
+    return std::nullopt;
+  }
+  if (coefficients.structure() == ranges::matrix_structure::general) {
+    coefficients = algorithms::structured::detect_structure(coefficients);
+    if (coefficients.structure() == ranges::matrix_structure::general) {
+      return std::nullopt;
+    }
+  }
+  auto [fracs, matrix_of_fracs] = convert_to_matrix_of_fractions(coefficients);
+  std::vector<fraction_type> free_words{};
+  free_words.reserve(n);
+  for (auto value : y) {
+    if constexpr (is_fraction_v<decltype(value)>) {
+      free_words.push_back(value);
+    } else {
+      free_words.push_back(fraction_type{static_cast<integer_type>(value), 1});
+    }
+  }
+  auto x = algorithms::structured::solve(matrix_of_fracs, free_words);
+  if (!x) {
+    return std::nullopt;
+  }
+  algebra::solve_result<fraction_type> result;
+  result.exists = true;
+  result.special = std::move(*x);
+  std::vector<fraction_type> zero{fraction_type{0}};
+  ranges::matrix_view zero_m(zero, 1, 1, layout::column);
+  result.homogeneous = std::pair{std::move(zero), zero_m};
+  return result;
+}
+
 template <typename T, typename LP>
 inline auto algebra::solve(ranges::matrix_view<T, LP> coefficients,
                            std::ranges::range auto y)
     -> algebra::solve_result<algebra::to_fraction_type<T>> {
+  if (auto structured = structured_solve(coefficients, y)) {
+    return std::move(*structured);
+  }
   algebra::solve_result<algebra::to_fraction_type<T>> result;
   result.special = special_solution(coefficients, y);
   if (!result.special) {
@@ -418,26 +545,203 @@ inline auto algebra::coordinates_in_base(std::ranges::range auto v,
   return result;
 }
 
+template <typename T, typename LP>
+auto algebra::pack(ranges::matrix_view<T, LP> m, std::size_t rows,
+                   std::size_t columns) -> std::vector<T> {
+  std::vector<T> packed(rows * columns, T{0});
+  for (std::size_t i = 0; i < m.number_of_rows(); ++i) {
+    for (std::size_t j = 0; j < m.number_of_columns(); ++j) {
+      packed[i * columns + j] = m[i, j];
+    }
+  }
+  return packed;
+}
+
+template <typename T>
+auto algebra::multiply_blocked(const std::vector<T> &a,
+                               const std::vector<T> &b, std::vector<T> &c,
+                               std::size_t n, std::size_t k, std::size_t p,
+                               std::size_t block_size) -> void {
+  block_size = std::max<std::size_t>(block_size, 1);
+  for (std::size_t ii = 0; ii < n; ii += block_size) {
+    const std::size_t i_end = std::min(ii + block_size, n);
+    for (std::size_t kk = 0; kk < k; kk += block_size) {
+      const std::size_t k_end = std::min(kk + block_size, k);
+      for (std::size_t jj = 0; jj < p; jj += block_size) {
+        const std::size_t j_end = std::min(jj + block_size, p);
+        for (std::size_t i = ii; i < i_end; ++i) {
+          for (std::size_t l = kk; l < k_end; ++l) {
+            const T a_il = a[i * k + l];
+            for (std::size_t j = jj; j < j_end; ++j) {
+              c[i * p + j] += a_il * b[l * p + j];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+auto algebra::strassen_winograd(const std::vector<T> &a,
+                                const std::vector<T> &b, std::size_t n,
+                                const multiply_settings &settings,
+                                std::size_t depth) -> std::vector<T> {
+  if (n <= settings.strassen_crossover || n % 2 != 0) {
+    std::vector<T> c(n * n, T{0});
+    multiply_blocked(a, b, c, n, n, n, settings.block_size);
+    return c;
+  }
+  const std::size_t h = n / 2;
+  auto quadrant = [h, n](const std::vector<T> &m, std::size_t row,
+                         std::size_t column) {
+    std::vector<T> q(h * h);
+    for (std::size_t i = 0; i < h; ++i) {
+      std::copy_n(m.begin() + (row * h + i) * n + column * h, h,
+                  q.begin() + i * h);
+    }
+    return q;
+  };
+  auto add = [](const std::vector<T> &x, const std::vector<T> &y) {
+    std::vector<T> z(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      z[i] = x[i] + y[i];
+    }
+    return z;
+  };
+  auto subtract = [](const std::vector<T> &x, const std::vector<T> &y) {
+    std::vector<T> z(x.size());
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      z[i] = x[i] - y[i];
+    }
+    return z;
+  };
+  const auto a11 = quadrant(a, 0, 0), a12 = quadrant(a, 0, 1);
+  const auto a21 = quadrant(a, 1, 0), a22 = quadrant(a, 1, 1);
+  const auto b11 = quadrant(b, 0, 0), b12 = quadrant(b, 0, 1);
+  const auto b21 = quadrant(b, 1, 0), b22 = quadrant(b, 1, 1);
+
+  const auto s1 = add(a21, a22);
+  const auto s2 = subtract(s1, a11);
+  const auto s3 = subtract(a11, a21);
+  const auto s4 = subtract(a12, s2);
+  const auto t1 = subtract(b12, b11);
+  const auto t2 = subtract(b22, t1);
+  const auto t3 = subtract(b22, b12);
+  const auto t4 = subtract(t2, b21);
+
+  const std::array<std::pair<const std::vector<T> *, const std::vector<T> *>,
+                   7>
+      factors{{{&a11, &b11},
+               {&a12, &b21},
+               {&s4, &b22},
+               {&a22, &t4},
+               {&s1, &t1},
+               {&s2, &t2},
+               {&s3, &t3}}};
+  std::array<std::vector<T>, 7> products{};
+  if (depth < settings.parallel_depth) {
+    std::array<std::future<std::vector<T>>, 6> tasks{};
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+      tasks[i] = std::async(std::launch::async, [&, i] {
+        return strassen_winograd(*factors[i + 1].first,
+                                 *factors[i + 1].second, h, settings,
+                                 depth + 1);
+      });
+    }
+    products[0] = strassen_winograd(*factors[0].first, *factors[0].second, h,
+                                    settings, depth + 1);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+      products[i + 1] = tasks[i].get();
+    }
+  } else {
+    for (std::size_t i = 0; i < products.size(); ++i) {
+      products[i] = strassen_winograd(*factors[i].first, *factors[i].second,
+                                      h, settings, depth + 1);
+    }
+  }
+  const auto &[m1, m2, m3, m4, m5, m6, m7] = products;
+
+  const auto u2 = add(m1, m6);
+  const auto u3 = add(u2, m7);
+  const auto c11 = add(m1, m2);
+  const auto c12 = add(add(u2, m5), m3);
+  const auto c21 = subtract(u3, m4);
+  const auto c22 = add(u3, m5);
+
+  std::vector<T> c(n * n);
+  for (std::size_t i = 0; i < h; ++i) {
+    std::copy_n(c11.begin() + i * h, h, c.begin() + i * n);
+    std::copy_n(c12.begin() + i * h, h, c.begin() + i * n + h);
+    std::copy_n(c21.begin() + i * h, h, c.begin() + (i + h) * n);
+    std::copy_n(c22.begin() + i * h, h, c.begin() + (i + h) * n + h);
+  }
+  return c;
+}
+
 template <typename T, typename LP, typename LP2>
 auto algebra::matrix_multiply(ranges::matrix_view<T, LP> matrix_1,
-                              ranges::matrix_view<T, LP2> matrix_2)
-    -> matrix<T, LP> {
+                              ranges::matrix_view<T, LP2> matrix_2,
+                              multiply_algorithm algorithm,
+                              multiply_settings settings) -> matrix<T, LP> {
   if (matrix_1.number_of_columns() != matrix_2.number_of_rows()) {
     throw std::invalid_argument(
         "\nMatrices are not compalible for multiplication");
   }
-  auto result_rows = matrix_1.number_of_rows();
-  auto result_columns = matrix_2.number_of_columns();
-  std::vector<T> result_vector(result_rows * result_columns);
-  ranges::matrix_view result(result_vector, result_rows, result_columns,
-                             layout::row);
+  const auto result_rows = matrix_1.number_of_rows();
+  const auto inner = matrix_1.number_of_columns();
+  const auto result_columns = matrix_2.number_of_columns();
+  if (algorithm == multiply_algorithm::automatic) {
+    const auto smallest = std::min({result_rows, inner, result_columns});
+    const auto largest = std::max({result_rows, inner, result_columns});
+    if (smallest >= settings.strassen_crossover && largest <= 2 * smallest) {
+      algorithm = multiply_algorithm::strassen;
+    } else if (largest >= settings.blocked_threshold) {
+      algorithm = multiply_algorithm::blocked;
+    } else {
+      algorithm = multiply_algorithm::naive;
+    }
+  }
+
+  std::vector<T> result_vector(result_rows * result_columns, T{0});
+  ranges::matrix_view<T, LP> result(result_vector, result_rows,
+                                    result_columns, LP{});
+  if (algorithm == multiply_algorithm::naive) {
+    for (std::size_t i = 0; i < result_rows; ++i) {
+      for (std::size_t j = 0; j < result_columns; ++j) {
+        T sum{0};
+        for (std::size_t k = 0; k < inner; ++k) {
+          sum += matrix_1[i, k] * matrix_2[k, j];
+        }
+        result[i, j] = sum;
+      }
+    }
+    return std::pair{std::move(result_vector), result};
+  }
+
+  std::vector<T> product{};
+  std::size_t stride{result_columns};
+  if (algorithm == multiply_algorithm::blocked) {
+    product.assign(result_rows * result_columns, T{0});
+    multiply_blocked(pack(matrix_1, result_rows, inner),
+                     pack(matrix_2, inner, result_columns), product,
+                     result_rows, inner, result_columns, settings.block_size);
+  } else {
+    // pad to s * 2^levels with s <= crossover, so every level splits evenly
+    std::size_t size = std::max({result_rows, inner, result_columns});
+    std::size_t levels{0};
+    while (size > std::max<std::size_t>(settings.strassen_crossover, 1)) {
+      size = (size + 1) / 2;
+      ++levels;
+    }
+    stride = size << levels;
+    product = strassen_winograd(pack(matrix_1, stride, stride),
+                                pack(matrix_2, stride, stride), stride,
+                                settings);
+  }
   for (std::size_t i = 0; i < result_rows; ++i) {
     for (std::size_t j = 0; j < result_columns; ++j) {
-      T sum{0};
-      for (std::size_t k = 0; k < matrix_1.number_of_columns(); ++k) {
-        sum += matrix_1[i, k] * matrix_2[k, j];
-      }
-      result[i, j] = sum;
+      result[i, j] = product[i * stride + j];
     }
   }
   return std::pair{std::move(result_vector), result};
@@ -569,6 +873,135 @@ bool test_of_is_in_kernel() {
   return true;
 }
 
+bool test_of_matrix_multiply() {
+  const std::size_t n = 70;
+  std::vector<int> v1(n * n), v2(n * n);
+  for (std::size_t i = 0; i < n * n; i++) {
+    v1[i] = static_cast<int>(i % 7) - 3;
+    v2[i] = static_cast<int>(i % 5) - 2;
+  }
+  ::ranges::matrix_view m1(v1, n, n, layout::row);
+  ::ranges::matrix_view m2(v2, n, n, layout::row);
+  const algebra::multiply_settings settings{.blocked_threshold = 8,
+                                            .strassen_crossover = 16,
+                                            .block_size = 8,
+                                            .parallel_depth = 1};
+  auto [naive_vector, naive] =
+      algebra::matrix_multiply(m1, m2, algebra::multiply_algorithm::naive);
+  auto [blocked_vector, blocked] = algebra::matrix_multiply(
+      m1, m2, algebra::multiply_algorithm::blocked, settings);
+  auto [strassen_vector, strassen] = algebra::matrix_multiply(
+      m1, m2, algebra::multiply_algorithm::strassen, settings);
+  assert(naive_vector == blocked_vector);
+  assert(naive_vector == strassen_vector);
+
+  return true;
+}
+
+bool test_of_structured_solve() {
+  using fraction = algorithms::gaussian_elimination::fraction<int>;
+  std::vector v1{2, 0, 0, 1, 3, 0, 4, -1, 5};
+  std::vector v2{2, 7, 17};
+  ::ranges::matrix_view lower(v1, 3, 3, layout::row);
+  auto result = algebra::solve(
+      lower.with_structure(::ranges::matrix_structure::lower_triangular), v2);
+  assert(result.exists == true);
+  assert((result.special.value() ==
+          std::vector{fraction{1, 1}, fraction{2, 1}, fraction{3, 1}}));
+
+  std::vector v3{2, -1, 0, 0, -1, 2, -1, 0, 0, -1, 2, -1, 0, 0, -1, 2};
+  std::vector v4{0, 0, 0, 5};
+  ::ranges::matrix_view tridiagonal(v3, 4, 4, layout::row);
+  assert(algorithms::structured::detect_structure(tridiagonal).structure() ==
+         ::ranges::matrix_structure::tridiagonal);
+  result = algebra::solve(tridiagonal, v4);
+  assert((result.special.value() == std::vector{fraction{1, 1}, fraction{2, 1},
+                                                fraction{3, 1}, fraction{4, 1}}));
+
+  std::vector v5{4, 1, 0, 0, 0, 1, 4, 1, 0, 0, 1, 1, 4, 1, 0,
+                 0, 2, 1, 4, 1, 0, 0, 1, 1, 4};
+  std::vector v6{5, 6, 7, 8, 6};
+  ::ranges::matrix_view banded(v5, 5, 5, layout::row);
+  result = algebra::solve(
+      banded.with_structure(::ranges::matrix_structure::banded, 2, 1), v6);
+  assert((result.special.value() == std::vector(5, fraction{1, 1})));
+
+  std::vector v7{4, 2, 2, 2, 5, 3, 2, 3, 6};
+  std::vector v8{8, 10, 11};
+  ::ranges::matrix_view symmetric(v7, 3, 3, layout::row);
+  assert(algorithms::structured::detect_structure(symmetric).structure() ==
+         ::ranges::matrix_structure::symmetric);
+  result = algebra::solve(symmetric, v8);
+  assert((result.special.value() == std::vector(3, fraction{1, 1})));
+
+  // a symmetric band narrow enough for the banded LU is tagged banded
+  std::vector<int> v9(100, 0);
+  std::vector<int> v10(10, 0);
+  for (std::size_t i = 0; i < 10; i++) {
+    const std::size_t first = i > 2 ? i - 2 : 0;
+    for (std::size_t j = first; j < std::min<std::size_t>(i + 3, 10); j++) {
+      v9[(i * 10) + j] = i == j ? 6 : -1;
+      v10[i] += v9[(i * 10) + j];
+    }
+  }
+  ::ranges::matrix_view pentadiagonal(v9, 10, 10, layout::row);
+  const auto tagged = algorithms::structured::detect_structure(pentadiagonal);
+  assert(tagged.structure() == ::ranges::matrix_structure::banded);
+  assert((tagged.bandwidths() == std::pair<std::size_t, std::size_t>{2, 2}));
+  result = algebra::solve(pentadiagonal, v10);
+  assert((result.special.value() == std::vector(10, fraction{1, 1})));
+
+  return true;
+}
+
+bool test_of_structured_determinant() {
+  using fraction = algorithms::gaussian_elimination::fraction<int>;
+  std::vector v1{2, 0, 0, 1, 3, 0, 4, -1, 5};
+  ::ranges::matrix_view lower(v1, 3, 3, layout::row);
+  assert(algorithms::gaussian_elimination::determinant(lower).value() ==
+         (fraction{30, 1}));
+
+  std::vector v2{4, 2, 2, 2, 5, 3, 2, 3, 6};
+  ::ranges::matrix_view symmetric(v2, 3, 3, layout::row);
+  assert(algorithms::gaussian_elimination::determinant(symmetric).value() ==
+         (fraction{64, 1}));
+
+  std::vector<double> v3{4, 2, 2, 2, 5, 3, 2, 3, 6};
+  std::vector<double> v4{8, 10, 11};
+  ::ranges::matrix_view spd(v3, 3, 3, layout::row);
+  auto x = algorithms::structured::solve(
+      spd.with_structure(::ranges::matrix_structure::symmetric), v4);
+  assert(x.has_value());
+  assert(std::ranges::all_of(*x, [](double value) {
+    return std::abs(value - 1.0) < 1e-12;
+  }));
+
+  return true;
+}
+
+bool test_of_lu_decomposition() {
+  namespace ge = algorithms::gaussian_elimination;
+  std::vector<double> v1{0, 2, 1, 4, -6, 0, -2, 7, 3};
+  std::vector<double> v2{7, -8, 21};
+  ::ranges::matrix_view m(v1, 3, 3, layout::row);
+  for (auto strategy : {ge::pivoting::partial, ge::pivoting::scaled_partial,
+                        ge::pivoting::rook, ge::pivoting::complete}) {
+    auto lu = ge::lu_decomposition(m, strategy).value();
+    auto x = ge::lu_solve(lu, v2).value();
+    for (std::size_t i = 0; i < 3; i++) {
+      assert(std::abs(x[i] - static_cast<double>(i + 1)) < 1e-12);
+    }
+    assert(std::abs(ge::lu_determinant(lu) + 8) < 1e-12);
+  }
+
+  std::vector<double> v3{1, 2, 3, 2, 4, 6, 1, 1, 1};
+  ::ranges::matrix_view singular(v3, 3, 3, layout::row);
+  assert(ge::lu_determinant(singular, ge::pivoting::complete).value() == 0);
+  assert(!ge::lu_inverse(singular).has_value());
+
+  return true;
+}
+
 bool test_of_is_in_image() {
   std::vector v1{1, 2, 6, 9, 1, 5, 9, 5, 11};
   std::vector v2{5, 8, 4};
@@ -588,6 +1021,10 @@ void all_test() {
   assert(test_of_base_transition_matrix());
   assert(test_of_is_in_kernel());
   assert(test_of_is_in_image());
+  assert(test_of_matrix_multiply());
+  assert(test_of_structured_solve());
+  assert(test_of_structured_determinant());
+  assert(test_of_lu_decomposition());
   std::println("\n\nAll Test Passed Succesfully!");
 }
 } // namespace tests_of_algebra
@@ -1,16 +1,22 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <concepts>
 #include <cstdint>
 #include <expected>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <typeinfo>
 #include <utility>
 #include <vector>
 
+#include "../../discrete_math/rational/rational.hpp"
+#include "../gaussian_elimination/lu.hpp"
 #include "matrix.hpp"
+#include "structured_matrix.hpp"
 
 
 namespace algorithms::gaussian_elimination {
@@ -23,165 +29,15 @@ namespace algorithms::gaussian_elimination {
     };
 
 
-    template <std::integral I>
-    struct fraction {
-        I numerator{};
-        I denominator{1};
-
-
-        constexpr auto operator-=(I i) -> fraction<I>& {
-            numerator -= i * denominator;
-            return *this;
-        }
-
-
-        /*
-        description:
-            reduce fraction
-    */
-        void reduce() {
-            I divider = std::gcd(numerator, denominator);
-            if (divider != 0) {
-                numerator /= divider;
-                denominator /= divider;
-            }
-            if ((numerator < 0 && denominator < 0) ||
-                (numerator > 0 && denominator < 0)) {
-                numerator = -numerator;
-                denominator = -denominator;
-            }
-        }
-    };
-
-
-    template <std::integral I>
-    inline auto operator==(fraction<I> f, fraction<I> g) -> bool {
-        return f.numerator == g.numerator && f.denominator == g.denominator;
-    }
-
     /*
         description:
-            operations + - * / += -= *= /= on fractions
+            fraction kept in lowest terms, the rational type shared with the
+       modules of the repository
     */
     template <std::integral I>
-    constexpr auto operator+(fraction<I> f, fraction<I> g) -> fraction<I> {
-        fraction<I> result{};
-        result.numerator =
-            f.numerator * g.denominator + g.numerator * f.denominator;
-        result.denominator = f.denominator * g.denominator;
-        result.reduce();
-        return result;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator+=(fraction<I>& f, fraction<I> g) -> fraction<I> {
-        f.numerator = f.numerator * g.denominator + g.numerator * f.denominator;
-        f.denominator = f.denominator * g.denominator;
-        f.reduce();
-        return f;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator-(fraction<I> f, fraction<I> g) -> fraction<I> {
-        fraction<I> result;
-        result.numerator =
-            f.numerator * g.denominator - g.numerator * f.denominator;
-        result.denominator = f.denominator * g.denominator;
-        result.reduce();
-        return result;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator-=(fraction<I>& f, fraction<I> g) -> fraction<I> {
-        f.numerator = f.numerator * g.denominator - g.numerator * f.denominator;
-        f.denominator = f.denominator * g.denominator;
-        f.reduce();
-        return f;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator*(fraction<I> f, fraction<I> g) -> fraction<I> {
-        fraction<I> result;
-        result.numerator = f.numerator * g.numerator;
-        result.denominator = f.denominator * g.denominator;
-        result.reduce();
-        return result;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator*=(fraction<I>& f, fraction<I> g) -> fraction<I> {
-        f.numerator = f.numerator * g.numerator;
-        f.denominator = f.denominator * g.denominator;
-        f.reduce();
-        return f;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator/(fraction<I> f, fraction<I> g) -> fraction<I> {
-        fraction<I> result;
-        result.numerator = f.numerator * g.denominator;
-        result.denominator = f.denominator * g.numerator;
-        result.reduce();
-        return result;
-    }
+    using fraction = ::rational<I>;
 
 
-    template <std::integral I>
-    constexpr auto operator/=(fraction<I>& f, fraction<I> g) -> fraction<I> {
-        f.numerator = f.numerator * g.denominator;
-        f.denominator = f.denominator * g.numerator;
-        f.reduce();
-        return f;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator*(fraction<I> f, int g) -> fraction<I> {
-        f.numerator = f.numerator * g;
-        f.reduce();
-        return f;
-    }
-
-
-    template <std::integral I>
-    constexpr auto operator*=(fraction<I>& f, int g) -> fraction<I> {
-        f.numerator = f.numerator * g;
-        f.reduce();
-        return f;
-    }
-
-}  // namespace algorithms::gaussian_elimination
-
-
-/*
-    description:
-        enables formatting of output data
-        for algorirthms::gaussian_elimination::fraction<I>
-*/
-template <std::integral I>
-struct std::formatter<algorithms::gaussian_elimination::fraction<I>> {
-
-    template <typename FormatParseContext>
-    constexpr auto parse(FormatParseContext& ctx) {
-        return ctx.begin();
-    }
-
-
-    template <typename FormatContext>
-    auto format(const algorithms::gaussian_elimination::fraction<I>& f,
-                FormatContext& ctx) const {
-        return std::format_to(ctx.out(), "{}/{}", f.numerator, f.denominator);
-    }
-};
-
-namespace algorithms::gaussian_elimination {
-
     /*
         description:
             subtracts row_j multiplied by alpha from row_i
@@ -192,9 +48,7 @@ namespace algorithms::gaussian_elimination {
                   std::size_t row_j,
                   R alpha) {
         for (std::size_t i = 0; i < m.number_of_columns(); i++) {
-            m[row_j, i] *= alpha;
-            m[row_i, i] -= m[row_j, i];
-            m[row_j, i] /= alpha;
+            m[row_i, i] -= m[row_j, i] * alpha;
         }
     }
 
@@ -243,7 +97,7 @@ namespace algorithms::gaussian_elimination {
             return v;
         } else {
             return v | std::views::transform([](auto i) {
-                       return fraction{i, 1};
+                       return fraction<decltype(i)>{i, 1};
                    }) |
                    std::ranges::to<std::vector>();
         }
@@ -260,12 +114,13 @@ namespace algorithms::gaussian_elimination {
             std::vector<I> copy(m.begin(), m.end());
             ::ranges::matrix_view<I, LP> mat{
                 copy, m.extent(0), m.extent(1), LP{}};
-            return std::pair{std::move(copy), mat};
+            return std::pair{std::move(copy), mat.with_structure_of(m)};
         } else {
             auto fracs{convert_to_vector_of_fractions(m)};
             ranges::matrix_view<fraction<I>, LP> matrix_of_fracs{
                 fracs, m.extent(0), m.extent(1), LP{}};
-            return std::pair{std::move(fracs), matrix_of_fracs};
+            return std::pair{std::move(fracs),
+                             matrix_of_fracs.with_structure_of(m)};
         }
     }
 
@@ -361,10 +216,7 @@ namespace algorithms::gaussian_elimination {
     enum class reducted_form : std::uint8_t { echelon, diagonal };
 
 
-    enum class error : std::uint8_t {
-        not_invertible,
-        not_square,
-    };
+    using ::pivoted_lu::error;
 
 
     /*
@@ -392,7 +244,8 @@ namespace algorithms::gaussian_elimination {
 
     /*
         description:
-            helper function for gaussian_echelon function to swap rows
+            helper function for gaussian_echelon function, swaps row i with
+       the first row below it having a non-zero entry in column i
     */
     template <typename T, typename LP>
     auto gaussian_echelon_swap(ranges::matrix_view<T, LP> m,
@@ -405,6 +258,7 @@ namespace algorithms::gaussian_elimination {
                 result.reduction_steps.push_back(
                     std::format("swap R{} with R{}", j + 1, i + 1));
                 result.determinant_m *= -1;
+                return;
             }
         }
     }
@@ -587,7 +441,8 @@ namespace algorithms::gaussian_elimination {
 
     /*
         description:
-            calculates the determinant of matrix m
+            calculates the determinant of matrix m. Untagged matrices are
+       scanned for structure first and structured ones skip the elimination
     */
     template <typename T, typename LP>
     auto determinant(ranges::matrix_view<T, LP> m)
@@ -596,6 +451,15 @@ namespace algorithms::gaussian_elimination {
         const std::size_t cols = m.number_of_columns();
 
         if (rows != cols) { return std::unexpected(error::not_square); }
+        if (m.structure() == ranges::matrix_structure::general) {
+            m = structured::detect_structure(m);
+        }
+        if (m.structure() != ranges::matrix_structure::general) {
+            auto [fracs, matrix_of_fracs] = convert_to_matrix_of_fractions(m);
+            if (auto det = structured::determinant(matrix_of_fracs)) {
+                return *det;
+            }
+        }
         return gaussian_elimiantion_alg(m, reducted_form::diagonal)
             .determinant_m;
     }
@@ -603,7 +467,8 @@ namespace algorithms::gaussian_elimination {
 
     /*
         description:
-            returns inverse of matrix m
+            returns inverse of matrix m. Structured matrices are inverted
+       column by column with a specialised kernel
     */
     template <typename T, typename LP>
     auto inverse(ranges::matrix_view<T, LP>& m) -> std::expected<
@@ -613,6 +478,18 @@ namespace algorithms::gaussian_elimination {
         std::size_t const rows = m.number_of_rows();
         std::size_t const cols = m.number_of_columns();
         if (rows != cols) { return std::unexpected(error::not_square); }
+        auto tagged = (m.structure() == ranges::matrix_structure::general)
+                          ? structured::detect_structure(m)
+                          : m;
+        if (tagged.structure() != ranges::matrix_structure::general) {
+            auto [fracs, matrix_of_fracs] =
+                convert_to_matrix_of_fractions(tagged);
+            if (auto values = structured::inverse(matrix_of_fracs)) {
+                const ranges::matrix_view<fraction<int>, std::layout_right>
+                    inverse_matrix{*values, rows, cols, layout::row};
+                return std::pair{std::move(*values), inverse_matrix};
+            }
+        }
         auto [identity_vector, identity_matrix] = eye<T, LP>(rows, cols);
         auto [combined_vec, combined_matrix] =
             combine_matrices(m, identity_matrix);
@@ -626,4 +503,50 @@ namespace algorithms::gaussian_elimination {
         return std::unexpected(error::not_invertible);
     }
 
+
+    /*
+        description:
+            LU decomposition of floating point matrices with partial, scaled
+       partial, rook or complete pivoting, shared with the gaussian_elimination
+       module through lu.hpp
+    */
+    using ::pivoted_lu::lu_decomposition;
+    using ::pivoted_lu::lu_determinant;
+    using ::pivoted_lu::lu_result;
+    using ::pivoted_lu::lu_solve;
+    using ::pivoted_lu::pivoting;
+
+
+    /*
+        description:
+            inverse of m given its decomposition, solves for every column of
+       the identity
+    */
+    template <std::floating_point T>
+    auto lu_inverse(const lu_result<T>& f) -> std::expected<
+        std::pair<std::vector<T>, ranges::matrix_view<T, std::layout_right>>,
+        error> {
+        auto entries{::pivoted_lu::lu_inverse_entries(f)};
+        if (!entries) { return std::unexpected(entries.error()); }
+        const std::size_t n{f.row_permutation.size()};
+        std::vector<T> inverse_vector{std::move(*entries)};
+        const ranges::matrix_view<T, std::layout_right> inverse_matrix{
+            inverse_vector, n, n, layout::row};
+        return std::pair{std::move(inverse_vector), inverse_matrix};
+    }
+
+
+    /*
+        description:
+            inverse of a square floating point matrix m
+    */
+    template <std::floating_point T, typename LP>
+    auto lu_inverse(ranges::matrix_view<T, LP> m,
+                    pivoting strategy = pivoting::partial) -> std::expected<
+        std::pair<std::vector<T>, ranges::matrix_view<T, std::layout_right>>,
+        error> {
+        const auto f{lu_decomposition(m, strategy)};
+        if (!f) { return std::unexpected(f.error()); }
+        return lu_inverse(*f);
+    }
 }  // namespace algorithms::gaussian_elimination
\ No newline at end of file
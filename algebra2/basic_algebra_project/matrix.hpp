@@ -1,7 +1,10 @@
+#pragma once
+
 #include <algorithm>
 #include <cerrno>
 #include <charconv>
 #include <concepts>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <filesystem>
@@ -130,6 +133,20 @@ namespace ranges {
     constexpr std::size_t column_extent{1};
 
 
+    /*structure of a matrix known in advance. It is carried by matrix_view so
+     * that solvers can pick a specialised kernel instead of dense
+     * elimination. For banded matrices the bandwidths are stored as well*/
+    enum class matrix_structure : std::uint8_t {
+        general,
+        diagonal,
+        lower_triangular,
+        upper_triangular,
+        tridiagonal,
+        banded,
+        symmetric,
+    };
+
+
     /*this is a matrix view which reinterprets a contiguous range as matrix*/
     template <typename T, typename LP>
     requires(std::same_as<LP, std::layout_right> ||
@@ -189,6 +206,56 @@ namespace ranges {
             return {number_of_rows(), number_of_columns()};
         }
 
+
+        /*returns the structure tag of this matrix, by default
+         * matrix_structure::general*/
+        [[nodiscard]] constexpr auto structure() const -> matrix_structure {
+            return _structure;
+        }
+
+
+        /*returns a pair (lower bandwidth, upper bandwidth), that is the
+         * number of nonzero diagonals below and above the main diagonal*/
+        [[nodiscard]] constexpr auto bandwidths() const
+            -> std::pair<std::size_t, std::size_t> {
+            const std::size_t size{
+                std::max(number_of_rows(), number_of_columns())};
+            const std::size_t last{size > 0 ? size - 1 : 0};
+            switch (_structure) {
+                case matrix_structure::diagonal: return {0, 0};
+                case matrix_structure::lower_triangular: return {last, 0};
+                case matrix_structure::upper_triangular: return {0, last};
+                case matrix_structure::tridiagonal: return {1, 1};
+                case matrix_structure::banded:
+                    return {_lower_bandwidth, _upper_bandwidth};
+                default: return {last, last};
+            }
+        }
+
+
+        /*returns a copy of this view tagged with the structure s. The tag is
+         * a promise of the caller and it is not verified, bandwidths are used
+         * only by matrix_structure::banded*/
+        [[nodiscard]] constexpr auto with_structure(
+            matrix_structure s,
+            std::size_t lower_bandwidth = 0,
+            std::size_t upper_bandwidth = 0) const -> matrix_view {
+            matrix_view tagged{*this};
+            tagged._structure = s;
+            tagged._lower_bandwidth = lower_bandwidth;
+            tagged._upper_bandwidth = upper_bandwidth;
+            return tagged;
+        }
+
+
+        /*returns a copy of this view tagged with the structure of m*/
+        template <typename U, typename Layout>
+        [[nodiscard]] constexpr auto with_structure_of(
+            const matrix_view<U, Layout>& m) const -> matrix_view {
+            const auto [lower, upper] = m.bandwidths();
+            return with_structure(m.structure(), lower, upper);
+        }
+
       public:
         using mdspan_type::operator[];
 
@@ -202,6 +269,11 @@ namespace ranges {
             return numeric_view{std::ranges::subrange{
                 this->begin() + i * dim, this->begin() + (i + 1) * dim}};
         }
+
+      private:
+        matrix_structure _structure{matrix_structure::general};
+        std::size_t _lower_bandwidth{0};
+        std::size_t _upper_bandwidth{0};
     };
 
     template <typename T, typename LP>
@@ -218,16 +290,26 @@ namespace ranges {
     requires(std::same_as<LP, std::layout_right> ||
              std::same_as<LP, std::layout_left>)
     constexpr auto transpose(matrix_view<T, LP> m) {
+        // lower and upper parts swap their roles under transposition
+        auto structure{m.structure()};
+        if (structure == matrix_structure::lower_triangular) {
+            structure = matrix_structure::upper_triangular;
+        } else if (structure == matrix_structure::upper_triangular) {
+            structure = matrix_structure::lower_triangular;
+        }
+        const auto [lower, upper] = m.bandwidths();
         if constexpr (std::same_as<LP, std::layout_right>) {
             return matrix_view{m.data(),
                                m.number_of_columns(),
                                m.number_of_rows(),
-                               layout::column};
+                               layout::column}
+                .with_structure(structure, upper, lower);
         } else {
             return matrix_view{m.data(),
                                m.number_of_columns(),
                                m.number_of_rows(),
-                               layout::row};
+                               layout::row}
+                .with_structure(structure, upper, lower);
         }
     }
 
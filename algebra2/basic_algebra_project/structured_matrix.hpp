@@ -0,0 +1,579 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+
+
+namespace algorithms::structured {
+
+    using ::ranges::matrix_structure;
+
+
+    /*
+        description:
+            checks whether x is zero. Fractions are compared by numerator since
+       a zero fraction need not be stored as 0/1
+    */
+    template <typename T>
+    constexpr auto is_zero(const T& x) -> bool {
+        if constexpr (requires { x.numerator; }) {
+            return x.numerator == 0;
+        } else {
+            return x == T{0};
+        }
+    }
+
+
+    /*
+        description:
+            finds a pair (lower bandwidth, upper bandwidth) of m, that is the
+       largest distance below and above the main diagonal of a nonzero entry
+    */
+    template <typename T, typename LP>
+    auto find_bandwidths(::ranges::matrix_view<T, LP> m)
+        -> std::pair<std::size_t, std::size_t> {
+        std::size_t lower{0};
+        std::size_t upper{0};
+        for (std::size_t i = 0; i < m.number_of_rows(); i++) {
+            for (std::size_t j = 0; j < m.number_of_columns(); j++) {
+                if (is_zero(m[i, j])) { continue; }
+                if (i > j) {
+                    lower = std::max(lower, i - j);
+                } else {
+                    upper = std::max(upper, j - i);
+                }
+            }
+        }
+        return {lower, upper};
+    }
+
+
+    /*
+        description:
+            checks whether a square matrix m is equal to its transposition
+    */
+    template <typename T, typename LP>
+    auto is_symmetric(::ranges::matrix_view<T, LP> m) -> bool {
+        if (m.number_of_rows() != m.number_of_columns()) { return false; }
+        for (std::size_t i = 0; i < m.number_of_rows(); i++) {
+            for (std::size_t j = 0; j < i; j++) {
+                if (!(m[i, j] == m[j, i])) { return false; }
+            }
+        }
+        return true;
+    }
+
+
+    /*
+        description:
+            scans a square matrix once and returns it tagged with the most
+       specific structure found. Non square matrices and matrices without a
+       usable structure are tagged as matrix_structure::general. A matrix is
+       tagged as banded only if its band covers at most half of the columns;
+       the band is checked before symmetry, so that a narrow symmetric band
+       goes to the O(n * b^2) banded LU and only a wide one to LDL^T
+    */
+    template <typename T, typename LP>
+    auto detect_structure(::ranges::matrix_view<T, LP> m)
+        -> ::ranges::matrix_view<T, LP> {
+        const std::size_t n = m.number_of_rows();
+        if (n == 0 || n != m.number_of_columns()) {
+            return m.with_structure(matrix_structure::general);
+        }
+        const auto [lower, upper] = find_bandwidths(m);
+        if (lower == 0 && upper == 0) {
+            return m.with_structure(matrix_structure::diagonal);
+        }
+        if (lower == 0) {
+            return m.with_structure(matrix_structure::upper_triangular);
+        }
+        if (upper == 0) {
+            return m.with_structure(matrix_structure::lower_triangular);
+        }
+        if (lower == 1 && upper == 1) {
+            return m.with_structure(matrix_structure::tridiagonal);
+        }
+        if (lower + upper + 1 <= n / 2) {
+            return m.with_structure(matrix_structure::banded, lower, upper);
+        }
+        if (is_symmetric(m)) {
+            return m.with_structure(matrix_structure::symmetric);
+        }
+        return m.with_structure(matrix_structure::general);
+    }
+
+
+    /*
+        description:
+            solves Lx = b for a lower triangular (or lower banded) matrix L in
+       O(n * lower bandwidth). Returns std::nullopt when a diagonal entry is
+       zero
+    */
+    template <typename T, typename LP>
+    auto forward_substitution(::ranges::matrix_view<T, LP> m,
+                              const std::vector<T>& b)
+        -> std::optional<std::vector<T>> {
+        const std::size_t n = m.number_of_rows();
+        const std::size_t lower = std::min(m.bandwidths().first, n);
+        std::vector<T> x(n, T{0});
+        for (std::size_t i = 0; i < n; i++) {
+            if (is_zero(m[i, i])) { return std::nullopt; }
+            T sum = b[i];
+            for (std::size_t j = (i > lower ? i - lower : 0); j < i; j++) {
+                sum -= m[i, j] * x[j];
+            }
+            x[i] = sum / m[i, i];
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            solves Ux = b for an upper triangular (or upper banded) matrix U
+       in O(n * upper bandwidth). Returns std::nullopt when a diagonal entry is
+       zero
+    */
+    template <typename T, typename LP>
+    auto back_substitution(::ranges::matrix_view<T, LP> m,
+                           const std::vector<T>& b)
+        -> std::optional<std::vector<T>> {
+        const std::size_t n = m.number_of_rows();
+        const std::size_t upper = std::min(m.bandwidths().second, n);
+        std::vector<T> x(n, T{0});
+        for (std::size_t i = n; i-- > 0;) {
+            if (is_zero(m[i, i])) { return std::nullopt; }
+            T sum = b[i];
+            for (std::size_t j = i + 1; j < std::min(n, i + upper + 1); j++) {
+                sum -= m[i, j] * x[j];
+            }
+            x[i] = sum / m[i, i];
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            solves a tridiagonal system with the Thomas algorithm in O(n)
+       without pivoting. Returns std::nullopt when a pivot vanishes, then the
+       caller should fall back to elimination with row swaps
+    */
+    template <typename T, typename LP>
+    auto thomas(::ranges::matrix_view<T, LP> m, const std::vector<T>& d)
+        -> std::optional<std::vector<T>> {
+        const std::size_t n = m.number_of_rows();
+        if (n == 0) { return std::vector<T>{}; }
+        std::vector<T> c_prime(n, T{0});
+        std::vector<T> d_prime(n, T{0});
+        T denominator = m[0, 0];
+        if (is_zero(denominator)) { return std::nullopt; }
+        if (n > 1) { c_prime[0] = m[0, 1] / denominator; }
+        d_prime[0] = d[0] / denominator;
+        for (std::size_t i = 1; i < n; i++) {
+            denominator = m[i, i] - m[i, i - 1] * c_prime[i - 1];
+            if (is_zero(denominator)) { return std::nullopt; }
+            if (i + 1 < n) { c_prime[i] = m[i, i + 1] / denominator; }
+            d_prime[i] = (d[i] - m[i, i - 1] * d_prime[i - 1]) / denominator;
+        }
+        std::vector<T> x(n, T{0});
+        x[n - 1] = d_prime[n - 1];
+        for (std::size_t i = n - 1; i > 0; i--) {
+            x[i - 1] = d_prime[i - 1] - c_prime[i - 1] * x[i];
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            LU factors of a banded matrix kept in band storage, row i holds
+       the entries of columns i - lower, ..., i + upper. L has a unit diagonal
+       which is not stored
+    */
+    template <typename T>
+    struct banded_lu {
+        std::size_t size{0};
+        std::size_t lower{0};
+        std::size_t upper{0};
+        std::vector<T> band{};
+
+
+        constexpr auto operator[](std::size_t i, std::size_t j) -> T& {
+            return band[i * (lower + upper + 1) + j + lower - i];
+        }
+
+
+        constexpr auto operator[](std::size_t i, std::size_t j) const
+            -> const T& {
+            return band[i * (lower + upper + 1) + j + lower - i];
+        }
+    };
+
+
+    /*
+        description:
+            factors a banded matrix into LU without pivoting in
+       O(n * lower * upper) operations and O(n * (lower + upper)) memory.
+       Returns std::nullopt on a zero pivot
+    */
+    template <typename T, typename LP>
+    auto banded_lu_decomposition(::ranges::matrix_view<T, LP> m)
+        -> std::optional<banded_lu<T>> {
+        const std::size_t n = m.number_of_rows();
+        const auto [lower, upper] = m.bandwidths();
+        banded_lu<T> lu{n,
+                        std::min(lower, n),
+                        std::min(upper, n),
+                        std::vector<T>(n * (std::min(lower, n) +
+                                            std::min(upper, n) + 1),
+                                       T{0})};
+        for (std::size_t i = 0; i < n; i++) {
+            const std::size_t first = i > lu.lower ? i - lu.lower : 0;
+            const std::size_t last = std::min(n, i + lu.upper + 1);
+            for (std::size_t j = first; j < last; j++) { lu[i, j] = m[i, j]; }
+        }
+        for (std::size_t k = 0; k < n; k++) {
+            if (is_zero(lu[k, k])) { return std::nullopt; }
+            const std::size_t last_row = std::min(n, k + lu.lower + 1);
+            const std::size_t last_column = std::min(n, k + lu.upper + 1);
+            for (std::size_t i = k + 1; i < last_row; i++) {
+                const T factor = lu[i, k] / lu[k, k];
+                lu[i, k] = factor;
+                for (std::size_t j = k + 1; j < last_column; j++) {
+                    lu[i, j] -= factor * lu[k, j];
+                }
+            }
+        }
+        return lu;
+    }
+
+
+    /*
+        description:
+            solves LUx = b using factors computed by banded_lu_decomposition
+    */
+    template <typename T>
+    auto banded_lu_solve(const banded_lu<T>& lu, const std::vector<T>& b)
+        -> std::vector<T> {
+        const std::size_t n = lu.size;
+        std::vector<T> x(b.begin(), b.end());
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = (i > lu.lower ? i - lu.lower : 0); j < i;
+                 j++) {
+                x[i] -= lu[i, j] * x[j];
+            }
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t j = i + 1; j < std::min(n, i + lu.upper + 1);
+                 j++) {
+                x[i] -= lu[i, j] * x[j];
+            }
+            x[i] /= lu[i, i];
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            symmetric matrix which stores only its lower triangle packed row by
+       row, that is n(n + 1) / 2 values instead of n^2
+    */
+    template <typename T>
+    class symmetric_matrix {
+      public:
+        explicit symmetric_matrix(std::size_t size)
+            : _size{size}, _values(size * (size + 1) / 2, T{0}) {}
+
+
+        /*copies the lower triangle of a square matrix m*/
+        template <typename LP>
+        explicit symmetric_matrix(::ranges::matrix_view<T, LP> m)
+            : symmetric_matrix(m.number_of_rows()) {
+            for (std::size_t i = 0; i < _size; i++) {
+                for (std::size_t j = 0; j <= i; j++) {
+                    (*this)[i, j] = m[i, j];
+                }
+            }
+        }
+
+
+        [[nodiscard]] constexpr auto size() const -> std::size_t {
+            return _size;
+        }
+
+
+        constexpr auto operator[](std::size_t i, std::size_t j) -> T& {
+            return _values[index(i, j)];
+        }
+
+
+        constexpr auto operator[](std::size_t i, std::size_t j) const
+            -> const T& {
+            return _values[index(i, j)];
+        }
+
+      private:
+        static constexpr auto index(std::size_t i, std::size_t j)
+            -> std::size_t {
+            if (i < j) { std::swap(i, j); }
+            return i * (i + 1) / 2 + j;
+        }
+
+        std::size_t _size;
+        std::vector<T> _values;
+    };
+
+
+    /*
+        description:
+            computes the Cholesky factor L of a symmetric positive definite
+       matrix, A = LL^T. L is returned in the same packed storage and only its
+       entries [i, j] with i >= j are meaningful. Returns std::nullopt when
+       the matrix is not positive definite
+    */
+    template <std::floating_point T>
+    auto cholesky(const symmetric_matrix<T>& a)
+        -> std::optional<symmetric_matrix<T>> {
+        const std::size_t n = a.size();
+        symmetric_matrix<T> l(n);
+        for (std::size_t j = 0; j < n; j++) {
+            T diagonal = a[j, j];
+            for (std::size_t k = 0; k < j; k++) {
+                diagonal -= l[j, k] * l[j, k];
+            }
+            if (!(diagonal > T{0})) { return std::nullopt; }
+            l[j, j] = std::sqrt(diagonal);
+            for (std::size_t i = j + 1; i < n; i++) {
+                T sum = a[i, j];
+                for (std::size_t k = 0; k < j; k++) {
+                    sum -= l[i, k] * l[j, k];
+                }
+                l[i, j] = sum / l[j, j];
+            }
+        }
+        return l;
+    }
+
+
+    /*
+        description:
+            solves LL^T x = b given a Cholesky factor L
+    */
+    template <std::floating_point T>
+    auto cholesky_solve(const symmetric_matrix<T>& l, const std::vector<T>& b)
+        -> std::vector<T> {
+        const std::size_t n = l.size();
+        std::vector<T> x(b.begin(), b.end());
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t k = 0; k < i; k++) { x[i] -= l[i, k] * x[k]; }
+            x[i] /= l[i, i];
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t k = i + 1; k < n; k++) { x[i] -= l[k, i] * x[k]; }
+            x[i] /= l[i, i];
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            square root free variant of Cholesky, A = LDL^T with unit lower
+       triangular L, suitable for exact types like fractions. Returns a pair
+       (L, diagonal of D) or std::nullopt when a pivot vanishes
+    */
+    template <typename T>
+    auto ldlt(const symmetric_matrix<T>& a)
+        -> std::optional<std::pair<symmetric_matrix<T>, std::vector<T>>> {
+        const std::size_t n = a.size();
+        symmetric_matrix<T> l(n);
+        std::vector<T> d(n, T{0});
+        for (std::size_t j = 0; j < n; j++) {
+            T pivot = a[j, j];
+            for (std::size_t k = 0; k < j; k++) {
+                pivot -= l[j, k] * l[j, k] * d[k];
+            }
+            if (is_zero(pivot)) { return std::nullopt; }
+            d[j] = pivot;
+            l[j, j] = T{1};
+            for (std::size_t i = j + 1; i < n; i++) {
+                T sum = a[i, j];
+                for (std::size_t k = 0; k < j; k++) {
+                    sum -= l[i, k] * l[j, k] * d[k];
+                }
+                l[i, j] = sum / pivot;
+            }
+        }
+        return std::pair{std::move(l), std::move(d)};
+    }
+
+
+    /*
+        description:
+            solves LDL^T x = b given factors computed by ldlt
+    */
+    template <typename T>
+    auto ldlt_solve(const std::pair<symmetric_matrix<T>, std::vector<T>>& ld,
+                    const std::vector<T>& b) -> std::vector<T> {
+        const auto& [l, d] = ld;
+        const std::size_t n = l.size();
+        std::vector<T> x(b.begin(), b.end());
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t k = 0; k < i; k++) { x[i] -= l[i, k] * x[k]; }
+        }
+        for (std::size_t i = 0; i < n; i++) { x[i] /= d[i]; }
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t k = i + 1; k < n; k++) { x[i] -= l[k, i] * x[k]; }
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            solves a symmetric system, Cholesky is tried first for floating
+       point types and LDL^T is used otherwise or when the matrix is not
+       positive definite
+    */
+    template <typename T>
+    auto symmetric_solve(const symmetric_matrix<T>& a, const std::vector<T>& b)
+        -> std::optional<std::vector<T>> {
+        if constexpr (std::floating_point<T>) {
+            if (auto l = cholesky(a)) { return cholesky_solve(*l, b); }
+        }
+        if (auto ld = ldlt(a)) { return ldlt_solve(*ld, b); }
+        return std::nullopt;
+    }
+
+
+    /*
+        description:
+            solves mx = b choosing the kernel from the structure tag of m.
+       Returns std::nullopt for matrix_structure::general, for non square
+       input and whenever the specialised kernel meets a zero pivot, in all
+       those cases dense elimination should be used instead
+    */
+    template <typename T, typename LP>
+    auto solve(::ranges::matrix_view<T, LP> m, const std::vector<T>& b)
+        -> std::optional<std::vector<T>> {
+        const std::size_t n = m.number_of_rows();
+        if (n != m.number_of_columns() || n != b.size()) {
+            return std::nullopt;
+        }
+        switch (m.structure()) {
+            case matrix_structure::diagonal: {
+                std::vector<T> x(n, T{0});
+                for (std::size_t i = 0; i < n; i++) {
+                    if (is_zero(m[i, i])) { return std::nullopt; }
+                    x[i] = b[i] / m[i, i];
+                }
+                return x;
+            }
+            case matrix_structure::lower_triangular:
+                return forward_substitution(m, b);
+            case matrix_structure::upper_triangular:
+                return back_substitution(m, b);
+            case matrix_structure::tridiagonal: return thomas(m, b);
+            case matrix_structure::banded: {
+                auto lu = banded_lu_decomposition(m);
+                if (!lu) { return std::nullopt; }
+                return banded_lu_solve(*lu, b);
+            }
+            case matrix_structure::symmetric:
+                return symmetric_solve(symmetric_matrix<T>{m}, b);
+            default: return std::nullopt;
+        }
+    }
+
+
+    /*
+        description:
+            calculates the determinant of a structured matrix. Diagonal and
+       triangular matrices take O(n), banded ones O(n * lower * upper).
+       Returns std::nullopt when the structure does not help or a pivot
+       vanishes
+    */
+    template <typename T, typename LP>
+    auto determinant(::ranges::matrix_view<T, LP> m) -> std::optional<T> {
+        const std::size_t n = m.number_of_rows();
+        if (n != m.number_of_columns()) { return std::nullopt; }
+        T det{1};
+        switch (m.structure()) {
+            case matrix_structure::diagonal:
+            case matrix_structure::lower_triangular:
+            case matrix_structure::upper_triangular:
+                for (std::size_t i = 0; i < n; i++) { det *= m[i, i]; }
+                return det;
+            case matrix_structure::tridiagonal:
+            case matrix_structure::banded: {
+                auto lu = banded_lu_decomposition(m);
+                if (!lu) { return std::nullopt; }
+                for (std::size_t i = 0; i < n; i++) { det *= (*lu)[i, i]; }
+                return det;
+            }
+            case matrix_structure::symmetric: {
+                auto ld = ldlt(symmetric_matrix<T>{m});
+                if (!ld) { return std::nullopt; }
+                for (const auto& pivot : ld->second) { det *= pivot; }
+                return det;
+            }
+            default: return std::nullopt;
+        }
+    }
+
+
+    /*
+        description:
+            computes the inverse of a structured matrix column by column,
+       factoring the matrix only once. The result is stored row-wise. Returns
+       std::nullopt in the same cases as solve
+    */
+    template <typename T, typename LP>
+    auto inverse(::ranges::matrix_view<T, LP> m)
+        -> std::optional<std::vector<T>> {
+        const std::size_t n = m.number_of_rows();
+        if (n != m.number_of_columns() ||
+            m.structure() == matrix_structure::general) {
+            return std::nullopt;
+        }
+        std::optional<banded_lu<T>> lu{};
+        std::optional<std::pair<symmetric_matrix<T>, std::vector<T>>> ld{};
+        if (m.structure() == matrix_structure::tridiagonal ||
+            m.structure() == matrix_structure::banded) {
+            lu = banded_lu_decomposition(m);
+            if (!lu) { return std::nullopt; }
+        } else if (m.structure() == matrix_structure::symmetric) {
+            ld = ldlt(symmetric_matrix<T>{m});
+            if (!ld) { return std::nullopt; }
+        }
+        std::vector<T> result(n * n, T{0});
+        std::vector<T> unit(n, T{0});
+        for (std::size_t column = 0; column < n; column++) {
+            unit[column] = T{1};
+            std::optional<std::vector<T>> x{};
+            if (lu) {
+                x = banded_lu_solve(*lu, unit);
+            } else if (ld) {
+                x = ldlt_solve(*ld, unit);
+            } else {
+                x = solve(m, unit);
+            }
+            if (!x) { return std::nullopt; }
+            for (std::size_t row = 0; row < n; row++) {
+                result[row * n + column] = (*x)[row];
+            }
+            unit[column] = T{0};
+        }
+        return result;
+    }
+
+}  // namespace algorithms::structured
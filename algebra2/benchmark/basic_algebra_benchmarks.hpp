@@ -0,0 +1,13 @@
+#pragma once
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace benchmark {
+
+    /*kernels of the header only basic_algebra_project, they live in their own
+     * translation unit because its global namespace matrix collides with the
+     * class matrix exported by the matrix module*/
+    auto basic_algebra_benchmarks(const settings& s) -> std::vector<record>;
+
+}  // namespace benchmark
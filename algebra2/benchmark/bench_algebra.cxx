@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "basic_algebra_benchmarks.hpp"
+
+import matrix;
+import fraction;
+import gaussian_elimination;
+import eigen;
+
+namespace {
+
+    constexpr std::size_t elimination_cap{128};
+    constexpr std::size_t inverse_cap{64};
+    constexpr std::size_t lu_cap{1024};
+    constexpr std::size_t dense_eigen_cap{128};
+    constexpr std::size_t power_method_cap{512};
+
+    struct options {
+        benchmark::settings settings{};
+        std::string json{};
+        std::string csv{};
+        std::string baseline{};
+        double threshold{0.10};
+    };
+
+    // a = l * u where l and u are unit triangular matrices of ones, so the
+    // entries are a[i, j] = min(i, j) + 1 and the elimination stays integral
+    auto fraction_input(std::size_t n) -> matrix<fraction<int>> {
+        matrix<fraction<int>> a{n, n, fraction<int>{0, 1}};
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                const auto value{static_cast<int>(std::min(i, j) + 1)};
+                a[i, j] = fraction<int>{value, 1};
+            }
+        }
+        return a;
+    }
+
+    // symmetric tridiagonal matrix with distinct eigenvalues
+    auto double_input(std::size_t n) -> matrix<double> {
+        matrix<double> a{n, n, 0.0};
+        for (std::size_t i = 0; i < n; i++) {
+            a[i, i] = 2.0 + 0.1 * static_cast<double>(i);
+            if (i + 1 < n) { a[i, i + 1] = a[i + 1, i] = -1.0; }
+        }
+        return a;
+    }
+
+    // dense and diagonally dominant, so every pivot strategy has work to do
+    auto dense_input(std::size_t n) -> matrix<double> {
+        matrix<double> a{n, n, 0.0};
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                a[i, j] = 1.0 / static_cast<double>(i + j + 1);
+            }
+            a[i, i] += static_cast<double>(n);
+        }
+        return a;
+    }
+
+    auto cube(std::size_t n) -> double {
+        const auto d{static_cast<double>(n)};
+        return d * d * d;
+    }
+
+    // rows of fraction_input scaled by 1, 2 or 3, so the multipliers of the
+    // elimination are proper fractions with small denominators
+    template <typename F>
+    auto scaled_fraction_input(std::size_t n) -> std::vector<F> {
+        std::vector<F> a(n * n);
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                const auto value{(i % 3 + 1) * (std::min(i, j) + 1)};
+                a[(i * n) + j] = F{static_cast<std::int64_t>(value), 1};
+            }
+        }
+        return a;
+    }
+
+    // forward elimination without pivoting, the rows of fractions are updated
+    // by the batch operation of the rational module, the lazy fraction is
+    // reduced once per fused update instead of after the product and the
+    // difference
+    template <typename F>
+    auto eliminate(std::vector<F>& a, std::size_t n) -> void {
+        for (std::size_t k = 0; k < n; k++) {
+            for (std::size_t i = k + 1; i < n; i++) {
+                const F l{a[(i * n) + k] / a[(k * n) + k]};
+                if constexpr (check_fraction<F>) {
+                    subtract_multiple(
+                        std::span{&a[(i * n) + k], n - k},
+                        l,
+                        std::span{&std::as_const(a)[(k * n) + k], n - k});
+                } else {
+                    for (std::size_t j = k; j < n; j++) {
+                        F& entry{a[(i * n) + j]};
+                        entry = entry - l * a[(k * n) + j];
+                        entry.reduce();
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    auto fraction_elimination(const benchmark::settings& s,
+                              std::string_view type,
+                              std::vector<benchmark::record>& records)
+        -> void {
+        for (std::size_t n : benchmark::sizes(s, elimination_cap)) {
+            const auto input{scaled_fraction_input<F>(n)};
+            records.push_back(benchmark::measure(
+                "fraction_elimination", type, n, 2 * cube(n) / 3, s, [&] {
+                    auto a{input};
+                    eliminate(a, n);
+                    benchmark::keep(a);
+                }));
+        }
+    }
+
+    auto gaussian_benchmarks(const benchmark::settings& s,
+                             std::vector<benchmark::record>& records) -> void {
+        using utils::matrix::reducted_form;
+        if (benchmark::selected(s, "determinant")) {
+            for (std::size_t n : benchmark::sizes(s, elimination_cap)) {
+                const auto a{fraction_input(n)};
+                records.push_back(benchmark::measure(
+                    "determinant", "fraction", n, 2 * cube(n) / 3, s, [&] {
+                        auto d{utils::matrix::determinant(a)};
+                        benchmark::keep(d);
+                    }));
+            }
+        }
+        if (benchmark::selected(s, "inverse")) {
+            for (std::size_t n : benchmark::sizes(s, inverse_cap)) {
+                auto a{fraction_input(n)};
+                records.push_back(benchmark::measure(
+                    "inverse", "fraction", n, 2 * cube(n), s, [&] {
+                        auto inverse{utils::matrix::inverse(a)};
+                        benchmark::keep(inverse);
+                    }));
+            }
+        }
+        if (benchmark::selected(s, "gaussian_elimiantion_alg")) {
+            for (std::size_t n : benchmark::sizes(s, elimination_cap)) {
+                auto a{fraction_input(n)};
+                records.push_back(benchmark::measure(
+                    "gaussian_elimiantion_alg",
+                    "fraction",
+                    n,
+                    2 * cube(n) / 3,
+                    s,
+                    [&] {
+                        auto result{utils::matrix::gaussian_elimiantion_alg(
+                            a, reducted_form::echelon)};
+                        benchmark::keep(result);
+                    }));
+            }
+        }
+        if (benchmark::selected(s, "fraction_elimination")) {
+            fraction_elimination<fraction<std::int64_t>>(
+                s, "fraction<int64>", records);
+            fraction_elimination<lazy_fraction<std::int64_t>>(
+                s, "lazy_fraction<int64>", records);
+        }
+    }
+
+    auto lu_benchmarks(const benchmark::settings& s,
+                       std::vector<benchmark::record>& records) -> void {
+        using utils::matrix::pivoting;
+        constexpr std::array strategies{
+            std::pair{std::string_view{"lu_decomposition/partial"},
+                      pivoting::partial},
+            std::pair{std::string_view{"lu_decomposition/scaled_partial"},
+                      pivoting::scaled_partial},
+            std::pair{std::string_view{"lu_decomposition/rook"},
+                      pivoting::rook},
+            std::pair{std::string_view{"lu_decomposition/complete"},
+                      pivoting::complete}};
+        for (auto [kernel, strategy] : strategies) {
+            if (!benchmark::selected(s, kernel)) { continue; }
+            for (std::size_t n : benchmark::sizes(s, lu_cap)) {
+                const auto a{dense_input(n)};
+                records.push_back(benchmark::measure(
+                    kernel, "double", n, 2 * cube(n) / 3, s, [&] {
+                        auto lu{utils::matrix::lu_decomposition(a, strategy)};
+                        benchmark::keep(lu);
+                    }));
+            }
+        }
+    }
+
+    // the eigen solvers iterate until convergence, so they have no flop model
+    auto eigen_benchmarks(const benchmark::settings& s,
+                          std::vector<benchmark::record>& records) -> void {
+        if (benchmark::selected(s, "eigen::qr")) {
+            for (std::size_t n : benchmark::sizes(s, dense_eigen_cap)) {
+                const auto a{double_input(n)};
+                records.push_back(
+                    benchmark::measure("eigen::qr", "double", n, 0, s, [&] {
+                        auto values{eigen::qr(a)};
+                        benchmark::keep(values);
+                    }));
+            }
+        }
+        if (benchmark::selected(s, "eigen::jacobi")) {
+            for (std::size_t n : benchmark::sizes(s, dense_eigen_cap)) {
+                const auto a{double_input(n)};
+                records.push_back(
+                    benchmark::measure("eigen::jacobi", "double", n, 0, s, [&] {
+                        auto values{eigen::jacobi(a)};
+                        benchmark::keep(values);
+                    }));
+            }
+        }
+        if (benchmark::selected(s, "eigen::power_method")) {
+            for (std::size_t n : benchmark::sizes(s, power_method_cap)) {
+                const auto a{double_input(n)};
+                records.push_back(benchmark::measure(
+                    "eigen::power_method", "double", n, 0, s, [&] {
+                        auto vector{eigen::power_method(a)};
+                        benchmark::keep(vector);
+                    }));
+            }
+        }
+    }
+
+    auto parse(int argc, char** argv) -> std::optional<options> {
+        options result{};
+        const std::vector<std::string_view> args(argv + 1, argv + argc);
+        for (std::size_t i = 0; i < args.size(); i++) {
+            const bool has_value{i + 1 < args.size()};
+            if (args[i] == "--help" || !has_value) { return std::nullopt; }
+            const std::string value{args[++i]};
+            if (args[i - 1] == "--min-size") {
+                result.settings.min_size = std::stoul(value);
+            } else if (args[i - 1] == "--max-size") {
+                result.settings.max_size = std::stoul(value);
+            } else if (args[i - 1] == "--min-time") {
+                result.settings.min_time =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>{std::stod(value)});
+            } else if (args[i - 1] == "--filter") {
+                result.settings.filter = value;
+            } else if (args[i - 1] == "--json") {
+                result.json = value;
+            } else if (args[i - 1] == "--csv") {
+                result.csv = value;
+            } else if (args[i - 1] == "--baseline") {
+                result.baseline = value;
+            } else if (args[i - 1] == "--threshold") {
+                result.threshold = std::stod(value);
+            } else {
+                return std::nullopt;
+            }
+        }
+        if (result.settings.min_size == 0) { return std::nullopt; }
+        return result;
+    }
+
+    auto usage() -> void {
+        std::println(
+            "usage: bench_algebra [--min-size N] [--max-size N] "
+            "[--min-time SECONDS] [--filter KERNEL] [--json FILE] "
+            "[--csv FILE] [--baseline FILE] [--threshold FRACTION]");
+    }
+
+}  // namespace
+
+
+auto main(int argc, char** argv) -> int {
+    const auto parsed{parse(argc, argv)};
+    if (!parsed) {
+        usage();
+        return 2;
+    }
+    const options& o{*parsed};
+    std::vector<benchmark::record> records{};
+    gaussian_benchmarks(o.settings, records);
+    lu_benchmarks(o.settings, records);
+    eigen_benchmarks(o.settings, records);
+    std::ranges::move(benchmark::basic_algebra_benchmarks(o.settings),
+                      std::back_inserter(records));
+
+    std::println("{:<26} {:<8} {:>5} {:>14} {:>9} {:>10}",
+                 "kernel",
+                 "type",
+                 "size",
+                 "ns/op",
+                 "GFLOP/s",
+                 "allocs/op");
+    for (const auto& r : records) {
+        std::println("{:<26} {:<8} {:>5} {:>14.1f} {:>9.3f} {:>10.1f}",
+                     r.kernel,
+                     r.type,
+                     r.size,
+                     r.ns_per_op,
+                     r.gflops,
+                     r.allocations_per_op);
+    }
+    if (!o.csv.empty()) { benchmark::write_csv(records, o.csv); }
+    if (!o.json.empty()) { benchmark::write_json(records, o.json); }
+    if (o.baseline.empty()) { return 0; }
+
+    const auto baseline{benchmark::read_baseline(o.baseline)};
+    if (!baseline) {
+        std::println("cannot read baseline {}", o.baseline);
+        return 2;
+    }
+    const std::size_t regressions{
+        benchmark::compare(records, *baseline, o.threshold)};
+    std::println("{} regression(s) above {:.0f}%",
+                 regressions,
+                 o.threshold * 100);
+    return regressions == 0 ? 0 : 1;
+}
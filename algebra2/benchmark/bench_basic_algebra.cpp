@@ -0,0 +1,89 @@
+#include <array>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../basic_algebra_project/basic_algebra_2_pack.hpp"
+#include "basic_algebra_benchmarks.hpp"
+
+namespace {
+
+    constexpr std::size_t multiply_cap{4096};
+    constexpr std::size_t naive_multiply_cap{1024};
+    constexpr std::size_t file_cap{1024};
+
+    // small entries so that the int products do not overflow for n = 4096
+    template <typename T>
+    auto input(std::size_t n, std::size_t seed) -> std::vector<T> {
+        std::vector<T> values(n * n);
+        for (std::size_t i = 0; i < values.size(); i++) {
+            values[i] = static_cast<T>((i * seed) % 7) - static_cast<T>(3);
+        }
+        return values;
+    }
+
+    template <typename T>
+    auto multiply(const benchmark::settings& s,
+                  std::string_view type,
+                  std::vector<benchmark::record>& records) -> void {
+        using enum algebra::multiply_algorithm;
+        constexpr std::array kernels{
+            std::pair{std::string_view{"matrix_multiply"}, automatic},
+            std::pair{std::string_view{"matrix_multiply/naive"}, naive}};
+        for (auto [kernel, algorithm] : kernels) {
+            if (!benchmark::selected(s, kernel)) { continue; }
+            const std::size_t cap{algorithm == naive ? naive_multiply_cap
+                                                     : multiply_cap};
+            for (std::size_t n : benchmark::sizes(s, cap)) {
+                auto v1{input<T>(n, 3)};
+                auto v2{input<T>(n, 5)};
+                ::ranges::matrix_view m1(v1, n, n, layout::row);
+                ::ranges::matrix_view m2(v2, n, n, layout::row);
+                const auto d{static_cast<double>(n)};
+                records.push_back(benchmark::measure(
+                    kernel, type, n, 2 * d * d * d, s, [&] {
+                        auto product{
+                            algebra::matrix_multiply(m1, m2, algorithm)};
+                        benchmark::keep(product);
+                    }));
+            }
+        }
+    }
+
+    auto files(const benchmark::settings& s,
+               std::vector<benchmark::record>& records) -> void {
+        const auto file{std::filesystem::temp_directory_path() /
+                        "lemkis_bench" / "matrix.csv"};
+        for (std::size_t n : benchmark::sizes(s, file_cap)) {
+            auto values{input<double>(n, 3)};
+            ::ranges::matrix_view m(values, n, n, layout::row);
+            if (benchmark::selected(s, "matrix::save")) {
+                records.push_back(benchmark::measure(
+                    "matrix::save", "double", n, 0, s, [&] {
+                        matrix::save<',', ';'>(m, file);
+                    }));
+            }
+            if (benchmark::selected(s, "matrix::load")) {
+                matrix::save<',', ';'>(m, file);
+                records.push_back(benchmark::measure(
+                    "matrix::load", "double", n, 0, s, [&] {
+                        auto loaded{matrix::load<double, ',', ';'>(file)};
+                        benchmark::keep(loaded);
+                    }));
+            }
+        }
+        std::filesystem::remove_all(file.parent_path());
+    }
+
+}  // namespace
+
+
+auto benchmark::basic_algebra_benchmarks(const settings& s)
+    -> std::vector<record> {
+    std::vector<record> records{};
+    multiply<int>(s, "int", records);
+    multiply<double>(s, "double", records);
+    files(s, records);
+    return records;
+}
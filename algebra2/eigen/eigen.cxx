@@ -1,11 +1,22 @@
 module;
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstdint>
 #include <ctime>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
 #include <set>
+#include <span>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 export module eigen;
 import matrix;
@@ -22,7 +33,7 @@ inline auto convert_to_double(matrix<T> m) -> matrix<double> {
 }
 
 template <typename T>
-inline auto m_by_v(matrix<T> m, matrix<T> v) -> matrix<T> {
+inline auto m_by_v(const matrix<T>& m, const matrix<T>& v) -> matrix<T> {
     assert(m.number_of_columns() == v.number_of_rows() &&
            v.number_of_columns() == 1);
     matrix<T> multiply_result{m.number_of_rows(), 1, 0};
@@ -266,14 +277,539 @@ inline auto check_tolerance(matrix<T> v1, matrix<T> v2) -> bool {
     return true;
 }
 
+inline auto dot(const std::vector<double>& x, const std::vector<double>& y)
+    -> double {
+    return std::inner_product(x.begin(), x.end(), y.begin(), 0.0);
+}
+
+inline auto norm(const std::vector<double>& x) -> double {
+    return std::sqrt(dot(x, x));
+}
+
+inline auto axpy(double alpha,
+                 const std::vector<double>& x,
+                 std::vector<double>& y) -> void {
+    for (std::size_t i = 0; i < y.size(); i++) { y[i] += alpha * x[i]; }
+}
+
+inline auto random_vector(std::size_t n, std::mt19937_64& engine)
+    -> std::vector<double> {
+    std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+    std::vector<double> v(n);
+    for (auto& x : v) { x = distribution(engine); }
+    return v;
+}
+
+// c = a * b, the i-k-j order streams rows of b and c
+template <typename T>
+inline auto gemm(const matrix<T>& a, const matrix<T>& b) -> matrix<T> {
+    assert(a.number_of_columns() == b.number_of_rows());
+    matrix<T> c{a.number_of_rows(), b.number_of_columns(), T{0}};
+    for (std::size_t i = 0; i < a.number_of_rows(); i++) {
+        for (std::size_t k = 0; k < a.number_of_columns(); k++) {
+            const T a_ik{a[i, k]};
+            for (std::size_t j = 0; j < b.number_of_columns(); j++) {
+                c[i, j] += a_ik * b[k, j];
+            }
+        }
+    }
+    return c;
+}
+
+// c = a^T * b without forming the transposition
+template <typename T>
+inline auto gemm_transposed(const matrix<T>& a, const matrix<T>& b)
+    -> matrix<T> {
+    assert(a.number_of_rows() == b.number_of_rows());
+    matrix<T> c{a.number_of_columns(), b.number_of_columns(), T{0}};
+    for (std::size_t k = 0; k < a.number_of_rows(); k++) {
+        for (std::size_t i = 0; i < a.number_of_columns(); i++) {
+            const T a_ki{a[k, i]};
+            for (std::size_t j = 0; j < b.number_of_columns(); j++) {
+                c[i, j] += a_ki * b[k, j];
+            }
+        }
+    }
+    return c;
+}
+
+// orthogonalizes w against the first count basis vectors, the second pass
+// restores orthogonality lost to cancellation, coefficients go to h[., column]
+inline auto orthogonalize(const std::vector<std::vector<double>>& basis,
+                          std::size_t count,
+                          std::vector<double>& w,
+                          matrix<double>& h,
+                          std::size_t column) -> void {
+    for (std::size_t pass = 0; pass < 2; pass++) {
+        for (std::size_t i = 0; i < count; i++) {
+            const double c{dot(basis[i], w)};
+            axpy(-c, basis[i], w);
+            h[i, column] += c;
+        }
+    }
+}
+
+// normalizes w into the next basis vector and returns its former norm. On
+// breakdown (invariant subspace) a random direction orthogonal to the basis
+// is used and 0 is returned
+inline auto next_basis_vector(std::vector<std::vector<double>>& basis,
+                              std::size_t count,
+                              std::vector<double> w,
+                              double scale,
+                              std::mt19937_64& engine) -> double {
+    double beta{norm(w)};
+    const double breakdown{std::numeric_limits<double>::epsilon() * scale};
+    if (beta <= breakdown) {
+        matrix<double> ignored{count + 1, 1, 0.0};
+        w = random_vector(w.size(), engine);
+        orthogonalize(basis, count, w, ignored, 0);
+        beta = 0.0;
+    }
+    const double w_norm{norm(w)};
+    if (w_norm > 0) {
+        for (auto& x : w) { x /= w_norm; }
+    }
+    basis[count] = std::move(w);
+    return beta;
+}
+
+// cyclic Jacobi method for a small dense symmetric matrix, returns eigenvalues
+// and eigenvectors stored in columns
+inline auto symmetric_eigen(matrix<double> a)
+    -> std::pair<std::vector<double>, matrix<double>> {
+    const std::size_t n{a.number_of_rows()};
+    matrix<double> v{utils::matrix::identity<double>(n)};
+    for (std::size_t sweep = 0; sweep < 100; sweep++) {
+        double off{0};
+        double total{0};
+        for (std::size_t p = 0; p < n; p++) {
+            for (std::size_t q = 0; q < n; q++) {
+                total += a[p, q] * a[p, q];
+                if (p != q) { off += a[p, q] * a[p, q]; }
+            }
+        }
+        const double eps{std::numeric_limits<double>::epsilon()};
+        if (off <= eps * eps * total) { break; }
+        for (std::size_t p = 0; p + 1 < n; p++) {
+            for (std::size_t q = p + 1; q < n; q++) {
+                if (a[p, q] == 0.0) { continue; }
+                const double theta{(a[q, q] - a[p, p]) / (2.0 * a[p, q])};
+                const double t{
+                    (theta >= 0 ? 1.0 : -1.0) /
+                    (std::abs(theta) + std::sqrt(theta * theta + 1))};
+                const double c{1.0 / std::sqrt(t * t + 1.0)};
+                const double s{t * c};
+                for (std::size_t k = 0; k < n; k++) {
+                    const double a_kp{a[k, p]};
+                    const double a_kq{a[k, q]};
+                    a[k, p] = c * a_kp - s * a_kq;
+                    a[k, q] = s * a_kp + c * a_kq;
+                }
+                for (std::size_t k = 0; k < n; k++) {
+                    const double a_pk{a[p, k]};
+                    const double a_qk{a[q, k]};
+                    a[p, k] = c * a_pk - s * a_qk;
+                    a[q, k] = s * a_pk + c * a_qk;
+                }
+                for (std::size_t k = 0; k < n; k++) {
+                    const double v_kp{v[k, p]};
+                    const double v_kq{v[k, q]};
+                    v[k, p] = c * v_kp - s * v_kq;
+                    v[k, q] = s * v_kp + c * v_kq;
+                }
+            }
+        }
+    }
+    std::vector<double> values(n);
+    for (std::size_t i = 0; i < n; i++) { values[i] = a[i, i]; }
+    return {values, v};
+}
+
+using complex = std::complex<double>;
+
+// one explicitly shifted QR step on the active window [low, high] of a
+// complex upper Hessenberg matrix t, the rotations are accumulated in z so
+// that t stays equal to z^H * h * z
+inline auto shifted_qr_step(matrix<complex>& t,
+                            matrix<complex>& z,
+                            std::size_t low,
+                            std::size_t high,
+                            complex shift) -> void {
+    const std::size_t m{t.number_of_rows()};
+    for (std::size_t i = low; i <= high; i++) { t[i, i] -= shift; }
+    // rotation (a, b, r) maps the pair (a, b) onto (r, 0)
+    std::vector<std::tuple<complex, complex, double>> rotations{};
+    for (std::size_t j = low; j < high; j++) {
+        const complex a{t[j, j]};
+        const complex b{t[j + 1, j]};
+        const double r{std::hypot(std::abs(a), std::abs(b))};
+        rotations.emplace_back(a, b, r);
+        if (r == 0.0) { continue; }
+        for (std::size_t col = j; col < m; col++) {
+            const complex x{t[j, col]};
+            const complex y{t[j + 1, col]};
+            t[j, col] = (std::conj(a) * x + std::conj(b) * y) / r;
+            t[j + 1, col] = (-b * x + a * y) / r;
+        }
+    }
+    for (std::size_t j = low; j < high; j++) {
+        const auto [a, b, r] = rotations[j - low];
+        if (r == 0.0) { continue; }
+        for (std::size_t row = 0; row <= std::min(j + 1, high); row++) {
+            const complex x{t[row, j]};
+            const complex y{t[row, j + 1]};
+            t[row, j] = (x * a + y * b) / r;
+            t[row, j + 1] = (-x * std::conj(b) + y * std::conj(a)) / r;
+        }
+        for (std::size_t row = 0; row < m; row++) {
+            const complex x{z[row, j]};
+            const complex y{z[row, j + 1]};
+            z[row, j] = (x * a + y * b) / r;
+            z[row, j + 1] = (-x * std::conj(b) + y * std::conj(a)) / r;
+        }
+    }
+    for (std::size_t i = low; i <= high; i++) { t[i, i] += shift; }
+}
+
+// one explicitly shifted QR step with a real shift on a whole real upper
+// Hessenberg matrix h, the rotations are accumulated in q so that h stays
+// equal to q^T * h * q
+inline auto shifted_qr_step(matrix<double>& h, matrix<double>& q, double shift)
+    -> void {
+    const std::size_t m{h.number_of_rows()};
+    for (std::size_t i = 0; i < m; i++) { h[i, i] -= shift; }
+    // rotation (c, s) maps the pair (a, b) onto (r, 0)
+    std::vector<std::pair<double, double>> rotations{};
+    for (std::size_t j = 0; j + 1 < m; j++) {
+        const double a{h[j, j]};
+        const double b{h[j + 1, j]};
+        const double r{std::hypot(a, b)};
+        rotations.emplace_back(r == 0.0 ? 1.0 : a / r, r == 0.0 ? 0.0 : b / r);
+        const auto [c, s] = rotations.back();
+        for (std::size_t col = j; col < m; col++) {
+            const double x{h[j, col]};
+            const double y{h[j + 1, col]};
+            h[j, col] = c * x + s * y;
+            h[j + 1, col] = -s * x + c * y;
+        }
+    }
+    for (std::size_t j = 0; j + 1 < m; j++) {
+        const auto [c, s] = rotations[j];
+        for (std::size_t row = 0; row <= j + 1; row++) {
+            const double x{h[row, j]};
+            const double y{h[row, j + 1]};
+            h[row, j] = c * x + s * y;
+            h[row, j + 1] = -s * x + c * y;
+        }
+        for (std::size_t row = 0; row < m; row++) {
+            const double x{q[row, j]};
+            const double y{q[row, j + 1]};
+            q[row, j] = c * x + s * y;
+            q[row, j + 1] = -s * x + c * y;
+        }
+    }
+    for (std::size_t i = 0; i < m; i++) { h[i, i] += shift; }
+}
+
+// reflects the rows first..first + size - 1 of h from column `from` on and
+// the same columns of h up to row `to` and of q by I - 2 v v^T / v^T v
+inline auto reflect(matrix<double>& h,
+                    matrix<double>& q,
+                    std::span<const double> v,
+                    std::size_t first,
+                    std::size_t from,
+                    std::size_t to) -> void {
+    const std::size_t m{h.number_of_rows()};
+    double length{0};
+    for (const double x : v) { length += x * x; }
+    if (length == 0.0) { return; }
+    const double factor{2.0 / length};
+    for (std::size_t col = from; col < m; col++) {
+        double dot{0};
+        for (std::size_t i = 0; i < v.size(); i++) {
+            dot += v[i] * h[first + i, col];
+        }
+        for (std::size_t i = 0; i < v.size(); i++) {
+            h[first + i, col] -= factor * dot * v[i];
+        }
+    }
+    const auto right{[&](matrix<double>& a, std::size_t rows) {
+        for (std::size_t row = 0; row < rows; row++) {
+            double dot{0};
+            for (std::size_t i = 0; i < v.size(); i++) {
+                dot += a[row, first + i] * v[i];
+            }
+            for (std::size_t i = 0; i < v.size(); i++) {
+                a[row, first + i] -= factor * dot * v[i];
+            }
+        }
+    }};
+    right(h, std::min(to + 1, m));
+    right(q, m);
+}
+
+// one Francis double shift step on a whole real upper Hessenberg matrix h
+// with the shifts mu and conj(mu), given by s = 2 Re mu and t = |mu|^2, so
+// that all arithmetic stays real. The bulge is chased down with 3 x 3
+// Householder reflections accumulated in q, h stays equal to q^T * h * q
+inline auto double_shift_qr_step(matrix<double>& h,
+                                 matrix<double>& q,
+                                 double s,
+                                 double t) -> void {
+    const std::size_t m{h.number_of_rows()};
+    if (m < 3) { return; }
+    // first column of h^2 - s h + t I, nonzero in its top three entries only
+    double x{(h[0, 0] * h[0, 0]) + (h[0, 1] * h[1, 0]) - (s * h[0, 0]) + t};
+    double y{h[1, 0] * (h[0, 0] + h[1, 1] - s)};
+    double z{h[1, 0] * h[2, 1]};
+    // v = u + sign(u_0) |u| e_0 maps u onto a multiple of e_0
+    const auto householder{[](std::span<double> u) {
+        double length{0};
+        for (const double a : u) { length += a * a; }
+        length = std::sqrt(length);
+        u[0] += u[0] < 0 ? -length : length;
+    }};
+    for (std::size_t k = 0; k + 2 < m; k++) {
+        std::array<double, 3> v{x, y, z};
+        householder(v);
+        reflect(h, q, v, k, k > 0 ? k - 1 : 0, k + 3);
+        x = h[k + 1, k];
+        y = h[k + 2, k];
+        if (k + 3 < m) { z = h[k + 3, k]; }
+    }
+    std::array<double, 2> v{x, y};
+    householder(v);
+    reflect(h, q, v, m - 2, m - 3, m - 1);
+    // the reflections leave rounding noise below the subdiagonal
+    for (std::size_t col = 0; col + 2 < m; col++) {
+        for (std::size_t row = col + 2; row < m; row++) { h[row, col] = 0.0; }
+    }
+}
+
+// eigenvalues and normalized eigenvectors (in columns) of a small upper
+// Hessenberg matrix by the shifted QR algorithm with Wilkinson shifts
+inline auto hessenberg_eigen(matrix<complex> t)
+    -> std::pair<std::vector<complex>, matrix<complex>> {
+    const std::size_t m{t.number_of_rows()};
+    matrix<complex> z{utils::matrix::identity<complex>(m)};
+    const double eps{std::numeric_limits<double>::epsilon()};
+    double t_norm{0};
+    for (const auto& x : t) { t_norm = std::max(t_norm, std::abs(x)); }
+    std::size_t high{m > 0 ? m - 1 : 0};
+    std::size_t stagnation{0};
+    for (std::size_t iteration = 0; high > 0 && iteration < 100 * m;
+         iteration++) {
+        std::size_t low{high};
+        while (low > 0) {
+            double scale{std::abs(t[low - 1, low - 1]) + std::abs(t[low, low])};
+            if (scale == 0.0) { scale = t_norm; }
+            if (std::abs(t[low, low - 1]) <= eps * scale) { break; }
+            low--;
+        }
+        if (low > 0) { t[low, low - 1] = 0.0; }
+        if (low == high) {
+            high--;
+            stagnation = 0;
+            continue;
+        }
+        const complex a{t[high - 1, high - 1]};
+        const complex b{t[high - 1, high]};
+        const complex c{t[high, high - 1]};
+        const complex d{t[high, high]};
+        const complex half_trace{(a + d) / 2.0};
+        const complex root{
+            std::sqrt(half_trace * half_trace - (a * d - b * c))};
+        complex shift{std::abs(half_trace + root - d) <
+                              std::abs(half_trace - root - d)
+                          ? half_trace + root
+                          : half_trace - root};
+        if (++stagnation % 11 == 0) { shift = d + std::abs(c); }
+        shifted_qr_step(t, z, low, high, shift);
+    }
+    std::vector<complex> values(m);
+    for (std::size_t i = 0; i < m; i++) { values[i] = t[i, i]; }
+    matrix<complex> vectors{m, m, complex{0}};
+    const double smallest{std::max(eps * t_norm, 1e-300)};
+    for (std::size_t i = 0; i < m; i++) {
+        std::vector<complex> x(m, complex{0});
+        x[i] = 1.0;
+        for (std::size_t j = i; j-- > 0;) {
+            complex sum{0};
+            for (std::size_t k = j + 1; k <= i; k++) { sum += t[j, k] * x[k]; }
+            complex denominator{t[j, j] - t[i, i]};
+            if (std::abs(denominator) < smallest) { denominator = smallest; }
+            x[j] = -sum / denominator;
+        }
+        double length{0};
+        for (std::size_t row = 0; row < m; row++) {
+            complex value{0};
+            for (std::size_t k = 0; k <= i; k++) { value += z[row, k] * x[k]; }
+            vectors[row, i] = value;
+            length += std::norm(value);
+        }
+        length = std::sqrt(length);
+        for (std::size_t row = 0; row < m; row++) { vectors[row, i] /= length; }
+    }
+    return {values, vectors};
+}
+
+// size of the Krylov subspace, at least two more than the number of wanted
+// eigenpairs so that a restart always has something to filter out
+inline auto subspace_dimension(std::size_t requested,
+                               std::size_t n,
+                               std::size_t k) -> std::size_t {
+    const std::size_t m{requested != 0 ? requested
+                                       : std::max<std::size_t>(2 * k + 1, 20)};
+    return std::min(n, std::max(m, k + 2));
+}
+
+// orthonormalizes the columns of w in place (modified Gram-Schmidt with
+// reorthogonalization) and returns r, so that w_before = w * r. Dependent
+// columns are replaced by random directions orthogonal to previous blocks
+inline auto orthonormalize_block(matrix<double>& w,
+                                 const std::vector<matrix<double>>& previous,
+                                 std::mt19937_64& engine) -> matrix<double> {
+    const std::size_t n{w.number_of_rows()};
+    const std::size_t p{w.number_of_columns()};
+    matrix<double> r{p, p, 0.0};
+    const double scale{std::sqrt(scalar_of_m(w, w))};
+    const auto remove_column = [&w, n](const matrix<double>& q,
+                                       std::size_t q_column,
+                                       std::size_t column) {
+        double d{0};
+        for (std::size_t i = 0; i < n; i++) {
+            d += q[i, q_column] * w[i, column];
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            w[i, column] -= d * q[i, q_column];
+        }
+        return d;
+    };
+    const auto column_length = [&w, n](std::size_t column) {
+        double length{0};
+        for (std::size_t i = 0; i < n; i++) {
+            length += w[i, column] * w[i, column];
+        }
+        return std::sqrt(length);
+    };
+    std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+    for (std::size_t c = 0; c < p; c++) {
+        for (std::size_t pass = 0; pass < 2; pass++) {
+            for (std::size_t q = 0; q < c; q++) {
+                r[q, c] += remove_column(w, q, c);
+            }
+        }
+        double length{column_length(c)};
+        r[c, c] = length;
+        if (length <= std::numeric_limits<double>::epsilon() * scale) {
+            r[c, c] = 0.0;
+            for (std::size_t i = 0; i < n; i++) {
+                w[i, c] = distribution(engine);
+            }
+            for (std::size_t pass = 0; pass < 2; pass++) {
+                for (const auto& block : previous) {
+                    for (std::size_t q = 0; q < block.number_of_columns();
+                         q++) {
+                        remove_column(block, q, c);
+                    }
+                }
+                for (std::size_t q = 0; q < c; q++) { remove_column(w, q, c); }
+            }
+            length = column_length(c);
+        }
+        if (length == 0.0) { continue; }
+        for (std::size_t i = 0; i < n; i++) { w[i, c] /= length; }
+    }
+    return r;
+}
+
+inline auto check_relative_tolerance(const matrix<double>& v1,
+                                     const matrix<double>& v2,
+                                     double relative_tolerance) -> bool {
+    assert(v1.number_of_columns() == 1 && v1.shape() == v2.shape());
+    double largest{0};
+    double difference{0};
+    for (std::size_t i = 0; i < v1.number_of_rows(); i++) {
+        largest = std::max(largest, std::abs(v1[i, 0]));
+        difference = std::max(
+            difference, std::abs(std::abs(v1[i, 0]) - std::abs(v2[i, 0])));
+    }
+    return difference <= relative_tolerance * largest;
+}
+
 export namespace eigen {
 
+    /*settings shared by the Krylov subspace solvers. A subspace_dimension of
+     * 0 selects max(2k + 1, 20). A Ritz pair is accepted when its residual
+     * norm is at most tolerance * max(|eigenvalue|, estimated norm of the
+     * matrix), so eigenvalues near zero converge as well*/
+    struct krylov_settings {
+        std::size_t subspace_dimension{0};
+        std::size_t max_restarts{500};
+        double tolerance{1e-10};
+        std::uint64_t seed{2024};
+    };
+
+    /*eigenvalues and eigenvectors returned by the Krylov solvers, the i-th
+     * column of vectors belongs to values[i]*/
+    template <typename V>
+    struct eigenpairs {
+        std::vector<V> values;
+        matrix<V> vectors;
+        std::size_t restarts{0};
+        bool converged{false};
+    };
+
+    template <typename F>
+    concept vector_operator =
+        std::regular_invocable<F, const std::vector<double>&> &&
+        std::convertible_to<std::invoke_result_t<F, const std::vector<double>&>,
+                            std::vector<double>>;
+
+    template <typename F>
+    concept block_operator =
+        std::regular_invocable<F, const matrix<double>&> &&
+        std::convertible_to<std::invoke_result_t<F, const matrix<double>&>,
+                            matrix<double>>;
+
+    /*wraps a dense matrix into a matrix-vector product callback, m must
+     * outlive the returned operator*/
+    template <typename T>
+    inline auto dense_operator(const matrix<T>& m) {
+        return [&m](const std::vector<double>& x) {
+            std::vector<double> y(m.number_of_rows(), 0.0);
+            for (std::size_t i = 0; i < m.number_of_rows(); i++) {
+                for (std::size_t j = 0; j < m.number_of_columns(); j++) {
+                    y[i] += static_cast<double>(m[i, j]) * x[j];
+                }
+            }
+            return y;
+        };
+    }
+
+    /*wraps a dense matrix into a callback multiplying it by a block of
+     * vectors (GEMM), m must outlive the returned operator*/
+    inline auto dense_block_operator(const matrix<double>& m) {
+        return [&m](const matrix<double>& block) { return gemm(m, block); };
+    }
+
+
+    /*dominant eigenvector, iterates until the largest change of a coordinate
+     * is at most relative_tolerance times the largest coordinate or
+     * max_iterations is reached*/
     template <typename T>
-    inline auto power_method(matrix<T> m) {
+    inline auto power_method(matrix<T> m,
+                             std::size_t max_iterations = 10'000,
+                             double relative_tolerance = 1e-10) {
         static_assert(std::is_same_v<double, T>);
         matrix<T> b_k{m.number_of_rows(), 1, 1};
-        while (!check_tolerance(normalize_v(m_by_v(m, b_k)), b_k)) {
-            b_k = normalize_v(m_by_v(m, b_k));
+        for (std::size_t iteration = 0; iteration < max_iterations;
+             iteration++) {
+            matrix<T> next{normalize_v(m_by_v(m, b_k))};
+            const bool converged{
+                check_relative_tolerance(next, b_k, relative_tolerance)};
+            b_k = next;
+            if (converged) { break; }
         }
         return b_k;
     }
@@ -322,4 +858,316 @@ export namespace eigen {
         while (!almost_diagonal(m)) { m = rotation_matrix(m); }
         return vector_from_diagonal(m);
     }
+
+    /*top-k eigenpairs (largest eigenvalues first) of a symmetric operator
+     * of size n given only by its matrix-vector product. Thick restarted
+     * Lanczos with full reorthogonalization, which is equivalent to implicit
+     * restarts with exact shifts but keeps the projected matrix symmetric*/
+    template <vector_operator Operator>
+    inline auto lanczos(Operator&& apply,
+                        std::size_t n,
+                        std::size_t k,
+                        krylov_settings settings = {}) -> eigenpairs<double> {
+        assert(k > 0 && k <= n);
+        const std::size_t m{
+            subspace_dimension(settings.subspace_dimension, n, k)};
+        std::mt19937_64 engine{settings.seed};
+        std::vector<std::vector<double>> basis(m + 1);
+        matrix<double> h{m, m, 0.0};
+        next_basis_vector(basis, 0, random_vector(n, engine), 1.0, engine);
+        double beta{0};
+        double scale{0};
+        std::size_t first{0};
+        for (std::size_t restart = 0;; restart++) {
+            for (std::size_t j = first; j < m; j++) {
+                std::vector<double> w = apply(basis[j]);
+                scale = std::max(scale, norm(w));
+                orthogonalize(basis, j + 1, w, h, j);
+                beta = next_basis_vector(
+                    basis, j + 1, std::move(w), scale, engine);
+                if (j + 1 < m) { h[j + 1, j] = beta; }
+            }
+            matrix<double> projected{h};
+            for (std::size_t i = 0; i < m; i++) {
+                for (std::size_t j = i + 1; j < m; j++) {
+                    projected[j, i] = projected[i, j];
+                }
+            }
+            const auto [theta, y] = symmetric_eigen(projected);
+            std::vector<std::size_t> order(m);
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::sort(order, [&theta](auto a, auto b) {
+                return theta[a] > theta[b];
+            });
+            bool converged{true};
+            for (std::size_t i = 0; i < k; i++) {
+                const double residual{std::abs(beta * y[m - 1, order[i]])};
+                converged = converged &&
+                            residual <= settings.tolerance *
+                                            std::max(std::abs(theta[order[i]]),
+                                                     scale);
+            }
+            if (converged || restart >= settings.max_restarts || m == n) {
+                std::vector<double> values(k);
+                matrix<double> vectors{n, k, 0.0};
+                for (std::size_t i = 0; i < k; i++) {
+                    values[i] = theta[order[i]];
+                    for (std::size_t j = 0; j < m; j++) {
+                        for (std::size_t row = 0; row < n; row++) {
+                            vectors[row, i] += basis[j][row] * y[j, order[i]];
+                        }
+                    }
+                }
+                return {values, vectors, restart, converged || m == n};
+            }
+            const std::size_t keep{std::min(k + (m - k) / 2, m - 1)};
+            std::vector<std::vector<double>> ritz(keep,
+                                                  std::vector<double>(n, 0.0));
+            for (std::size_t i = 0; i < keep; i++) {
+                for (std::size_t j = 0; j < m; j++) {
+                    axpy(y[j, order[i]], basis[j], ritz[i]);
+                }
+            }
+            h = matrix<double>{m, m, 0.0};
+            for (std::size_t i = 0; i < keep; i++) {
+                basis[i] = std::move(ritz[i]);
+                h[i, i] = theta[order[i]];
+            }
+            basis[keep] = std::move(basis[m]);
+            first = keep;
+        }
+    }
+
+    /*top-k eigenpairs (largest magnitude first) of a general real operator
+     * of size n given only by its matrix-vector product. Implicitly restarted
+     * Arnoldi, the unwanted Ritz values are used as exact shifts and complex
+     * conjugate pairs are never split, a pair is applied as a real double
+     * shift step so the basis and the projected matrix stay real. Eigenpairs
+     * may be complex*/
+    template <vector_operator Operator>
+    inline auto arnoldi(Operator&& apply,
+                        std::size_t n,
+                        std::size_t k,
+                        krylov_settings settings = {})
+        -> eigenpairs<std::complex<double>> {
+        assert(k > 0 && k <= n);
+        const std::size_t m{
+            subspace_dimension(settings.subspace_dimension, n, k)};
+        std::mt19937_64 engine{settings.seed};
+        std::vector<std::vector<double>> basis(m + 1);
+        matrix<double> h{m, m, 0.0};
+        next_basis_vector(basis, 0, random_vector(n, engine), 1.0, engine);
+        double beta{0};
+        double scale{0};
+        std::size_t first{0};
+        for (std::size_t restart = 0;; restart++) {
+            for (std::size_t j = first; j < m; j++) {
+                std::vector<double> w = apply(basis[j]);
+                scale = std::max(scale, norm(w));
+                orthogonalize(basis, j + 1, w, h, j);
+                beta = next_basis_vector(
+                    basis, j + 1, std::move(w), scale, engine);
+                if (j + 1 < m) { h[j + 1, j] = beta; }
+            }
+            matrix<complex> hc{m, m, complex{0}};
+            for (std::size_t i = 0; i < m; i++) {
+                for (std::size_t j = 0; j < m; j++) { hc[i, j] = h[i, j]; }
+            }
+            const auto [theta, y] = hessenberg_eigen(hc);
+            std::vector<std::size_t> order(m);
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::sort(order, [&theta](auto a, auto b) {
+                return std::abs(theta[a]) > std::abs(theta[b]);
+            });
+            // conjugate pairs are listed with the positive imaginary part first
+            for (std::size_t i = 0; i + 1 < m; i++) {
+                const complex a{theta[order[i]]};
+                const complex b{theta[order[i + 1]]};
+                if (a.imag() < 0 && std::abs(a - std::conj(b)) <=
+                                        1e-8 * std::max(std::abs(a), 1.0)) {
+                    std::swap(order[i], order[i + 1]);
+                }
+            }
+            bool converged{true};
+            for (std::size_t i = 0; i < k; i++) {
+                const double residual{std::abs(beta * y[m - 1, order[i]])};
+                converged = converged &&
+                            residual <= settings.tolerance *
+                                            std::max(std::abs(theta[order[i]]),
+                                                     scale);
+            }
+            if (converged || restart >= settings.max_restarts || m == n) {
+                std::vector<complex> values(k);
+                matrix<complex> vectors{n, k, complex{0}};
+                for (std::size_t i = 0; i < k; i++) {
+                    values[i] = theta[order[i]];
+                    for (std::size_t j = 0; j < m; j++) {
+                        for (std::size_t row = 0; row < n; row++) {
+                            vectors[row, i] += basis[j][row] * y[j, order[i]];
+                        }
+                    }
+                }
+                return {values, vectors, restart, converged || m == n};
+            }
+            std::size_t keep{std::min(k + (m - k) / 2, m - 2)};
+            const complex last_kept{theta[order[keep - 1]]};
+            const double pair_tolerance{1e-8 *
+                                        std::max(std::abs(last_kept), 1.0)};
+            if (std::abs(last_kept.imag()) > pair_tolerance &&
+                std::abs(theta[order[keep]] - std::conj(last_kept)) <=
+                    pair_tolerance) {
+                keep++;
+            }
+            // a conjugate pair of unwanted Ritz values is applied as one
+            // real double shift step, its member with the negative imaginary
+            // part is skipped, real ones as single shifts
+            matrix<double> shifted{h};
+            matrix<double> q{utils::matrix::identity<double>(m)};
+            for (std::size_t i = keep; i < m; i++) {
+                const complex mu{theta[order[i]]};
+                const double imaginary{1e-8 * std::max(std::abs(mu), 1.0)};
+                if (mu.imag() > imaginary) {
+                    double_shift_qr_step(
+                        shifted, q, 2 * mu.real(), std::norm(mu));
+                } else if (mu.imag() >= -imaginary) {
+                    shifted_qr_step(shifted, q, mu.real());
+                }
+            }
+            std::vector<double> residual(n, 0.0);
+            std::vector<std::vector<double>> kept(keep,
+                                                  std::vector<double>(n, 0.0));
+            for (std::size_t j = 0; j < m; j++) {
+                for (std::size_t i = 0; i < keep; i++) {
+                    axpy(q[j, i], basis[j], kept[i]);
+                }
+                axpy(q[j, keep] * shifted[keep, keep - 1], basis[j], residual);
+            }
+            axpy(beta * q[m - 1, keep - 1], basis[m], residual);
+            h = matrix<double>{m, m, 0.0};
+            for (std::size_t i = 0; i < keep; i++) {
+                basis[i] = std::move(kept[i]);
+                for (std::size_t j = 0; j < keep; j++) {
+                    h[i, j] = shifted[i, j];
+                }
+            }
+            matrix<double> ignored{keep, 1, 0.0};
+            orthogonalize(basis, keep, residual, ignored, 0);
+            h[keep, keep - 1] = next_basis_vector(
+                basis, keep, std::move(residual), scale, engine);
+            first = keep;
+        }
+    }
+
+    /*block variant of lanczos, the operator multiplies the symmetric matrix
+     * by a block of vectors (n x block size), so dense matrices go through a
+     * single GEMM per step and the orthogonalization is done block-wise with
+     * GEMM too. The block holds at least k vectors, n must be at least
+     * k + 2 * block. Restarts are thick, the best Ritz vectors are kept*/
+    template <block_operator Operator>
+    inline auto block_lanczos(Operator&& apply,
+                              std::size_t n,
+                              std::size_t k,
+                              std::size_t block_size,
+                              krylov_settings settings = {})
+        -> eigenpairs<double> {
+        const std::size_t p{std::max(block_size, k)};
+        assert(k > 0 && k + 2 * p <= n);
+        const std::size_t m{std::min(
+            n,
+            std::max(subspace_dimension(settings.subspace_dimension, n, k),
+                     k + 2 * p))};
+        std::mt19937_64 engine{settings.seed};
+        matrix<double> start{n, p, 0.0};
+        std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+        for (auto& x : start) { x = distribution(engine); }
+        orthonormalize_block(start, {}, engine);
+        std::vector<matrix<double>> blocks{start};
+        std::vector<std::size_t> offsets{0};
+        matrix<double> t{m + p, m + p, 0.0};
+        for (std::size_t restart = 0;; restart++) {
+            std::size_t columns{offsets.back() + p};
+            matrix<double> next{n, p, 0.0};
+            matrix<double> r{p, p, 0.0};
+            for (std::size_t j = blocks.size() - 1;; j++) {
+                matrix<double> w{apply(blocks[j])};
+                for (std::size_t pass = 0; pass < 2; pass++) {
+                    for (std::size_t i = 0; i <= j; i++) {
+                        const matrix<double> c{gemm_transposed(blocks[i], w)};
+                        w -= gemm(blocks[i], c);
+                        for (std::size_t a = 0; a < c.number_of_rows(); a++) {
+                            for (std::size_t b = 0; b < p; b++) {
+                                t[offsets[i] + a, offsets[j] + b] += c[a, b];
+                            }
+                        }
+                    }
+                }
+                r = orthonormalize_block(w, blocks, engine);
+                if (columns + p > m) {
+                    next = std::move(w);
+                    break;
+                }
+                blocks.push_back(std::move(w));
+                offsets.push_back(columns);
+                columns += p;
+            }
+            matrix<double> projected{columns, columns, 0.0};
+            for (std::size_t i = 0; i < columns; i++) {
+                for (std::size_t j = i; j < columns; j++) {
+                    projected[i, j] = t[i, j];
+                    projected[j, i] = t[i, j];
+                }
+            }
+            const auto [theta, y] = symmetric_eigen(projected);
+            std::vector<std::size_t> order(columns);
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::sort(order, [&theta](auto a, auto b) {
+                return theta[a] > theta[b];
+            });
+            // A * x_i - theta_i * x_i = next * r * (last rows of y_i), the
+            // extreme Ritz value estimates the norm of A
+            const double scale{std::max(std::abs(theta[order.front()]),
+                                        std::abs(theta[order.back()]))};
+            bool converged{true};
+            for (std::size_t i = 0; i < k; i++) {
+                double residual{0};
+                for (std::size_t a = 0; a < p; a++) {
+                    double entry{0};
+                    for (std::size_t b = 0; b < p; b++) {
+                        entry += r[a, b] * y[offsets.back() + b, order[i]];
+                    }
+                    residual += entry * entry;
+                }
+                converged = converged &&
+                            std::sqrt(residual) <=
+                                settings.tolerance *
+                                    std::max(std::abs(theta[order[i]]), scale);
+            }
+            const bool last{converged || restart >= settings.max_restarts};
+            const std::size_t keep{last ? k : std::min(k + (m - k) / 2, m - p)};
+            matrix<double> ritz{n, keep, 0.0};
+            for (std::size_t i = 0; i < blocks.size(); i++) {
+                const std::size_t width{blocks[i].number_of_columns()};
+                matrix<double> coefficients{width, keep, 0.0};
+                for (std::size_t a = 0; a < width; a++) {
+                    for (std::size_t b = 0; b < keep; b++) {
+                        coefficients[a, b] = y[offsets[i] + a, order[b]];
+                    }
+                }
+                ritz += gemm(blocks[i], coefficients);
+            }
+            if (last) {
+                std::vector<double> values(k);
+                for (std::size_t i = 0; i < k; i++) {
+                    values[i] = theta[order[i]];
+                }
+                return {values, ritz, restart, converged};
+            }
+            t = matrix<double>{m + p, m + p, 0.0};
+            for (std::size_t i = 0; i < keep; i++) {
+                t[i, i] = theta[order[i]];
+            }
+            blocks = {std::move(ritz), std::move(next)};
+            offsets = {0, keep};
+        }
+    }
 }  // namespace eigen
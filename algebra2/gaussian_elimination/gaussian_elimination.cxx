@@ -1,15 +1,21 @@
 module;
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <concepts>
 #include <cstdint>
 #include <expected>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <print>
+#include <span>
 #include <typeinfo>
 #include <utility>
 #include <vector>
 
+#include "lu.hpp"
+
 export module gaussian_elimination;
 
 import matrix;
@@ -66,7 +72,7 @@ export namespace utils::matrix {
             m.number_of_rows(), m.number_of_columns(), {0}};
         for (std::size_t i = 0; i < m.number_of_rows(); i++) {
             for (std::size_t j = 0; j < m.number_of_columns(); j++) {
-                converted_matrix[i, j] = fraction{m[i, j], 1};
+                converted_matrix[i, j] = fraction<int>{m[i, j], 1};
             }
         }
         return converted_matrix;
@@ -81,16 +87,13 @@ export namespace utils::matrix {
         if constexpr (check_fraction<std::ranges::range_value_t<R>>) {
             return m;
         } else {
-            to_fractions_helper(m);
+            return to_fractions_helper(m);
         }
     }
 
 
     enum class reducted_form : std::uint8_t { echelon, echelon_reduced };
-    enum class error : std::uint8_t {
-        not_invertible,
-        not_square,
-    };
+    using ::pivoted_lu::error;
 
 
     /*
@@ -112,7 +115,8 @@ export namespace utils::matrix {
 
     /*
         description:
-            helper function for gaussian_echelon function to swap rows
+            helper function for gaussian_echelon function, swaps row i with
+       the first row below it having a non-zero entry in column i
     */
     template <typename T>
     auto gaussian_echelon_swap(::matrix<T>& m,
@@ -125,11 +129,29 @@ export namespace utils::matrix {
                 result.reduction_steps.push_back(
                     std::format("swap R{} with R{}", j + 1, i + 1));
                 result.determinant_m *= -1;
+                return;
             }
         }
     }
 
 
+    /*
+        description:
+            subtracts factor * row_j from row_i with the batch operation of the
+       rational module, the rows of ::matrix are contiguous
+    */
+    template <typename T>
+    auto subtract_rows(::matrix<T>& m,
+                       std::size_t row_i,
+                       std::size_t row_j,
+                       T factor) {
+        const std::size_t cols{m.number_of_columns()};
+        subtract_multiple(std::span{&m[row_i, 0], cols},
+                          factor,
+                          std::span{&std::as_const(m)[row_j, 0], cols});
+    }
+
+
     /*
         description:
             helper function for gaussian_echelon function to subtract rows
@@ -143,7 +165,7 @@ export namespace utils::matrix {
         for (std::size_t k = i + 1; k < rows; k++) {
             factor = m[k, i] / m[i, i];
             if (factor.numerator != 0) {
-                subtract(m, k, i, factor);
+                subtract_rows(m, k, i, factor);
                 result.reduction_steps.push_back(
                     std::format("R{} - {} * R{}", k + 1, factor, i + 1));
             }
@@ -181,7 +203,7 @@ export namespace utils::matrix {
         for (std::size_t k = iterator + 1; k < rows; k++) {
             if (m[iterator, k].numerator != 0 && m[k, k].numerator != 0) {
                 factor = m[iterator, k] / m[k, k];
-                subtract(m, iterator, k, factor);
+                subtract_rows(m, iterator, k, factor);
                 result.reduction_steps.push_back(
                     std::format("R{} - {} * R{}", k + 1, factor, iterator + 1));
             }
@@ -341,3 +363,58 @@ export namespace utils::matrix {
         return std::unexpected(error::not_invertible);
     }
 }  // namespace utils::matrix
+
+
+namespace utils::matrix {
+
+    /*
+        description:
+            LU decomposition of floating point matrices with partial, scaled
+       partial, rook or complete pivoting, shared with the header only project
+       through lu.hpp
+    */
+    export using ::pivoted_lu::lu_decomposition;
+    export using ::pivoted_lu::lu_determinant;
+    export using ::pivoted_lu::lu_result;
+    export using ::pivoted_lu::lu_solve;
+    export using ::pivoted_lu::pivoting;
+}  // namespace utils::matrix
+
+
+export namespace utils::matrix {
+
+
+    /*
+        description:
+            inverse of m given its decomposition, solves for every column of
+       the identity
+    */
+    template <std::floating_point T>
+    auto lu_inverse(const lu_result<T>& f)
+        -> std::expected<::matrix<T>, error> {
+        const auto entries{::pivoted_lu::lu_inverse_entries(f)};
+        if (!entries) { return std::unexpected(entries.error()); }
+        const std::size_t n{f.row_permutation.size()};
+        ::matrix<T> inverse_matrix{n, n, T{0}};
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                inverse_matrix[i, j] = (*entries)[(i * n) + j];
+            }
+        }
+        return inverse_matrix;
+    }
+
+
+    /*
+        description:
+            inverse of a square floating point matrix m
+    */
+    template <std::floating_point T>
+    auto lu_inverse(const ::matrix<T>& m,
+                    pivoting strategy = pivoting::partial)
+        -> std::expected<::matrix<T>, error> {
+        const auto f{lu_decomposition(m, strategy)};
+        if (!f) { return std::unexpected(f.error()); }
+        return lu_inverse(*f);
+    }
+}  // namespace utils::matrix
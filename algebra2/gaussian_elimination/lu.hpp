@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace pivoted_lu {
+
+    enum class error : std::uint8_t {
+        not_invertible,
+        not_square,
+    };
+
+
+    /*
+        description:
+            pivot search of lu_decomposition. partial takes the largest entry
+       of the column, scaled_partial compares the entries divided by the
+       largest entry of their row, rook alternates column and row searches
+       until the entry is the largest one in both, complete searches the whole
+       remaining submatrix
+    */
+    enum class pivoting : std::uint8_t {
+        partial,
+        scaled_partial,
+        rook,
+        complete
+    };
+
+
+    /*
+        description:
+            result of lu_decomposition, P * m * Q = L * U. factors holds the
+       matrix row by row and its rows and columns are never swapped, the k-th
+       pivot row is row_permutation[k] and the k-th pivot column is
+       column_permutation[k]. L has a unit diagonal and is stored below it, U
+       on and above it. sign is the parity of P and Q, rank is the number of
+       pivots larger than the zero tolerance
+    */
+    template <std::floating_point T>
+    struct lu_result {
+        std::vector<T> factors;
+        std::vector<std::size_t> row_permutation;
+        std::vector<std::size_t> column_permutation;
+        int sign{1};
+        std::size_t rank{0};
+
+        // entry (i, j) of the permuted matrix holding L and U
+        auto operator[](std::size_t i, std::size_t j) const -> T {
+            return factors[(row_permutation[i] * row_permutation.size()) +
+                           column_permutation[j]];
+        }
+    };
+
+
+    /*
+        description:
+            floating point matrix read by lu_decomposition, the matrix of the
+       matrix module and the matrix_view of the header only project alike
+    */
+    template <typename M>
+    concept dense_matrix = requires(const M& m) {
+        { m.number_of_rows() } -> std::convertible_to<std::size_t>;
+        { m.number_of_columns() } -> std::convertible_to<std::size_t>;
+        requires std::floating_point<
+            std::remove_cvref_t<decltype(m[0zU, 0zU])>>;
+    };
+
+    template <dense_matrix M>
+    using entry_t =
+        std::remove_cvref_t<decltype(std::declval<const M&>()[0zU, 0zU])>;
+}  // namespace pivoted_lu
+
+
+namespace pivoted_lu_detail {
+
+    using pivoted_lu::lu_result;
+    using pivoted_lu::pivoting;
+
+
+    template <typename T>
+    auto magnitude(const lu_result<T>& f, std::size_t i, std::size_t j) -> T {
+        return std::abs(f[i, j]);
+    }
+
+
+    // position of the largest |f[i, j]| / scale over the rows i >= k
+    template <typename T>
+    auto column_pivot(const lu_result<T>& f,
+                      std::size_t k,
+                      std::size_t j,
+                      const std::vector<T>& scale) -> std::size_t {
+        std::size_t best{k};
+        T best_value{-1};
+        for (std::size_t i = k; i < f.row_permutation.size(); i++) {
+            const T value{magnitude(f, i, j) / scale[f.row_permutation[i]]};
+            if (value > best_value) {
+                best = i;
+                best_value = value;
+            }
+        }
+        return best;
+    }
+
+
+    // position of the largest |f[i, j]| over the columns j >= k
+    template <typename T>
+    auto row_pivot(const lu_result<T>& f, std::size_t k, std::size_t i)
+        -> std::size_t {
+        std::size_t best{k};
+        for (std::size_t j = k + 1; j < f.column_permutation.size(); j++) {
+            if (magnitude(f, i, j) > magnitude(f, i, best)) { best = j; }
+        }
+        return best;
+    }
+
+
+    template <typename T>
+    auto complete_pivot(const lu_result<T>& f, std::size_t k)
+        -> std::pair<std::size_t, std::size_t> {
+        std::pair<std::size_t, std::size_t> best{k, k};
+        for (std::size_t i = k; i < f.row_permutation.size(); i++) {
+            const std::size_t j{row_pivot(f, k, i)};
+            if (magnitude(f, i, j) > magnitude(f, best.first, best.second)) {
+                best = {i, j};
+            }
+        }
+        return best;
+    }
+
+
+    // every step strictly increases |f[i, j]|, so the search terminates
+    template <typename T>
+    auto rook_pivot(const lu_result<T>& f,
+                    std::size_t k,
+                    const std::vector<T>& scale)
+        -> std::pair<std::size_t, std::size_t> {
+        std::size_t i{column_pivot(f, k, k, scale)};
+        std::size_t j{k};
+        if (magnitude(f, i, j) == T{0}) { return complete_pivot(f, k); }
+        while (true) {
+            const std::size_t column{row_pivot(f, k, i)};
+            if (magnitude(f, i, column) <= magnitude(f, i, j)) { break; }
+            j = column;
+            const std::size_t row{column_pivot(f, k, j, scale)};
+            if (magnitude(f, row, j) <= magnitude(f, i, j)) { break; }
+            i = row;
+        }
+        return {i, j};
+    }
+
+
+    template <typename T>
+    auto find_pivot(const lu_result<T>& f,
+                    std::size_t k,
+                    pivoting strategy,
+                    const std::vector<T>& scale)
+        -> std::pair<std::size_t, std::size_t> {
+        switch (strategy) {
+            case pivoting::rook: return rook_pivot(f, k, scale);
+            case pivoting::complete: return complete_pivot(f, k);
+            default: return {column_pivot(f, k, k, scale), k};
+        }
+    }
+
+
+    // largest entry of every row for scaled_partial, ones otherwise
+    template <typename T>
+    auto row_scales(const std::vector<T>& values,
+                    std::size_t n,
+                    pivoting strategy) -> std::vector<T> {
+        std::vector<T> scale(n, T{1});
+        if (strategy != pivoting::scaled_partial) { return scale; }
+        for (std::size_t i = 0; i < n; i++) {
+            T largest{0};
+            for (std::size_t j = 0; j < n; j++) {
+                largest = std::max(largest, std::abs(values[(i * n) + j]));
+            }
+            if (largest > T{0}) { scale[i] = largest; }
+        }
+        return scale;
+    }
+
+
+    // pivots not larger than n * epsilon * max |m[i, j]| are treated as zero
+    template <typename T>
+    auto zero_tolerance(const std::vector<T>& values, std::size_t n) -> T {
+        T largest{0};
+        for (const T& value : values) {
+            largest = std::max(largest, std::abs(value));
+        }
+        return static_cast<T>(n) *
+               std::numeric_limits<T>::epsilon() * largest;
+    }
+
+
+    /*subtracts multiples of the k-th pivot row from the rows below it. The
+     * rows are addressed through row_permutation, the columns are contiguous
+     * unless rook or complete pivoting permuted them*/
+    template <typename T>
+    auto eliminate(lu_result<T>& f, std::size_t k, bool columns_permuted) {
+        const std::size_t n{f.row_permutation.size()};
+        const std::size_t pivot_column{f.column_permutation[k]};
+        const T* const pivot_row{&f.factors[f.row_permutation[k] * n]};
+        for (std::size_t i = k + 1; i < n; i++) {
+            T* const row{&f.factors[f.row_permutation[i] * n]};
+            const T l{row[pivot_column] / pivot_row[pivot_column]};
+            row[pivot_column] = l;
+            if (l == T{0}) { continue; }
+            if (columns_permuted) {
+                for (std::size_t j = k + 1; j < n; j++) {
+                    const std::size_t column{f.column_permutation[j]};
+                    row[column] -= l * pivot_row[column];
+                }
+            } else {
+                for (std::size_t j = k + 1; j < n; j++) {
+                    row[j] -= l * pivot_row[j];
+                }
+            }
+        }
+    }
+}  // namespace pivoted_lu_detail
+
+
+namespace pivoted_lu {
+
+    /*
+        description:
+            LU decomposition of a square floating point matrix with the given
+       pivoting. Works directly on doubles, without the conversion to fractions
+       done by gaussian_elimiantion_alg
+    */
+    template <dense_matrix M>
+    auto lu_decomposition(const M& m, pivoting strategy = pivoting::partial)
+        -> std::expected<lu_result<entry_t<M>>, error> {
+        using T = entry_t<M>;
+        namespace detail = pivoted_lu_detail;
+        const std::size_t n{m.number_of_rows()};
+        if (n != m.number_of_columns()) {
+            return std::unexpected(error::not_square);
+        }
+        std::vector<std::size_t> permutation(n);
+        std::iota(permutation.begin(), permutation.end(), 0zU);
+        std::vector<T> values(n * n);
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                values[(i * n) + j] = m[i, j];
+            }
+        }
+        const T tolerance{detail::zero_tolerance(values, n)};
+        const std::vector<T> scale{detail::row_scales(values, n, strategy)};
+        lu_result<T> f{std::move(values), permutation, permutation};
+        const bool columns_permuted{strategy == pivoting::rook ||
+                                    strategy == pivoting::complete};
+        for (std::size_t k = 0; k < n; k++) {
+            const auto [i, j] = detail::find_pivot(f, k, strategy, scale);
+            if (i != k) {
+                std::swap(f.row_permutation[i], f.row_permutation[k]);
+                f.sign = -f.sign;
+            }
+            if (j != k) {
+                std::swap(f.column_permutation[j], f.column_permutation[k]);
+                f.sign = -f.sign;
+            }
+            if (std::abs(f[k, k]) <= tolerance) {
+                // with rook or complete pivoting the rest is negligible
+                if (columns_permuted) { break; }
+                continue;
+            }
+            f.rank++;
+            detail::eliminate(f, k, columns_permuted);
+        }
+        return f;
+    }
+
+
+    /*
+        description:
+            solves m * x = b given the decomposition of m
+    */
+    template <std::floating_point T>
+    auto lu_solve(const lu_result<T>& f, const std::vector<T>& b)
+        -> std::expected<std::vector<T>, error> {
+        const std::size_t n{f.row_permutation.size()};
+        assert(b.size() == n);
+        if (f.rank < n) { return std::unexpected(error::not_invertible); }
+        std::vector<T> y(n);
+        for (std::size_t i = 0; i < n; i++) {
+            T sum{b[f.row_permutation[i]]};
+            for (std::size_t j = 0; j < i; j++) { sum -= f[i, j] * y[j]; }
+            y[i] = sum;
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            T sum{y[i]};
+            for (std::size_t j = i + 1; j < n; j++) { sum -= f[i, j] * y[j]; }
+            y[i] = sum / f[i, i];
+        }
+        std::vector<T> x(n);
+        for (std::size_t i = 0; i < n; i++) {
+            x[f.column_permutation[i]] = y[i];
+        }
+        return x;
+    }
+
+
+    /*
+        description:
+            determinant of m given its decomposition
+    */
+    template <std::floating_point T>
+    auto lu_determinant(const lu_result<T>& f) -> T {
+        const std::size_t n{f.row_permutation.size()};
+        if (f.rank < n) { return T{0}; }
+        T determinant{static_cast<T>(f.sign)};
+        for (std::size_t i = 0; i < n; i++) { determinant *= f[i, i]; }
+        return determinant;
+    }
+
+
+    /*
+        description:
+            determinant of a square floating point matrix m
+    */
+    template <dense_matrix M>
+    auto lu_determinant(const M& m, pivoting strategy = pivoting::partial)
+        -> std::expected<entry_t<M>, error> {
+        const auto f{lu_decomposition(m, strategy)};
+        if (!f) { return std::unexpected(f.error()); }
+        return lu_determinant(*f);
+    }
+
+
+    /*
+        description:
+            entries of the inverse of m row by row given the decomposition of
+       m, solves for every column of the identity. The matrix and header only
+       projects wrap them in their own matrix type
+    */
+    template <std::floating_point T>
+    auto lu_inverse_entries(const lu_result<T>& f)
+        -> std::expected<std::vector<T>, error> {
+        const std::size_t n{f.row_permutation.size()};
+        if (f.rank < n) { return std::unexpected(error::not_invertible); }
+        std::vector<T> entries(n * n, T{0});
+        std::vector<T> unit(n, T{0});
+        for (std::size_t j = 0; j < n; j++) {
+            unit[j] = T{1};
+            const std::vector<T> column{lu_solve(f, unit).value()};
+            for (std::size_t i = 0; i < n; i++) {
+                entries[(i * n) + j] = column[i];
+            }
+            unit[j] = T{0};
+        }
+        return entries;
+    }
+}  // namespace pivoted_lu
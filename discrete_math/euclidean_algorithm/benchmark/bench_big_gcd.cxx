@@ -0,0 +1,124 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../big_integer.hpp"
+#include "benchmark.hpp"
+
+
+namespace {
+
+    // the plain quotient loop is quadratic with a large constant, it is
+    // skipped for the longest inputs
+    constexpr std::size_t euclid_cap{16'000};
+    constexpr std::array bit_lengths{std::size_t{1'000},
+                                     std::size_t{4'000},
+                                     std::size_t{16'000},
+                                     std::size_t{64'000},
+                                     std::size_t{100'000}};
+
+    struct options {
+        benchmark::settings settings{.min_size = 1'000,
+                                     .max_size = 100'000};
+        std::string csv{};
+    };
+
+    auto run(std::string_view kernel,
+             algorithms::big_gcd::method method,
+             const algorithms::big_integer& a,
+             const algorithms::big_integer& b,
+             std::size_t bits,
+             const benchmark::settings& s,
+             std::vector<benchmark::record>& records) -> void {
+        if (!benchmark::selected(s, kernel)) { return; }
+        records.push_back(
+            benchmark::measure(kernel, "big_integer", bits, 0, s, [&] {
+                auto result{algorithms::big_gcd::solve(a, b, method)};
+                benchmark::keep(result);
+            }));
+    }
+
+    // one pair of random numbers of the given number of bits per size, the
+    // same pair for all three methods
+    auto gcd_benchmarks(const benchmark::settings& s,
+                        std::vector<benchmark::record>& records) -> void {
+        using algorithms::big_gcd::method;
+        std::mt19937_64 engine{1};
+        for (const std::size_t bits : bit_lengths) {
+            const auto a{algorithms::random_big_integer(bits, engine)};
+            const auto b{algorithms::random_big_integer(bits, engine)};
+            if (bits < s.min_size || bits > s.max_size) { continue; }
+            if (bits <= euclid_cap) {
+                run("big_gcd::euclid", method::euclid, a, b, bits, s, records);
+            }
+            run("big_gcd::lehmer", method::lehmer, a, b, bits, s, records);
+            run("big_gcd::half_gcd", method::half_gcd, a, b, bits, s, records);
+        }
+    }
+
+    auto parse(int argc, char** argv) -> std::optional<options> {
+        options result{};
+        const std::vector<std::string_view> args(argv + 1, argv + argc);
+        for (std::size_t i = 0; i < args.size(); i++) {
+            const bool has_value{i + 1 < args.size()};
+            if (args[i] == "--help" || !has_value) { return std::nullopt; }
+            const std::string value{args[++i]};
+            if (args[i - 1] == "--min-size") {
+                result.settings.min_size = std::stoul(value);
+            } else if (args[i - 1] == "--max-size") {
+                result.settings.max_size = std::stoul(value);
+            } else if (args[i - 1] == "--min-time") {
+                result.settings.min_time =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>{std::stod(value)});
+            } else if (args[i - 1] == "--filter") {
+                result.settings.filter = value;
+            } else if (args[i - 1] == "--csv") {
+                result.csv = value;
+            } else {
+                return std::nullopt;
+            }
+        }
+        return result;
+    }
+
+    auto usage() -> void {
+        std::println(
+            "usage: bench_big_gcd [--min-size BITS] [--max-size BITS] "
+            "[--min-time SECONDS] [--filter KERNEL] [--csv FILE]");
+    }
+
+}  // namespace
+
+
+auto main(int argc, char** argv) -> int {
+    const auto parsed{parse(argc, argv)};
+    if (!parsed) {
+        usage();
+        return 2;
+    }
+    const options& o{*parsed};
+    std::vector<benchmark::record> records{};
+    gcd_benchmarks(o.settings, records);
+
+    std::println("{:<18} {:>8} {:>14} {:>10}",
+                 "kernel",
+                 "bits",
+                 "ms/op",
+                 "allocs/op");
+    for (const auto& r : records) {
+        std::println("{:<18} {:>8} {:>14.3f} {:>10.1f}",
+                     r.kernel,
+                     r.size,
+                     r.ns_per_op / 1e6,
+                     r.allocations_per_op);
+    }
+    if (!o.csv.empty()) { benchmark::write_csv(records, o.csv); }
+    return 0;
+}
@@ -0,0 +1,654 @@
+#pragma once
+//libraries
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "euclidean.hpp"
+
+namespace algorithms
+{
+	// Magnitudes stored as little endian sequences of 32 bit limbs, without leading zero limbs
+	namespace limbs
+	{
+		using digits = std::vector<std::uint32_t>;
+		using view = std::span<const std::uint32_t>;
+
+		// From this many limbs of the shorter factor on multiplication uses Karatsuba
+		inline constexpr std::size_t karatsuba_threshold = 32;
+
+		inline void trim(digits& a)
+		{
+			while (!a.empty() && a.back() == 0)
+			{
+				a.pop_back();
+			}
+		}
+
+		inline auto trimmed(view a) -> view
+		{
+			while (!a.empty() && a.back() == 0)
+			{
+				a = a.first(a.size() - 1);
+			}
+			return a;
+		}
+
+		inline auto compare(view a, view b) -> std::strong_ordering
+		{
+			a = trimmed(a);
+			b = trimmed(b);
+			if (a.size() != b.size())
+			{
+				return a.size() <=> b.size();
+			}
+			for (std::size_t i = a.size(); i > 0; --i)
+			{
+				if (a[i - 1] != b[i - 1])
+				{
+					return a[i - 1] <=> b[i - 1];
+				}
+			}
+			return std::strong_ordering::equal;
+		}
+
+		inline auto bit_length(view a) -> std::size_t
+		{
+			a = trimmed(a);
+			return a.empty() ? 0 : 32 * a.size() - static_cast<std::size_t>(std::countl_zero(a.back()));
+		}
+
+		// r += a * 2^(32 offset), r has to be long enough for the carry
+		inline void add_to(digits& r, view a, std::size_t offset = 0)
+		{
+			std::uint64_t carry = 0;
+			std::size_t i = 0;
+			for (; i < a.size(); ++i)
+			{
+				carry += static_cast<std::uint64_t>(r[offset + i]) + a[i];
+				r[offset + i] = static_cast<std::uint32_t>(carry);
+				carry >>= 32;
+			}
+			for (; carry != 0; ++i)
+			{
+				carry += r[offset + i];
+				r[offset + i] = static_cast<std::uint32_t>(carry);
+				carry >>= 32;
+			}
+		}
+
+		// r -= a * 2^(32 offset), requires r >= a * 2^(32 offset)
+		inline void subtract_from(digits& r, view a, std::size_t offset = 0)
+		{
+			std::int64_t borrow = 0;
+			std::size_t i = 0;
+			for (; i < a.size(); ++i)
+			{
+				std::int64_t t = static_cast<std::int64_t>(r[offset + i]) - a[i] - borrow;
+				borrow = t < 0;
+				r[offset + i] = static_cast<std::uint32_t>(t);
+			}
+			for (; borrow != 0; ++i)
+			{
+				borrow = r[offset + i] == 0;
+				--r[offset + i];
+			}
+		}
+
+		inline auto add(view a, view b) -> digits
+		{
+			if (a.size() < b.size())
+			{
+				std::swap(a, b);
+			}
+			digits r(a.begin(), a.end());
+			r.push_back(0);
+			add_to(r, b);
+			trim(r);
+			return r;
+		}
+
+		// a - b for a >= b
+		inline auto subtract(view a, view b) -> digits
+		{
+			digits r(a.begin(), a.end());
+			subtract_from(r, trimmed(b));
+			trim(r);
+			return r;
+		}
+
+		inline auto schoolbook(view a, view b) -> digits
+		{
+			digits r(a.size() + b.size(), 0);
+			for (std::size_t i = 0; i < a.size(); ++i)
+			{
+				std::uint64_t carry = 0;
+				for (std::size_t j = 0; j < b.size(); ++j)
+				{
+					carry += static_cast<std::uint64_t>(a[i]) * b[j] + r[i + j];
+					r[i + j] = static_cast<std::uint32_t>(carry);
+					carry >>= 32;
+				}
+				r[i + b.size()] = static_cast<std::uint32_t>(carry);
+			}
+			return r;
+		}
+
+		// Product of the magnitudes, Karatsuba splits the longer factor in halves
+		inline auto multiply(view a, view b) -> digits
+		{
+			a = trimmed(a);
+			b = trimmed(b);
+			if (a.size() < b.size())
+			{
+				std::swap(a, b);
+			}
+			if (b.empty())
+			{
+				return {};
+			}
+			if (b.size() < karatsuba_threshold)
+			{
+				auto r = schoolbook(a, b);
+				trim(r);
+				return r;
+			}
+			const std::size_t half = a.size() / 2;
+			const view a0 = a.first(half), a1 = a.subspan(half);
+			digits r(a.size() + b.size() + 1, 0);
+			if (b.size() <= half)
+			{
+				add_to(r, multiply(a0, b));
+				add_to(r, multiply(a1, b), half);
+			}
+			else
+			{
+				const view b0 = b.first(half), b1 = b.subspan(half);
+				const auto low = multiply(a0, b0);
+				const auto high = multiply(a1, b1);
+				auto middle = multiply(add(a0, a1), add(b0, b1));
+				middle.push_back(0);
+				subtract_from(middle, low);
+				subtract_from(middle, high);
+				add_to(r, low);
+				add_to(r, trimmed(middle), half);
+				add_to(r, high, 2 * half);
+			}
+			trim(r);
+			return r;
+		}
+
+		inline auto shift_left(view a, std::size_t bits) -> digits
+		{
+			a = trimmed(a);
+			if (a.empty())
+			{
+				return {};
+			}
+			const std::size_t words = bits / 32, rest = bits % 32;
+			digits r(a.size() + words + 1, 0);
+			for (std::size_t i = 0; i < a.size(); ++i)
+			{
+				const std::uint64_t shifted = static_cast<std::uint64_t>(a[i]) << rest;
+				r[i + words] |= static_cast<std::uint32_t>(shifted);
+				r[i + words + 1] |= static_cast<std::uint32_t>(shifted >> 32);
+			}
+			trim(r);
+			return r;
+		}
+
+		inline auto shift_right(view a, std::size_t bits) -> digits
+		{
+			a = trimmed(a);
+			const std::size_t words = bits / 32, rest = bits % 32;
+			if (words >= a.size())
+			{
+				return {};
+			}
+			digits r(a.size() - words, 0);
+			for (std::size_t i = 0; i < r.size(); ++i)
+			{
+				std::uint64_t window = a[i + words];
+				if (i + words + 1 < a.size())
+				{
+					window |= static_cast<std::uint64_t>(a[i + words + 1]) << 32;
+				}
+				r[i] = static_cast<std::uint32_t>(window >> rest);
+			}
+			trim(r);
+			return r;
+		}
+
+		// floor(a / 2^bits) for a result below 2^64
+		inline auto top(view a, std::size_t bits) -> std::uint64_t
+		{
+			const auto shifted = shift_right(a, bits);
+			std::uint64_t r = 0;
+			for (std::size_t i = std::min<std::size_t>(shifted.size(), 2); i > 0; --i)
+			{
+				r = (r << 32) | shifted[i - 1];
+			}
+			return r;
+		}
+
+		// Quotient and remainder by Knuth's algorithm D, b is not zero
+		inline auto divide(view a, view b) -> std::pair<digits, digits>
+		{
+			a = trimmed(a);
+			b = trimmed(b);
+			if (compare(a, b) < 0)
+			{
+				return { {}, digits(a.begin(), a.end()) };
+			}
+			const std::size_t n = b.size(), m = a.size();
+			if (n == 1)
+			{
+				digits q(m, 0);
+				std::uint64_t rest = 0;
+				for (std::size_t i = m; i > 0; --i)
+				{
+					const std::uint64_t current = (rest << 32) | a[i - 1];
+					q[i - 1] = static_cast<std::uint32_t>(current / b[0]);
+					rest = current % b[0];
+				}
+				trim(q);
+				digits r{ static_cast<std::uint32_t>(rest) };
+				trim(r);
+				return { q, r };
+			}
+			const auto s = static_cast<std::size_t>(std::countl_zero(b.back()));
+			digits v = shift_left(b, s);
+			digits u = shift_left(a, s);
+			u.resize(m + 1, 0);
+			digits q(m - n + 1, 0);
+			constexpr std::uint64_t base = std::uint64_t{ 1 } << 32;
+			for (std::size_t j = m - n + 1; j > 0; --j)
+			{
+				const std::size_t k = j - 1;
+				const std::uint64_t numerator = (static_cast<std::uint64_t>(u[k + n]) << 32) | u[k + n - 1];
+				std::uint64_t qhat = numerator / v[n - 1];
+				std::uint64_t rhat = numerator % v[n - 1];
+				while (qhat >= base || qhat * v[n - 2] > ((rhat << 32) | u[k + n - 2]))
+				{
+					--qhat;
+					rhat += v[n - 1];
+					if (rhat >= base)
+					{
+						break;
+					}
+				}
+				std::int64_t borrow = 0, t = 0;
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					const std::uint64_t p = qhat * v[i];
+					t = static_cast<std::int64_t>(u[i + k]) - borrow - static_cast<std::int64_t>(p & 0xFFFFFFFF);
+					u[i + k] = static_cast<std::uint32_t>(t);
+					borrow = static_cast<std::int64_t>(p >> 32) - (t >> 32);
+				}
+				t = static_cast<std::int64_t>(u[k + n]) - borrow;
+				u[k + n] = static_cast<std::uint32_t>(t);
+				if (t < 0)
+				{
+					--qhat;
+					std::uint64_t carry = 0;
+					for (std::size_t i = 0; i < n; ++i)
+					{
+						carry += static_cast<std::uint64_t>(u[i + k]) + v[i];
+						u[i + k] = static_cast<std::uint32_t>(carry);
+						carry >>= 32;
+					}
+					u[k + n] += static_cast<std::uint32_t>(carry);
+				}
+				q[k] = static_cast<std::uint32_t>(qhat);
+			}
+			trim(q);
+			u.resize(n);
+			return { q, shift_right(u, s) };
+		}
+	}
+
+	// Signed integer of arbitrary length, sign and magnitude
+	struct big_integer
+	{
+		bool negative{ false };
+		limbs::digits magnitude{};
+
+		big_integer() = default;
+
+		template <std::integral I>
+		big_integer(I value)
+		{
+			negative = value < 0;
+			auto rest = negative ? static_cast<std::uint64_t>(-(value + 1)) + 1 : static_cast<std::uint64_t>(value);
+			for (; rest != 0; rest >>= 32)
+			{
+				magnitude.push_back(static_cast<std::uint32_t>(rest));
+			}
+		}
+
+		big_integer(bool is_negative, limbs::digits digits) : negative{ is_negative }, magnitude{ std::move(digits) }
+		{
+			limbs::trim(magnitude);
+			negative = negative && !magnitude.empty();
+		}
+
+		// 2^bits
+		static auto power_of_two(std::size_t bits) -> big_integer
+		{
+			return { false, limbs::shift_left(limbs::digits{ 1 }, bits) };
+		}
+
+		[[nodiscard]] auto is_zero() const -> bool { return magnitude.empty(); }
+		[[nodiscard]] auto bit_length() const -> std::size_t { return limbs::bit_length(magnitude); }
+
+		auto operator-() const -> big_integer { return { !negative, magnitude }; }
+
+		friend auto operator+(const big_integer& a, const big_integer& b) -> big_integer
+		{
+			if (a.negative == b.negative)
+			{
+				return { a.negative, limbs::add(a.magnitude, b.magnitude) };
+			}
+			if (limbs::compare(a.magnitude, b.magnitude) >= 0)
+			{
+				return { a.negative, limbs::subtract(a.magnitude, b.magnitude) };
+			}
+			return { b.negative, limbs::subtract(b.magnitude, a.magnitude) };
+		}
+		friend auto operator-(const big_integer& a, const big_integer& b) -> big_integer { return a + (-b); }
+		friend auto operator*(const big_integer& a, const big_integer& b) -> big_integer
+		{
+			return { a.negative != b.negative, limbs::multiply(a.magnitude, b.magnitude) };
+		}
+		// Quotient rounded towards zero, as for built in integers
+		friend auto operator/(const big_integer& a, const big_integer& b) -> big_integer
+		{
+			return { a.negative != b.negative, limbs::divide(a.magnitude, b.magnitude).first };
+		}
+		friend auto operator%(const big_integer& a, const big_integer& b) -> big_integer
+		{
+			return { a.negative, limbs::divide(a.magnitude, b.magnitude).second };
+		}
+		auto operator+=(const big_integer& b) -> big_integer& { return *this = *this + b; }
+		auto operator-=(const big_integer& b) -> big_integer& { return *this = *this - b; }
+		auto operator*=(const big_integer& b) -> big_integer& { return *this = *this * b; }
+
+		friend auto operator==(const big_integer& a, const big_integer& b) -> bool = default;
+		friend auto operator<=>(const big_integer& a, const big_integer& b) -> std::strong_ordering
+		{
+			if (a.negative != b.negative)
+			{
+				return b.negative <=> a.negative;
+			}
+			return a.negative ? limbs::compare(b.magnitude, a.magnitude) : limbs::compare(a.magnitude, b.magnitude);
+		}
+
+		// Decimal representation
+		[[nodiscard]] auto to_string() const -> std::string
+		{
+			if (is_zero())
+			{
+				return "0";
+			}
+			std::string result;
+			limbs::digits rest = magnitude;
+			while (!rest.empty())
+			{
+				auto [quotient, remainder] = limbs::divide(rest, limbs::digits{ 1000000000 });
+				auto chunk = std::to_string(remainder.empty() ? 0 : remainder[0]);
+				if (!quotient.empty())
+				{
+					chunk.insert(0, 9 - chunk.size(), '0');
+				}
+				result.insert(0, chunk);
+				rest = std::move(quotient);
+			}
+			return negative ? "-" + result : result;
+		}
+	};
+
+	// Bezout's coefficients and greatest common divisor of big integers
+	struct big_euclidean_result
+	{
+		std::tuple<big_integer, big_integer> coefficients{};
+		big_integer GCD{};
+	};
+
+	namespace big_gcd
+	{
+		// Above this many limbs of the smaller number gcd_extended uses the half-GCD
+		inline constexpr std::size_t half_gcd_threshold = 64;
+
+		// Unimodular matrix (a b; c d) taking a pair (r0, r1) to (a r0 + b r1, c r0 + d r1)
+		struct matrix
+		{
+			big_integer a{ 1 }, b{ 0 }, c{ 0 }, d{ 1 };
+		};
+
+		inline auto compose(const matrix& later, const matrix& earlier) -> matrix
+		{
+			return { later.a * earlier.a + later.b * earlier.c, later.a * earlier.b + later.b * earlier.d,
+				later.c * earlier.a + later.d * earlier.c, later.c * earlier.b + later.d * earlier.d };
+		}
+
+		// Pair of the remainder sequence r0 >= r1 >= 0 with the cofactors u_i, r_i = u_i a + v_i b
+		struct state
+		{
+			big_integer r0{}, r1{}, u0{ 1 }, u1{ 0 };
+
+			// Applies m to the pair and the cofactors, then restores r0 >= r1 >= 0, which
+			// keeps the matrix unimodular also when the quotients behind it were guessed wrong
+			void apply(matrix& m)
+			{
+				auto s0 = m.a * r0 + m.b * r1;
+				auto s1 = m.c * r0 + m.d * r1;
+				if (s0.negative)
+				{
+					s0 = -s0;
+					m.a = -m.a;
+					m.b = -m.b;
+				}
+				if (s1.negative)
+				{
+					s1 = -s1;
+					m.c = -m.c;
+					m.d = -m.d;
+				}
+				if (s0 < s1)
+				{
+					std::swap(s0, s1);
+					std::swap(m.a, m.c);
+					std::swap(m.b, m.d);
+				}
+				r0 = std::move(s0);
+				r1 = std::move(s1);
+			}
+
+			void apply_to_cofactors(const matrix& m)
+			{
+				auto w0 = m.a * u0 + m.b * u1;
+				u1 = m.c * u0 + m.d * u1;
+				u0 = std::move(w0);
+			}
+
+			// One step of the euclidean algorithm on the full numbers
+			auto division_step() -> matrix
+			{
+				auto [quotient, remainder] = limbs::divide(r0.magnitude, r1.magnitude);
+				big_integer q{ false, std::move(quotient) };
+				r0 = std::exchange(r1, big_integer{ false, std::move(remainder) });
+				return { 0, 1, 1, -q };
+			}
+
+			// Lehmer's step: the quotients of the leading 62 bits are used as long as the two
+			// bounds (x + A) / (y + C) and (x + B) / (y + D) agree, Knuth's algorithm L,
+			// then the whole sequence of them is applied at once. Returns the applied matrix.
+			auto lehmer_step() -> matrix
+			{
+				const std::size_t bits = r0.bit_length();
+				const std::size_t shift = bits > 62 ? bits - 62 : 0;
+				auto x = static_cast<std::int64_t>(limbs::top(r0.magnitude, shift));
+				auto y = static_cast<std::int64_t>(limbs::top(r1.magnitude, shift));
+				std::int64_t A = 1, B = 0, C = 0, D = 1;
+				while (y + C != 0 && y + D != 0)
+				{
+					const std::int64_t q = (x + A) / (y + C);
+					if (q != (x + B) / (y + D))
+					{
+						break;
+					}
+					A = std::exchange(C, A - q * C);
+					B = std::exchange(D, B - q * D);
+					x = std::exchange(y, x - q * y);
+				}
+				if (B == 0)
+				{
+					return division_step();
+				}
+				matrix m{ A, B, C, D };
+				apply(m);
+				return m;
+			}
+		};
+
+		// Half-GCD: a matrix which takes (r0, r1) about halfway down its remainder sequence,
+		// to a pair whose smaller number has at most about half the bits of r0. The matrix is
+		// found from the leading halves, recursively, so the work is O(M(n) log n) for the
+		// cost M(n) of a multiplication instead of the O(n^2) of Lehmer's algorithm.
+		inline auto half_gcd(const big_integer& r0, const big_integer& r1) -> matrix
+		{
+			const std::size_t n = r0.bit_length(), target = n / 2 + 64;
+			state s{ r0, r1 };
+			matrix result{};
+			if (s.r1.bit_length() <= target)
+			{
+				return result;
+			}
+			if (r0.magnitude.size() <= half_gcd_threshold)
+			{
+				while (!s.r1.is_zero() && s.r1.bit_length() > target)
+				{
+					result = compose(s.lehmer_step(), result);
+				}
+				return result;
+			}
+			const std::size_t k = n / 2;
+			auto first = half_gcd(big_integer{ false, limbs::shift_right(r0.magnitude, k) },
+				big_integer{ false, limbs::shift_right(r1.magnitude, k) });
+			s.apply(first);
+			result = std::move(first);
+			if (s.r1.is_zero() || s.r1.bit_length() <= target)
+			{
+				return result;
+			}
+			result = compose(s.division_step(), result);
+			if (s.r1.is_zero() || s.r1.bit_length() <= target)
+			{
+				return result;
+			}
+			const std::size_t m = s.r0.bit_length();
+			const std::size_t k2 = m < n ? std::min(n - m, m) : 0;
+			auto second = half_gcd(big_integer{ false, limbs::shift_right(s.r0.magnitude, k2) },
+				big_integer{ false, limbs::shift_right(s.r1.magnitude, k2) });
+			s.apply(second);
+			return compose(second, result);
+		}
+
+		enum class method { euclid, lehmer, half_gcd };
+
+		// Runs the remainder sequence of |a|, |b| with the chosen method and recovers the
+		// cofactor of b at the end from x |a| + y |b| = gcd, by one exact division
+		inline auto solve(const big_integer& a, const big_integer& b, method chosen) -> big_euclidean_result
+		{
+			big_integer abs_a{ false, a.magnitude }, abs_b{ false, b.magnitude };
+			state s{ abs_a, abs_b, 1, 0 };
+			if (s.r0 < s.r1)
+			{
+				s = state{ abs_b, abs_a, 0, 1 };
+			}
+			while (!s.r1.is_zero())
+			{
+				if (chosen == method::half_gcd && s.r1.magnitude.size() > half_gcd_threshold)
+				{
+					auto m = half_gcd(s.r0, s.r1);
+					s.apply(m);
+					s.apply_to_cofactors(m);
+					if (!s.r1.is_zero())
+					{
+						s.apply_to_cofactors(s.division_step());
+					}
+				}
+				else if (chosen != method::euclid)
+				{
+					s.apply_to_cofactors(s.lehmer_step());
+				}
+				else
+				{
+					s.apply_to_cofactors(s.division_step());
+				}
+			}
+			big_integer x = s.u0;
+			big_integer y = abs_b.is_zero() ? big_integer{ 0 } : (s.r0 - x * abs_a) / abs_b;
+			if (!abs_b.is_zero())
+			{
+				// reduces x below |b| / gcd, as the other overloads return
+				const big_integer step = abs_b / s.r0;
+				const big_integer shift = x / step;
+				x -= shift * step;
+				y += shift * (abs_a / s.r0);
+			}
+			if (a.negative)
+			{
+				x = -x;
+			}
+			if (b.negative)
+			{
+				y = -y;
+			}
+			return { .coefficients{ std::move(x), std::move(y) }, .GCD{ std::move(s.r0) } };
+		}
+	}
+
+	// Extended euclidean algorithm for big integers, Lehmer's algorithm for moderate sizes
+	// and the half-GCD above big_gcd::half_gcd_threshold limbs
+	inline auto gcd_extended(const big_integer& a, const big_integer& b) -> big_euclidean_result
+	{
+		return big_gcd::solve(a, b, big_gcd::method::half_gcd);
+	}
+
+	// Extended euclidean algorithm for big integers with Lehmer's algorithm only
+	inline auto gcd_extended_lehmer(const big_integer& a, const big_integer& b) -> big_euclidean_result
+	{
+		return big_gcd::solve(a, b, big_gcd::method::lehmer);
+	}
+
+	// Plain quotient loop, quadratic in the length with one full division per step
+	inline auto gcd_extended_euclid(const big_integer& a, const big_integer& b) -> big_euclidean_result
+	{
+		return big_gcd::solve(a, b, big_gcd::method::euclid);
+	}
+
+	//Random number of exactly the given number of bits
+	inline auto random_big_integer(std::size_t bits, std::mt19937_64& engine) -> big_integer
+	{
+		limbs::digits digits((bits + 31) / 32);
+		for (auto& digit : digits)
+		{
+			digit = static_cast<std::uint32_t>(engine());
+		}
+		if (bits % 32 != 0)
+		{
+			digits.back() &= (std::uint32_t{ 1 } << (bits % 32)) - 1;
+		}
+		digits.back() |= std::uint32_t{ 1 } << ((bits - 1) % 32);
+		return { false, std::move(digits) };
+	}
+}
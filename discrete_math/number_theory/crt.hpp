@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../euclidean_algorithm/big_integer.hpp"
+#include "factorization.hpp"
+#include "modint.hpp"
+
+namespace number_theory
+{
+    /*x = residue modulo modulus*/
+    struct congruence {
+        std::uint64_t residue{};
+        std::uint64_t modulus{ 1 };
+    };
+
+    /*Garner's algorithm for a fixed list of moduli. Every modulus is
+     * reduced to the part it contributes alone: pairwise coprime moduli
+     * are kept as they are, otherwise they are split into prime powers and
+     * for every prime the highest power is kept, the lower powers become
+     * consistency checks. A solution is built in mixed radix,
+     * x = d0 + d1 p0 + d2 p0 p1 + ..., with digits di < pi computed in
+     * word-sized arithmetic modulo pi, so nothing overflows whatever the
+     * size of the product; the plan, with the inverses of pj modulo pi, is
+     * computed once and reused for every residue vector*/
+    struct garner {
+        /*the pairwise coprime moduli pi of the mixed radix representation,
+         * with the input modulus each one is taken from*/
+        std::vector<std::uint64_t> radices{};
+        std::vector<std::size_t> sources{};
+        /*inverses[i][j] = pj^-1 modulo pi, j < i*/
+        std::vector<std::vector<std::uint64_t>> inverses{};
+        std::vector<barrett> reductions{};
+        /*input i and j have to agree modulo modulus*/
+        struct check {
+            std::size_t i{};
+            std::size_t j{};
+            std::uint64_t modulus{};
+        };
+        std::vector<check> checks{};
+
+        explicit garner(std::span<const std::uint64_t> moduli) {
+            if (pairwise_coprime(moduli)) {
+                for (std::size_t i = 0; i < moduli.size(); i++) {
+                    add_radix(moduli[i], i);
+                }
+            } else {
+                split_into_prime_powers(moduli);
+            }
+            inverses.resize(radices.size());
+            for (std::size_t i = 0; i < radices.size(); i++) {
+                reductions.emplace_back(radices[i]);
+                for (std::size_t j = 0; j < i; j++) {
+                    inverses[i].push_back(*inverse_modulo(radices[j] % radices[i], radices[i]));
+                }
+            }
+        }
+
+        /*mixed radix digits of the solution of x = residues[i] modulo
+         * moduli[i], empty if the congruences contradict each other*/
+        [[nodiscard]] auto digits(std::span<const std::uint64_t> residues) const -> std::optional<std::vector<std::uint64_t>> {
+            for (const auto& [i, j, modulus] : checks) {
+                if (residues[i] % modulus != residues[j] % modulus) {
+                    return std::nullopt;
+                }
+            }
+            std::vector<std::uint64_t> result(radices.size());
+            for (std::size_t i = 0; i < radices.size(); i++) {
+                const std::uint64_t p = radices[i];
+                std::uint64_t digit = residues[sources[i]] % p;
+                for (std::size_t j = 0; j < i; j++) {
+                    const std::uint64_t difference = digit >= result[j] % p ? digit - result[j] % p : digit + (p - result[j] % p);
+                    digit = reductions[i].reduce(uint128{ difference } * inverses[i][j]);
+                }
+                result[i] = digit;
+            }
+            return result;
+        }
+
+        /*x modulo modulus from its digits, by Horner's rule in 128 bits*/
+        [[nodiscard]] auto value_modulo(std::span<const std::uint64_t> digits, std::uint64_t modulus) const -> std::uint64_t {
+            const barrett reduction{ modulus };
+            std::uint64_t x = 0;
+            for (std::size_t i = digits.size(); i-- > 0;) {
+                x = reduction.reduce(uint128{ x } * (radices[i] % modulus) + digits[i]);
+            }
+            return x;
+        }
+
+        /*x modulo 2^64, which is x itself when the product of the radices
+         * fits in 64 bits*/
+        [[nodiscard]] auto low_word(std::span<const std::uint64_t> digits) const -> std::uint64_t {
+            std::uint64_t x = 0;
+            for (std::size_t i = digits.size(); i-- > 0;) {
+                x = x * radices[i] + digits[i];
+            }
+            return x;
+        }
+
+        /*x exactly, whatever its size*/
+        [[nodiscard]] auto value(std::span<const std::uint64_t> digits) const -> algorithms::big_integer {
+            algorithms::big_integer x{};
+            for (std::size_t i = digits.size(); i-- > 0;) {
+                x = x * algorithms::big_integer{ radices[i] } + algorithms::big_integer{ digits[i] };
+            }
+            return x;
+        }
+
+        /*least common multiple of the moduli, the period of the solutions*/
+        [[nodiscard]] auto period() const -> algorithms::big_integer {
+            algorithms::big_integer product{ 1 };
+            for (const auto p : radices) {
+                product *= algorithms::big_integer{ p };
+            }
+            return product;
+        }
+
+        /*solutions of many residue vectors, split over the cores in
+         * contiguous chunks with std::async; the plan is shared read-only.
+         * An empty entry marks a contradictory vector*/
+        [[nodiscard]] auto values(std::span<const std::vector<std::uint64_t>> batch) const -> std::vector<std::optional<algorithms::big_integer>> {
+            std::vector<std::optional<algorithms::big_integer>> result(batch.size());
+            const std::size_t cores = std::max(1U, std::thread::hardware_concurrency());
+            const std::size_t chunk = (batch.size() + cores - 1) / cores;
+            const auto solve_range = [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; k++) {
+                    if (const auto d = digits(batch[k])) {
+                        result[k] = value(*d);
+                    }
+                }
+            };
+            std::vector<std::future<void>> tasks;
+            for (std::size_t begin = chunk; begin < batch.size(); begin += chunk) {
+                tasks.push_back(std::async(std::launch::async, solve_range, begin, std::min(batch.size(), begin + chunk)));
+            }
+            solve_range(0, std::min(batch.size(), chunk));
+            for (auto& task : tasks) {
+                task.get();
+            }
+            return result;
+        }
+
+    private:
+        static auto pairwise_coprime(std::span<const std::uint64_t> moduli) -> bool {
+            for (std::size_t i = 0; i < moduli.size(); i++) {
+                for (std::size_t j = i + 1; j < moduli.size(); j++) {
+                    if (std::gcd(moduli[i], moduli[j]) != 1) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        auto add_radix(std::uint64_t modulus, std::size_t source) -> void {
+            if (modulus > 1) {
+                radices.push_back(modulus);
+                sources.push_back(source);
+            }
+        }
+
+        /*for every prime the input with its highest power supplies the
+         * radix, the other inputs divisible by the prime are checked
+         * against it modulo their own power*/
+        auto split_into_prime_powers(std::span<const std::uint64_t> moduli) -> void {
+            std::map<std::uint64_t, std::vector<std::pair<std::uint64_t, std::size_t>>> powers;
+            for (std::size_t i = 0; i < moduli.size(); i++) {
+                for (const auto& [prime, exponent] : factorize(moduli[i])) {
+                    std::uint64_t power = 1;
+                    for (std::uint32_t k = 0; k < exponent; k++) {
+                        power *= prime;
+                    }
+                    powers[prime].emplace_back(power, i);
+                }
+            }
+            for (auto& [prime, inputs] : powers) {
+                const auto highest = *std::ranges::max_element(inputs);
+                add_radix(highest.first, highest.second);
+                for (const auto& [power, source] : inputs) {
+                    if (source != highest.second) {
+                        checks.push_back({ source, highest.second, power });
+                    }
+                }
+            }
+        }
+    };
+
+    /*solution of the congruences modulo the least common multiple of their
+     * moduli, empty if they contradict each other; throws
+     * std::overflow_error if the least common multiple exceeds 64 bits, use
+     * garner::value for those*/
+    inline auto chinese_remainder(std::span<const congruence> congruences) -> std::optional<congruence> {
+        std::vector<std::uint64_t> moduli;
+        std::vector<std::uint64_t> residues;
+        for (const auto& [residue, modulus] : congruences) {
+            moduli.push_back(modulus);
+            residues.push_back(residue);
+        }
+        const garner plan{ moduli };
+        std::uint64_t period = 1;
+        for (const auto p : plan.radices) {
+            if (period > ~std::uint64_t{ 0 } / p) {
+                throw std::overflow_error("Modulus exceeds 64 bits.");
+            }
+            period *= p;
+        }
+        const auto digits = plan.digits(residues);
+        if (!digits) {
+            return std::nullopt;
+        }
+        return congruence{ plan.low_word(*digits), period };
+    }
+}
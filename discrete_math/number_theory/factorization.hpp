@@ -0,0 +1,201 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace number_theory
+{
+    /*prime factors with their multiplicities, in increasing order*/
+    using factorization = std::vector<std::pair<std::uint64_t, std::uint32_t>>;
+
+    using uint128 = unsigned __int128;
+
+    /*arithmetic modulo an odd n < 2^64 in Montgomery form x R mod n with
+     * R = 2^64: a product is reduced by two multiplications and a subtraction
+     * instead of a 128-bit division*/
+    struct montgomery64 {
+        std::uint64_t modulus{};
+        std::uint64_t inverse{};
+        std::uint64_t r_squared{};
+
+        explicit montgomery64(std::uint64_t n) : modulus{ n }, inverse{ n } {
+            constexpr int newton_steps = 5;
+            for (int i = 0; i < newton_steps; i++) {
+                inverse *= 2 - n * inverse;
+            }
+            const std::uint64_t r = (0 - n) % n;
+            r_squared = static_cast<std::uint64_t>(uint128{ r } * r % n);
+        }
+
+        /*t R^-1 mod n for t < n R: the low halves of t and m n cancel, where
+         * m = t n^-1 mod R*/
+        [[nodiscard]] auto reduce(uint128 t) const -> std::uint64_t {
+            const std::uint64_t m = static_cast<std::uint64_t>(t) * inverse;
+            const auto high = static_cast<std::uint64_t>(t >> 64);
+            const auto correction = static_cast<std::uint64_t>((uint128{ m } * modulus) >> 64);
+            return high >= correction ? high - correction : high - correction + modulus;
+        }
+
+        [[nodiscard]] auto multiply(std::uint64_t a, std::uint64_t b) const -> std::uint64_t {
+            return reduce(uint128{ a } * b);
+        }
+
+        [[nodiscard]] auto to_form(std::uint64_t a) const -> std::uint64_t {
+            return multiply(a % modulus, r_squared);
+        }
+
+        [[nodiscard]] auto from_form(std::uint64_t a) const -> std::uint64_t { return reduce(a); }
+
+        [[nodiscard]] auto add(std::uint64_t a, std::uint64_t b) const -> std::uint64_t {
+            return a >= modulus - b ? a - (modulus - b) : a + b;
+        }
+
+        /*base^exponent, base and result in Montgomery form*/
+        [[nodiscard]] auto pow(std::uint64_t base, std::uint64_t exponent) const -> std::uint64_t {
+            std::uint64_t result = to_form(1);
+            for (; exponent > 0; exponent /= 2) {
+                if (exponent % 2 == 1) {
+                    result = multiply(result, base);
+                }
+                base = multiply(base, base);
+            }
+            return result;
+        }
+    };
+
+    /*primes divided out by trial division before Pollard's rho is started*/
+    inline constexpr std::array<std::uint64_t, 12> small_primes{ 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+    /*one round of the Miller-Rabin test of the odd n = d 2^s + 1 to base a*/
+    inline auto miller_rabin_round(const montgomery64& m, std::uint64_t d, int s, std::uint64_t a) -> bool {
+        const std::uint64_t one = m.to_form(1);
+        const std::uint64_t minus_one = m.to_form(m.modulus - 1);
+        std::uint64_t x = m.pow(m.to_form(a), d);
+        if (x == one || x == minus_one) {
+            return true;
+        }
+        for (int i = 1; i < s; i++) {
+            x = m.multiply(x, x);
+            if (x == minus_one) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*deterministic primality test of any 64-bit n: the seven bases of
+     * Jim Sinclair have no common strong pseudoprime below 2^64*/
+    inline auto miller_rabin(std::uint64_t n) -> bool {
+        constexpr std::array<std::uint64_t, 7> bases{ 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+        if (n < 2) {
+            return false;
+        }
+        for (const auto p : small_primes) {
+            if (n % p == 0) {
+                return n == p;
+            }
+        }
+        const montgomery64 m{ n };
+        const int s = std::countr_zero(n - 1);
+        const std::uint64_t d = (n - 1) >> s;
+        return std::ranges::all_of(bases, [&](std::uint64_t a) { return a % n == 0 || miller_rabin_round(m, d, s, a % n); });
+    }
+
+    /*Brent's variant of Pollard's rho on x -> x^2 + c: the differences of
+     * batch steps are multiplied together and one gcd is taken per batch; if
+     * the batch overshoots to gcd n the steps are replayed one by one. n has
+     * to be odd and composite, returns a nontrivial factor*/
+    inline auto pollard_rho(std::uint64_t n) -> std::uint64_t {
+        constexpr std::uint64_t batch = 128;
+        const montgomery64 m{ n };
+        for (std::uint64_t c = 1;; c++) {
+            const std::uint64_t shift = m.to_form(c);
+            const auto step = [&](std::uint64_t x) { return m.add(m.multiply(x, x), shift); };
+            const auto distance = [](std::uint64_t a, std::uint64_t b) { return a > b ? a - b : b - a; };
+            std::uint64_t y = m.to_form(2);
+            std::uint64_t x = y;
+            std::uint64_t saved = y;
+            std::uint64_t product = m.to_form(1);
+            std::uint64_t g = 1;
+            for (std::uint64_t r = 1; g == 1; r *= 2) {
+                x = y;
+                for (std::uint64_t i = 0; i < r; i++) {
+                    y = step(y);
+                }
+                for (std::uint64_t k = 0; k < r && g == 1; k += batch) {
+                    saved = y;
+                    for (std::uint64_t i = 0; i < std::min(batch, r - k); i++) {
+                        y = step(y);
+                        product = m.multiply(product, distance(x, y));
+                    }
+                    g = std::gcd(product, n);
+                }
+            }
+            if (g == n) {
+                do {
+                    saved = step(saved);
+                    g = std::gcd(distance(x, saved), n);
+                } while (g == 1);
+            }
+            if (g != n) {
+                return g;
+            }
+        }
+    }
+
+    /*appends the prime factors of n, with repetitions, in no particular
+     * order*/
+    inline auto collect_prime_factors(std::uint64_t n, std::vector<std::uint64_t>& primes) -> void {
+        if (n == 1) {
+            return;
+        }
+        if (miller_rabin(n)) {
+            primes.push_back(n);
+            return;
+        }
+        const std::uint64_t d = pollard_rho(n);
+        collect_prime_factors(d, primes);
+        collect_prime_factors(n / d, primes);
+    }
+
+    /*prime factors of any 64-bit n in microseconds: the small primes by
+     * trial division, the rest by Pollard's rho and Miller-Rabin; 0 and 1
+     * have no factors*/
+    inline auto factorize(std::uint64_t n) -> factorization {
+        std::vector<std::uint64_t> primes;
+        if (n == 0) {
+            return {};
+        }
+        for (const auto p : small_primes) {
+            for (; n % p == 0; n /= p) {
+                primes.push_back(p);
+            }
+        }
+        collect_prime_factors(n, primes);
+        std::ranges::sort(primes);
+        factorization factors;
+        for (const auto p : primes) {
+            if (!factors.empty() && factors.back().first == p) {
+                factors.back().second++;
+            } else {
+                factors.emplace_back(p, 1);
+            }
+        }
+        return factors;
+    }
+
+    /*factorizations of all values, in order*/
+    inline auto factorize(std::span<const std::uint64_t> values) -> std::vector<factorization> {
+        std::vector<factorization> result;
+        result.reserve(values.size());
+        for (const auto value : values) {
+            result.push_back(factorize(value));
+        }
+        return result;
+    }
+}
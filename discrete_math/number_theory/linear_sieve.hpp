@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "factorization.hpp"
+
+namespace number_theory
+{
+    /*bound of the table behind decompose, euler_totient and moebius of
+     * Number_theory.hpp; the table is built on first use and takes about 9
+     * bytes per number*/
+    inline constexpr std::uint32_t factor_table_bound = 1U << 20;
+
+    /*divides the whole power of prime out of value and records it*/
+    inline auto divide_out(std::uint64_t& value, std::uint64_t prime, factorization& factors) -> void {
+        std::uint32_t power = 0;
+        for (; value % prime == 0; value /= prime) {
+            power++;
+        }
+        if (power > 0) {
+            factors.emplace_back(prime, power);
+        }
+    }
+
+    /*Euler's totient from the factorization, prod p^(k - 1) (p - 1)*/
+    inline auto totient_of(const factorization& factors) -> std::uint64_t {
+        std::uint64_t result = 1;
+        for (const auto& [prime, power] : factors) {
+            result *= prime - 1;
+            for (std::uint32_t k = 1; k < power; k++) {
+                result *= prime;
+            }
+        }
+        return result;
+    }
+
+    /*Moebius function from the factorization: 0 if a square divides the
+     * number, (-1)^(number of primes) otherwise*/
+    inline auto moebius_of(const factorization& factors) -> int {
+        int result = 1;
+        for (const auto& [prime, power] : factors) {
+            if (power > 1) {
+                return 0;
+            }
+            result = -result;
+        }
+        return result;
+    }
+
+    /*smallest prime factor, Euler's totient and Moebius function of every
+     * n <= bound, built by the linear sieve in O(bound): every composite is
+     * crossed off exactly once, as p * i for its smallest prime factor p, and
+     * the multiplicative functions of p * i follow from those of i in the
+     * same step. Queries up to bound take O(log n)*/
+    struct factor_table {
+        std::uint32_t bound{};
+        std::vector<std::uint32_t> primes{};
+        std::vector<std::uint32_t> smallest_prime_factors{};
+        std::vector<std::uint32_t> totients{};
+        std::vector<std::int8_t> moebius_values{};
+
+        explicit factor_table(std::uint32_t up_to)
+            : bound{ up_to },
+              smallest_prime_factors(static_cast<std::size_t>(up_to) + 1, 0),
+              totients(static_cast<std::size_t>(up_to) + 1, 0),
+              moebius_values(static_cast<std::size_t>(up_to) + 1, 0) {
+            if (up_to >= 1) {
+                totients[1] = 1;
+                moebius_values[1] = 1;
+            }
+            for (std::uint64_t i = 2; i <= up_to; i++) {
+                if (smallest_prime_factors[i] == 0) {
+                    record_prime(static_cast<std::uint32_t>(i));
+                }
+                cross_off_multiples(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        /*prime factors of value; up to bound by repeated division by the
+         * smallest prime factor, above it by Pollard's rho*/
+        [[nodiscard]] auto decompose(std::uint64_t value) const -> factorization {
+            if (value > bound) {
+                return factorize(value);
+            }
+            factorization factors;
+            while (value > 1) {
+                divide_out(value, smallest_prime_factors[value], factors);
+            }
+            return factors;
+        }
+
+        /*factorizations of all values, in order*/
+        [[nodiscard]] auto decompose(std::span<const std::uint64_t> values) const -> std::vector<factorization> {
+            std::vector<factorization> result;
+            result.reserve(values.size());
+            for (const auto value : values) {
+                result.push_back(decompose(value));
+            }
+            return result;
+        }
+
+        /*Euler's totient, looked up for value <= bound*/
+        [[nodiscard]] auto totient(std::uint64_t value) const -> std::uint64_t {
+            return value <= bound ? totients[value] : totient_of(decompose(value));
+        }
+
+        /*totients of all values, out.size() == values.size()*/
+        auto totient(std::span<const std::uint64_t> values, std::span<std::uint64_t> out) const -> void {
+            for (std::size_t i = 0; i < values.size(); i++) {
+                out[i] = totient(values[i]);
+            }
+        }
+
+        /*Moebius function, looked up for value <= bound*/
+        [[nodiscard]] auto moebius(std::uint64_t value) const -> int {
+            return value <= bound ? moebius_values[value] : moebius_of(decompose(value));
+        }
+
+        /*Moebius function of all values, out.size() == values.size()*/
+        auto moebius(std::span<const std::uint64_t> values, std::span<int> out) const -> void {
+            for (std::size_t i = 0; i < values.size(); i++) {
+                out[i] = moebius(values[i]);
+            }
+        }
+
+    private:
+        auto record_prime(std::uint32_t p) -> void {
+            smallest_prime_factors[p] = p;
+            totients[p] = p - 1;
+            moebius_values[p] = -1;
+            primes.push_back(p);
+        }
+
+        /*crosses off p * i for the primes p up to the smallest prime factor
+         * of i, the only numbers whose smallest prime factor p is paired with
+         * the cofactor i*/
+        auto cross_off_multiples(std::uint32_t i) -> void {
+            const std::uint32_t smallest = smallest_prime_factors[i];
+            for (const std::uint32_t p : primes) {
+                const std::uint64_t multiple = std::uint64_t{ p } * i;
+                if (p > smallest || multiple > bound) {
+                    return;
+                }
+                smallest_prime_factors[multiple] = p;
+                if (p == smallest) {
+                    totients[multiple] = totients[i] * p;
+                    moebius_values[multiple] = 0;
+                } else {
+                    totients[multiple] = totients[i] * (p - 1);
+                    moebius_values[multiple] = static_cast<std::int8_t>(-moebius_values[i]);
+                }
+            }
+        }
+    };
+
+    /*the table of factor_table_bound shared by the functions of
+     * Number_theory.hpp, built once on first use*/
+    inline auto default_factor_table() -> const factor_table& {
+        static const factor_table table{ factor_table_bound };
+        return table;
+    }
+}
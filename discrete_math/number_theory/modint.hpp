@@ -0,0 +1,213 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "factorization.hpp"
+
+namespace number_theory
+{
+    /*Barrett reduction modulo m >= 1: the quotient of x < 2^128 by m is
+     * estimated as the high half of x * floor((2^128 - 1) / m), which is at
+     * most 2 too small, so a remainder costs three 64-bit multiplications
+     * and at most two subtractions instead of a 128-bit division*/
+    struct barrett {
+        std::uint64_t modulus{};
+        uint128 factor{};
+
+        constexpr explicit barrett(std::uint64_t m) : modulus{ m }, factor{ ~uint128{ 0 } / m } {}
+
+        /*high 128 bits of the 256-bit product a b*/
+        [[nodiscard]] static constexpr auto multiply_high(uint128 a, uint128 b) -> uint128 {
+            constexpr uint128 low_mask = ~std::uint64_t{ 0 };
+            const uint128 a0 = a & low_mask, a1 = a >> 64, b0 = b & low_mask, b1 = b >> 64;
+            const uint128 cross1 = a1 * b0, cross2 = a0 * b1;
+            const uint128 middle = ((a0 * b0) >> 64) + (cross1 & low_mask) + (cross2 & low_mask);
+            return a1 * b1 + (cross1 >> 64) + (cross2 >> 64) + (middle >> 64);
+        }
+
+        [[nodiscard]] constexpr auto reduce(uint128 x) const -> std::uint64_t {
+            uint128 remainder = x - multiply_high(x, factor) * modulus;
+            while (remainder >= modulus) {
+                remainder -= modulus;
+            }
+            return static_cast<std::uint64_t>(remainder);
+        }
+    };
+
+    /*modulus fixed at compile time, its Barrett factor is a constant*/
+    template <std::uint64_t m>
+    requires(m >= 1)
+    struct fixed_modulus {
+        static constexpr barrett reduction{ m };
+
+        static constexpr auto value() -> std::uint64_t { return m; }
+        static constexpr auto reduce(uint128 x) -> std::uint64_t { return reduction.reduce(x); }
+    };
+
+    /*modulus chosen at run time with set, one per tag and thread, so
+     * several moduli can be used side by side under different tags*/
+    template <int tag>
+    struct runtime_modulus {
+        static auto set(std::uint64_t m) -> void { reduction() = barrett{ m }; }
+        static auto value() -> std::uint64_t { return reduction().modulus; }
+        static auto reduce(uint128 x) -> std::uint64_t { return reduction().reduce(x); }
+
+    private:
+        static auto reduction() -> barrett& {
+            thread_local barrett current{ 1 };
+            return current;
+        }
+    };
+
+    /*value mod m in [0, m) also for negative values, for m >= 1*/
+    template <std::integral I>
+    inline constexpr auto residue_of(I value, std::uint64_t m) -> std::uint64_t {
+        if constexpr (std::is_signed_v<I>) {
+            if (value < 0) {
+                const std::uint64_t r = (std::uint64_t{ 0 } - static_cast<std::uint64_t>(value)) % m;
+                return r == 0 ? 0 : m - r;
+            }
+        }
+        return static_cast<std::uint64_t>(value) % m;
+    }
+
+    /*inverse of a modulo m >= 1 by the extended euclidean algorithm, empty
+     * if gcd(a, m) != 1; the coefficients are bounded by m, so they are kept
+     * in 128 bits*/
+    inline constexpr auto inverse_modulo(std::uint64_t a, std::uint64_t m) -> std::optional<std::uint64_t> {
+        __int128 r0 = m, r1 = a % m, x0 = 0, x1 = 1;
+        while (r1 != 0) {
+            const __int128 q = r0 / r1;
+            r0 = std::exchange(r1, r0 - q * r1);
+            x0 = std::exchange(x1, x0 - q * x1);
+        }
+        if (r0 != 1 && m != 1) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint64_t>(x0 < 0 ? x0 + m : x0) % m;
+    }
+
+    /*residue modulo Modulus::value(), for any modulus below 2^64: sums are
+     * reduced by a comparison, products in 128 bits by Modulus::reduce*/
+    template <typename Modulus>
+    struct modint {
+        std::uint64_t residue{};
+
+        constexpr modint() = default;
+
+        template <std::integral I>
+        constexpr modint(I value) : residue{ residue_of(value, modulus()) } {}
+
+        [[nodiscard]] static constexpr auto modulus() -> std::uint64_t { return Modulus::value(); }
+        [[nodiscard]] constexpr auto value() const -> std::uint64_t { return residue; }
+
+        constexpr auto operator+=(const modint& b) -> modint& {
+            const std::uint64_t m = modulus();
+            residue = residue >= m - b.residue ? residue - (m - b.residue) : residue + b.residue;
+            return *this;
+        }
+        constexpr auto operator-=(const modint& b) -> modint& {
+            residue = residue >= b.residue ? residue - b.residue : residue + (modulus() - b.residue);
+            return *this;
+        }
+        constexpr auto operator*=(const modint& b) -> modint& {
+            residue = Modulus::reduce(uint128{ residue } * b.residue);
+            return *this;
+        }
+        /*throws std::invalid_argument if b is not invertible*/
+        constexpr auto operator/=(const modint& b) -> modint& { return *this *= b.inverse(); }
+        constexpr auto operator-() const -> modint { return modint{} -= *this; }
+
+        friend constexpr auto operator+(modint a, const modint& b) -> modint { return a += b; }
+        friend constexpr auto operator-(modint a, const modint& b) -> modint { return a -= b; }
+        friend constexpr auto operator*(modint a, const modint& b) -> modint { return a *= b; }
+        friend constexpr auto operator/(modint a, const modint& b) -> modint { return a /= b; }
+        friend constexpr auto operator==(const modint&, const modint&) -> bool = default;
+
+        /*this^exponent in O(log(exponent)) multiplications*/
+        [[nodiscard]] constexpr auto pow(std::uint64_t exponent) const -> modint {
+            modint result{ 1 };
+            for (modint base = *this; exponent > 0; exponent /= 2) {
+                if (exponent % 2 == 1) {
+                    result *= base;
+                }
+                base *= base;
+            }
+            return result;
+        }
+
+        /*throws std::invalid_argument if gcd(value, modulus) != 1*/
+        [[nodiscard]] constexpr auto inverse() const -> modint {
+            const auto inverse = inverse_modulo(residue, modulus());
+            if (!inverse) {
+                throw std::invalid_argument("Inverse does not exist.");
+            }
+            return from_residue(*inverse);
+        }
+
+        [[nodiscard]] static constexpr auto from_residue(std::uint64_t r) -> modint {
+            modint result;
+            result.residue = r;
+            return result;
+        }
+    };
+
+    template <std::uint64_t m>
+    using static_modint = modint<fixed_modulus<m>>;
+
+    template <int tag = 0>
+    using dynamic_modint = modint<runtime_modulus<tag>>;
+
+    /*number of bases raised together by the batched pow*/
+    inline constexpr std::size_t pow_lanes = 8;
+
+    /*out[i] = bases[i]^exponent: pow_lanes bases share one square and
+     * multiply loop, their independent multiplications overlap in the
+     * pipeline instead of waiting on one dependency chain*/
+    template <typename Modulus>
+    auto pow(std::span<const modint<Modulus>> bases, std::uint64_t exponent, std::span<modint<Modulus>> out) -> void {
+        for (std::size_t start = 0; start < bases.size(); start += pow_lanes) {
+            const std::size_t count = std::min(pow_lanes, bases.size() - start);
+            std::array<modint<Modulus>, pow_lanes> base{};
+            std::array<modint<Modulus>, pow_lanes> result{};
+            std::ranges::copy(bases.subspan(start, count), base.begin());
+            result.fill(modint<Modulus>{ 1 });
+            for (std::uint64_t e = exponent; e > 0; e /= 2) {
+                for (std::size_t l = 0; l < pow_lanes; l++) {
+                    result[l] = e % 2 == 1 ? result[l] * base[l] : result[l];
+                    base[l] *= base[l];
+                }
+            }
+            std::ranges::copy_n(result.begin(), static_cast<std::ptrdiff_t>(count), out.begin() + static_cast<std::ptrdiff_t>(start));
+        }
+    }
+
+    /*out[i] = values[i]^-1 by Montgomery's batch inversion: prefix products,
+     * one inversion of the whole product and a backward sweep, 3 (n - 1)
+     * multiplications and a single extended euclidean algorithm for n values.
+     * out must not overlap values; throws std::invalid_argument if some value
+     * is not invertible*/
+    template <typename Modulus>
+    auto inverse(std::span<const modint<Modulus>> values, std::span<modint<Modulus>> out) -> void {
+        if (values.empty()) {
+            return;
+        }
+        out[0] = values[0];
+        for (std::size_t i = 1; i < values.size(); i++) {
+            out[i] = out[i - 1] * values[i];
+        }
+        modint<Modulus> running = out[values.size() - 1].inverse();
+        for (std::size_t i = values.size() - 1; i > 0; i--) {
+            out[i] = running * out[i - 1];
+            running *= values[i];
+        }
+        out[0] = running;
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace number_theory
+{
+    /*bytes of one segment of the sieve, small enough for the segment to stay
+     * in the L1 cache while it is crossed off; one bit stands for one odd
+     * number, so a segment spans 16 * sieve_segment_bytes numbers*/
+    inline constexpr std::size_t sieve_segment_bytes = 32 * 1024;
+    inline constexpr std::uint64_t sieve_segment_span = 16 * sieve_segment_bytes;
+    inline constexpr std::uint64_t word_bits = 64;
+
+    /*floor(sqrt(n)), exact also where the double square root is not*/
+    inline auto integer_sqrt(std::uint64_t n) -> std::uint64_t {
+        constexpr std::uint64_t largest_root = 0xFFFFFFFF;
+        auto root = std::min(largest_root, static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n))));
+        while (root * root > n) {
+            root--;
+        }
+        while (root < largest_root && (root + 1) * (root + 1) <= n) {
+            root++;
+        }
+        return root;
+    }
+
+    /*odd primes up to limit by a plain odd-only sieve, they cross off the
+     * segments*/
+    inline auto odd_primes_up_to(std::uint64_t limit) -> std::vector<std::uint32_t> {
+        std::vector<std::uint32_t> primes;
+        std::vector<char> composite(limit / 2 + 1, 0);
+        for (std::uint64_t i = 3; i * i <= limit; i += 2) {
+            if (composite[i / 2] == 0) {
+                for (std::uint64_t j = i * i; j <= limit; j += 2 * i) {
+                    composite[j / 2] = 1;
+                }
+            }
+        }
+        for (std::uint64_t i = 3; i <= limit; i += 2) {
+            if (composite[i / 2] == 0) {
+                primes.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        return primes;
+    }
+
+    /*sieves the odd numbers of [low, high) for an odd low: bit i of bits is
+     * set afterwards iff low + 2 i is prime. primes are the odd primes up to
+     * sqrt(high), each segment finds its own first multiples, so segments are
+     * independent of each other*/
+    inline auto sieve_segment(std::uint64_t low, std::uint64_t high, const std::vector<std::uint32_t>& primes,
+                              std::vector<std::uint64_t>& bits) -> void {
+        const std::uint64_t count = (high - low + 1) / 2;
+        bits.assign((count + word_bits - 1) / word_bits, ~std::uint64_t{ 0 });
+        if (count % word_bits != 0) {
+            bits.back() = (std::uint64_t{ 1 } << (count % word_bits)) - 1;
+        }
+        for (const std::uint64_t p : primes) {
+            if (p * p >= high) {
+                break;
+            }
+            std::uint64_t start = std::max(p * p, (low + p - 1) / p * p);
+            if (start % 2 == 0) {
+                start += p;
+            }
+            for (std::uint64_t j = (start - low) / 2; j < count; j += p) {
+                bits[j / word_bits] &= ~(std::uint64_t{ 1 } << (j % word_bits));
+            }
+        }
+        if (low == 1) {
+            bits[0] &= ~std::uint64_t{ 1 };
+        }
+    }
+
+    /*sieves the segments of one batch, starting at the odd low, one segment
+     * per core with std::async; returns the number of segments used*/
+    inline auto sieve_batch(std::uint64_t low, std::uint64_t up_to, const std::vector<std::uint32_t>& primes,
+                            std::vector<std::vector<std::uint64_t>>& segments) -> std::size_t {
+        std::vector<std::future<void>> tasks;
+        std::size_t used = 0;
+        for (; used < segments.size() && low + used * sieve_segment_span < up_to; used++) {
+            const std::uint64_t segment_low = low + used * sieve_segment_span;
+            const std::uint64_t segment_high = std::min(up_to, segment_low + sieve_segment_span);
+            auto& bits = segments[used];
+            if (used > 0) {
+                tasks.push_back(std::async(std::launch::async, [&primes, &bits, segment_low, segment_high] {
+                    sieve_segment(segment_low, segment_high, primes, bits);
+                }));
+            }
+        }
+        sieve_segment(low, std::min(up_to, low + sieve_segment_span), primes, segments[0]);
+        for (auto& task : tasks) {
+            task.get();
+        }
+        return used;
+    }
+
+    /*calls callback(p) for every prime p with from <= p < up_to, in
+     * increasing order. The range is sieved segment by segment, one segment
+     * per core at a time, so the memory is bounded by the primes up to
+     * sqrt(up_to) and a few segments whatever the length of the range, and
+     * primes up to 1e11 and beyond can be streamed*/
+    template <typename Callback>
+    inline auto for_each_prime(std::uint64_t from, std::uint64_t up_to, Callback&& callback) -> void {
+        if (from <= 2 && up_to > 2) {
+            callback(std::uint64_t{ 2 });
+        }
+        if (up_to <= 3) {
+            return;
+        }
+        const auto primes = odd_primes_up_to(integer_sqrt(up_to - 1));
+        const std::size_t cores = std::max(1U, std::thread::hardware_concurrency());
+        std::vector<std::vector<std::uint64_t>> segments(cores);
+        for (std::uint64_t low = std::max<std::uint64_t>(from, 1) | 1; low < up_to;) {
+            const std::size_t used = sieve_batch(low, up_to, primes, segments);
+            for (std::size_t s = 0; s < used; s++, low += sieve_segment_span) {
+                for (std::size_t w = 0; w < segments[s].size(); w++) {
+                    for (std::uint64_t word = segments[s][w]; word != 0; word &= word - 1) {
+                        callback(low + 2 * (word_bits * w + static_cast<std::uint64_t>(std::countr_zero(word))));
+                    }
+                }
+            }
+        }
+    }
+
+    /*number of primes p <= n by the Lucy Hedgehog variant of Legendre's
+     * method: the counts of primes up to every value n / i are sieved at
+     * once, in O(n^(3/4)) time and O(sqrt(n)) memory instead of sieving the
+     * whole range. pi(1e11) takes well under a second*/
+    inline auto prime_pi(std::uint64_t n) -> std::uint64_t {
+        if (n < 2) {
+            return 0;
+        }
+        const std::uint64_t root = integer_sqrt(n);
+        std::vector<std::uint64_t> small(root + 1);
+        std::vector<std::uint64_t> large(root + 1);
+        for (std::uint64_t v = 1; v <= root; v++) {
+            small[v] = v - 1;
+            large[v] = n / v - 1;
+        }
+        for (std::uint64_t p = 2; p <= root; p++) {
+            if (small[p] == small[p - 1]) {
+                continue;
+            }
+            const std::uint64_t primes_below = small[p - 1];
+            const std::uint64_t square = p * p;
+            const std::uint64_t end = std::min(root, n / square);
+            for (std::uint64_t i = 1; i <= end; i++) {
+                const std::uint64_t d = i * p;
+                large[i] -= (d <= root ? large[d] : small[n / d]) - primes_below;
+            }
+            for (std::uint64_t v = root; v >= square; v--) {
+                small[v] -= small[v / p] - primes_below;
+            }
+        }
+        return large[1];
+    }
+}
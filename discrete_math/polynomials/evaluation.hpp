@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <future>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "division.hpp"
+#include "multiplication.hpp"
+
+namespace polynomial::evaluation {
+/*
+    description:
+        lanes - number of points evaluated together by batched Horner, the
+   independent accumulators fill a vector register and hide the latency of
+   the multiply-add chain;
+        estrin_block - number of coefficients of a block of Estrin's scheme;
+        estrin_threshold - from this length on one point is evaluated with
+   Estrin's scheme;
+        subproduct_threshold - from this number of points and length of the
+   polynomial on exact coefficients are evaluated with the subproduct tree;
+        parallel_threshold - from this number of multiplications on the
+   points are split among the cores.
+*/
+inline constexpr std::size_t lanes{8};
+inline constexpr std::size_t estrin_block{16};
+inline constexpr std::size_t estrin_threshold{64};
+inline constexpr std::size_t subproduct_threshold{8192};
+inline constexpr std::size_t parallel_threshold{std::size_t{1} << 20};
+
+/*
+    description:
+        Value of the polynomial with coefficients c, starting from x^0, at x
+   by Horner's scheme.
+*/
+template <typename T>
+auto horner(std::span<const T> c, const T &x) -> T {
+  T result{0};
+  for (std::size_t i = c.size(); i > 0; i--) {
+    result = result * x + c[i - 1];
+  }
+  return result;
+}
+
+/*
+    description:
+        Value at x by Estrin's scheme: each block of estrin_block
+   coefficients is reduced pairwise with x, x^2, x^4, x^8, which gives
+   independent multiplications instead of one chain, and the blocks are
+   combined by Horner's scheme in x^estrin_block.
+*/
+template <typename T>
+auto estrin(std::span<const T> c, const T &x) -> T {
+  std::array<T, 4> powers{x};
+  for (std::size_t i = 1; i < powers.size(); i++) {
+    powers[i] = powers[i - 1] * powers[i - 1];
+  }
+  const T step{powers.back() * powers.back()};
+  const std::size_t full{c.size() / estrin_block};
+  T result{horner(c.subspan(full * estrin_block), x)};
+  for (std::size_t b = full; b > 0; b--) {
+    std::array<T, estrin_block> block{};
+    std::ranges::copy(c.subspan((b - 1) * estrin_block, estrin_block),
+                      block.begin());
+    for (std::size_t width = estrin_block, level = 0; width > 1;
+         width /= 2, level++) {
+      for (std::size_t i = 0; i < width / 2; i++) {
+        block[i] = block[2 * i] + block[2 * i + 1] * powers[level];
+      }
+    }
+    result = result * step + block[0];
+  }
+  return result;
+}
+
+/*
+    description:
+        Value at one point, by Estrin's scheme for long polynomials and by
+   Horner's scheme otherwise.
+*/
+template <typename T>
+auto evaluate(std::span<const T> c, const T &x) -> T {
+  if (c.size() >= estrin_threshold) {
+    return estrin(c, x);
+  }
+  return horner(c, x);
+}
+
+/*
+    description:
+        Horner's scheme run on lanes points at once, the inner loop over the
+   lanes has no dependencies and vectorises.
+    parameters:
+        c - the coefficients, starting from x^0
+        xs - the points
+        out - the values, out.size() == xs.size()
+*/
+template <typename T>
+auto horner_batch(std::span<const T> c, std::span<const T> xs,
+                  std::span<T> out) -> void {
+  const std::size_t full{xs.size() - xs.size() % lanes};
+  for (std::size_t start = 0; start < full; start += lanes) {
+    std::array<T, lanes> x{};
+    std::array<T, lanes> result{};
+    std::ranges::copy(xs.subspan(start, lanes), x.begin());
+    for (std::size_t i = c.size(); i > 0; i--) {
+      for (std::size_t l = 0; l < lanes; l++) {
+        result[l] = result[l] * x[l] + c[i - 1];
+      }
+    }
+    std::ranges::copy(result, out.begin() + start);
+  }
+  for (std::size_t i = full; i < xs.size(); i++) {
+    out[i] = evaluate(c, xs[i]);
+  }
+}
+
+/*
+    description:
+        Subproduct tree of the points: level 0 holds the polynomials x - x_i,
+   every next level the products of neighbouring pairs, the last level the
+   product over all points.
+*/
+template <typename T>
+auto subproduct_tree(std::span<const T> xs)
+    -> std::vector<std::vector<std::vector<T>>> {
+  std::vector<std::vector<std::vector<T>>> tree(1);
+  for (const auto &x : xs) {
+    tree[0].push_back({T{0} - x, T{1}});
+  }
+  while (tree.back().size() > 1) {
+    const auto &below{tree.back()};
+    std::vector<std::vector<T>> level;
+    for (std::size_t i = 0; i + 1 < below.size(); i += 2) {
+      level.push_back(multiplication::multiply(
+          std::span<const T>{below[i]}, std::span<const T>{below[i + 1]}));
+    }
+    if (below.size() % 2 == 1) {
+      level.push_back(below.back());
+    }
+    tree.push_back(std::move(level));
+  }
+  return tree;
+}
+
+/*
+    description:
+        Multipoint evaluation with the subproduct tree: the polynomial is
+   reduced modulo the root and the remainders are passed down, reduced
+   modulo the children, until the remainder modulo x - x_i, the value at
+   x_i, is left. With fast multiplication and division this takes
+   O(M(n) log n) operations for n points instead of the O(n^2) of Horner's
+   scheme. The divisors are monic, the results are exact for exact
+   coefficients only, with floating point coefficients the remainders lose
+   accuracy quickly.
+    parameters:
+        c - the coefficients, starting from x^0
+        xs - the points, not empty
+        out - the values, out.size() == xs.size()
+*/
+template <typename T>
+auto subproduct_evaluate(std::span<const T> c, std::span<const T> xs,
+                         std::span<T> out) -> void {
+  const auto tree{subproduct_tree(xs)};
+  const auto reduce{[](std::vector<T> r, const std::vector<T> &divisor) {
+    if (r.size() < divisor.size()) {
+      return r;
+    }
+    return division::divmod(std::span<const T>{r},
+                            std::span<const T>{divisor})
+        .second;
+  }};
+  std::vector<std::vector<T>> remainders{
+      reduce(std::vector<T>(c.begin(), c.end()), tree.back()[0])};
+  for (std::size_t level = tree.size() - 1; level > 0; level--) {
+    const auto &children{tree[level - 1]};
+    std::vector<std::vector<T>> next(children.size());
+    for (std::size_t i = 0; i < children.size(); i++) {
+      next[i] = reduce(remainders[i / 2], children[i]);
+    }
+    remainders = std::move(next);
+  }
+  for (std::size_t i = 0; i < xs.size(); i++) {
+    out[i] = remainders[i].empty() ? T{0} : remainders[i][0];
+  }
+}
+
+/*
+    description:
+        Evaluates one chunk of points: exact coefficients of long
+   polynomials at many points with the subproduct tree, the rest with
+   batched Horner.
+*/
+template <typename T>
+auto evaluate_chunk(std::span<const T> c, std::span<const T> xs,
+                    std::span<T> out) -> void {
+  if constexpr (!std::is_arithmetic_v<T>) {
+    if (std::min(c.size(), xs.size()) >= subproduct_threshold) {
+      subproduct_evaluate(c, xs, out);
+      return;
+    }
+  }
+  horner_batch(c, xs, out);
+}
+
+/*
+    description:
+        Runs work(start, size) on consecutive chunks of [0, count), one chunk
+   per core with std::async, or on the whole range at once if the total work
+   is below parallel_threshold.
+*/
+template <typename Work>
+auto parallel_chunks(std::size_t count, std::size_t work, Work chunk_work)
+    -> void {
+  const std::size_t cores{std::max(1U, std::thread::hardware_concurrency())};
+  if (cores == 1 || count < 2 || work < parallel_threshold) {
+    chunk_work(std::size_t{0}, count);
+    return;
+  }
+  const std::size_t chunk{(count + cores - 1) / cores};
+  std::vector<std::future<void>> tasks;
+  for (std::size_t start = chunk; start < count; start += chunk) {
+    const std::size_t size{std::min(chunk, count - start)};
+    tasks.push_back(
+        std::async(std::launch::async, [=] { chunk_work(start, size); }));
+  }
+  chunk_work(std::size_t{0}, std::min(chunk, count));
+  for (auto &task : tasks) {
+    task.get();
+  }
+}
+
+/*
+    description:
+        Multipoint evaluation. Large batches are split into one chunk per
+   core, see parallel_chunks.
+    parameters:
+        c - the coefficients, starting from x^0
+        xs - the points
+        out - the values, out.size() == xs.size()
+*/
+template <typename T>
+auto evaluate(std::span<const T> c, std::span<const T> xs, std::span<T> out)
+    -> void {
+  parallel_chunks(xs.size(), c.size() * xs.size(),
+                  [=](std::size_t start, std::size_t size) {
+                    evaluate_chunk(c, xs.subspan(start, size),
+                                   out.subspan(start, size));
+                  });
+}
+}  // namespace polynomial::evaluation
@@ -0,0 +1,525 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "../../Number_theory.hpp"
+
+namespace polynomial::multiplication {
+/*
+    description:
+        Thresholds on the length of the shorter factor: below
+   karatsuba_threshold the schoolbook product is used, from fft_threshold on
+   floating point coefficients and integer coefficients small enough for an
+   exact FFT are multiplied with the FFT, from ntt_threshold on the other
+   integer coefficients with the NTT, in between with Karatsuba.
+*/
+inline constexpr std::size_t karatsuba_threshold{32};
+inline constexpr std::size_t fft_threshold{128};
+inline constexpr std::size_t ntt_threshold{2048};
+
+/*
+    description:
+        Primes p = c * 2^k + 1 with the primitive root 3, used by the NTT.
+   Their product exceeds 2^86, so the three residues of a coefficient
+   determine every coefficient which fits into 64 bits. 998244353 - 1 =
+   119 * 2^23 has the smallest power of two, so ntt_max_length = 2^23 is the
+   longest transform all three support.
+*/
+inline constexpr std::uint32_t ntt_prime_1{998244353};
+inline constexpr std::uint32_t ntt_prime_2{167772161};
+inline constexpr std::uint32_t ntt_prime_3{469762049};
+inline constexpr std::uint32_t ntt_root{3};
+inline constexpr std::size_t ntt_max_length{std::size_t{1} << 23};
+
+/*
+    description:
+        Multiplies two coefficient sequences by the definition, the inner loop
+   runs over contiguous memory and vectorises.
+    parameters:
+        a, b - the coefficients of the factors, starting from x^0
+    return:
+        std::vector<T> - the a.size() + b.size() - 1 coefficients of the
+   product
+*/
+template <typename T>
+auto schoolbook(std::span<const T> a, std::span<const T> b) -> std::vector<T> {
+  std::vector<T> result(a.size() + b.size() - 1, T{0});
+  for (std::size_t i = 0; i < a.size(); i++) {
+    for (std::size_t j = 0; j < b.size(); j++) {
+      result[i + j] += a[i] * b[j];
+    }
+  }
+  return result;
+}
+
+/*
+    description:
+        Adds part multiplied by x^offset to result.
+*/
+template <typename T>
+auto add_shifted(std::vector<T> &result, const std::vector<T> &part,
+                 std::size_t offset) -> void {
+  for (std::size_t i = 0; i < part.size(); i++) {
+    result[i + offset] += part[i];
+  }
+}
+
+/*
+    description:
+        Karatsuba multiplication: with a = a0 + x^m a1 and b = b0 + x^m b1
+   the product needs the three products a0 b0, a1 b1 and (a0 + a1)(b0 + b1)
+   only, which gives O(n^1.58) operations. A factor more than twice as long
+   as the other one is cut into pieces of the length of the shorter one.
+   Works for any ring of coefficients.
+    parameters:
+        a, b - the coefficients of the factors, starting from x^0
+    return:
+        std::vector<T> - the coefficients of the product
+*/
+template <typename T>
+auto karatsuba(std::span<const T> a, std::span<const T> b) -> std::vector<T> {
+  if (a.size() < b.size()) {
+    std::swap(a, b);
+  }
+  if (b.size() < karatsuba_threshold) {
+    return schoolbook(a, b);
+  }
+  const std::size_t m{(a.size() + 1) / 2};
+  if (b.size() <= m) {
+    std::vector<T> result(a.size() + b.size() - 1, T{0});
+    for (std::size_t offset = 0; offset < a.size(); offset += b.size()) {
+      const auto piece{
+          a.subspan(offset, std::min(b.size(), a.size() - offset))};
+      add_shifted(result, karatsuba(piece, b), offset);
+    }
+    return result;
+  }
+  const auto a0{a.first(m)};
+  const auto a1{a.subspan(m)};
+  const auto b0{b.first(m)};
+  const auto b1{b.subspan(m)};
+  std::vector<T> a_sum(a0.begin(), a0.end());
+  std::vector<T> b_sum(b0.begin(), b0.end());
+  for (std::size_t i = 0; i < a1.size(); i++) {
+    a_sum[i] += a1[i];
+  }
+  for (std::size_t i = 0; i < b1.size(); i++) {
+    b_sum[i] += b1[i];
+  }
+  const auto low{karatsuba(a0, b0)};
+  const auto high{karatsuba(a1, b1)};
+  auto middle{karatsuba(std::span<const T>{a_sum}, std::span<const T>{b_sum})};
+  for (std::size_t i = 0; i < low.size(); i++) {
+    middle[i] -= low[i];
+  }
+  for (std::size_t i = 0; i < high.size(); i++) {
+    middle[i] -= high[i];
+  }
+  std::vector<T> result(a.size() + b.size() - 1, T{0});
+  add_shifted(result, low, 0);
+  add_shifted(result, middle, m);
+  add_shifted(result, high, 2 * m);
+  return result;
+}
+
+/*
+    description:
+        Roots of unity exp(i pi j / k) of every level k = 1, 2, 4, ... < n,
+   stored at the indices k + j. They are generated in long double from the
+   roots of the previous level, which keeps their error at the level of
+   rounding, and the table is kept for the following transforms.
+*/
+inline auto fft_roots(std::size_t n)
+    -> const std::vector<std::complex<double>> & {
+  thread_local std::vector<std::complex<double>> roots(2, 1);
+  thread_local std::vector<std::complex<long double>> exact(2, 1);
+  for (std::size_t k = roots.size(); k < n; k *= 2) {
+    roots.resize(2 * k);
+    exact.resize(2 * k);
+    const long double angle{std::numbers::pi_v<long double> /
+                            static_cast<long double>(k)};
+    const long double c{std::cos(angle)};
+    const long double s{std::sin(angle)};
+    for (std::size_t i = k; i < 2 * k; i++) {
+      auto root{exact[i / 2]};
+      if ((i & 1) != 0) {
+        root = {root.real() * c - root.imag() * s,
+                root.real() * s + root.imag() * c};
+      }
+      exact[i] = root;
+      roots[i] = std::complex<double>(root);
+    }
+  }
+  return roots;
+}
+
+/*
+    description:
+        Forward FFT by decimation in frequency: takes the coefficients in
+   natural order and leaves the transform in bit reversed order, which the
+   pointwise product does not mind and fft_inverse expects. a.size() is a
+   power of two. The complex products are written out, std::complex
+   multiplication checks for NaN.
+*/
+inline auto fft_forward(std::vector<std::complex<double>> &a) -> void {
+  const std::size_t n{a.size()};
+  const std::complex<double> *roots{fft_roots(n).data()};
+  for (std::size_t k = n / 2; k >= 1; k /= 2) {
+    for (std::size_t i = 0; i < n; i += 2 * k) {
+      std::complex<double> *low{a.data() + i};
+      std::complex<double> *high{low + k};
+      const std::complex<double> *w{roots + k};
+      for (std::size_t j = 0; j < k; j++) {
+        const double re{low[j].real() - high[j].real()};
+        const double im{low[j].imag() - high[j].imag()};
+        low[j] += high[j];
+        high[j] = {re * w[j].real() - im * w[j].imag(),
+                   re * w[j].imag() + im * w[j].real()};
+      }
+    }
+  }
+}
+
+/*
+    description:
+        Inverse FFT by decimation in time, without the division by n: takes
+   the transform in bit reversed order and gives n times the coefficients in
+   natural order, so no bit reversal pass is needed at all.
+*/
+inline auto fft_inverse(std::vector<std::complex<double>> &a) -> void {
+  const std::size_t n{a.size()};
+  const std::complex<double> *roots{fft_roots(n).data()};
+  for (std::size_t k = 1; k < n; k *= 2) {
+    for (std::size_t i = 0; i < n; i += 2 * k) {
+      std::complex<double> *low{a.data() + i};
+      std::complex<double> *high{low + k};
+      const std::complex<double> *w{roots + k};
+      for (std::size_t j = 0; j < k; j++) {
+        const double re{w[j].real() * high[j].real() +
+                        w[j].imag() * high[j].imag()};
+        const double im{w[j].real() * high[j].imag() -
+                        w[j].imag() * high[j].real()};
+        high[j] = {low[j].real() - re, low[j].imag() - im};
+        low[j] = {low[j].real() + re, low[j].imag() + im};
+      }
+    }
+  }
+}
+
+/*
+    description:
+        Product of real sequences with two transforms: a goes into the real
+   and b into the imaginary part, the square of (a + ib) is a^2 - b^2 + 2iab,
+   so the imaginary part of its inverse transform is twice the product.
+    return:
+        std::vector<double> - the coefficients of the product, with the
+   rounding error of the FFT
+*/
+template <typename T>
+auto fft_multiply(std::span<const T> a, std::span<const T> b)
+    -> std::vector<double> {
+  const std::size_t size{a.size() + b.size() - 1};
+  const std::size_t n{std::bit_ceil(size)};
+  std::vector<std::complex<double>> values(n);
+  for (std::size_t i = 0; i < a.size(); i++) {
+    values[i].real(static_cast<double>(a[i]));
+  }
+  for (std::size_t i = 0; i < b.size(); i++) {
+    values[i].imag(static_cast<double>(b[i]));
+  }
+  fft_forward(values);
+  for (auto &x : values) {
+    x = {x.real() * x.real() - x.imag() * x.imag(),
+         2 * x.real() * x.imag()};
+  }
+  fft_inverse(values);
+  std::vector<double> result(size);
+  for (std::size_t i = 0; i < size; i++) {
+    result[i] = values[i].imag() / (2.0 * static_cast<double>(n));
+  }
+  return result;
+}
+
+/*
+    description:
+        Checks whether the rounded FFT product of integer sequences is exact.
+   The error of the FFT stays below 1/2 while (sum a_i^2 + sum b_i^2) log2(n)
+   < 9 * 10^14 for the transform length n.
+*/
+template <std::integral T>
+auto fft_is_exact(std::span<const T> a, std::span<const T> b) -> bool {
+  long double norm{0};
+  for (const T x : a) {
+    norm += static_cast<long double>(x) * static_cast<long double>(x);
+  }
+  for (const T x : b) {
+    norm += static_cast<long double>(x) * static_cast<long double>(x);
+  }
+  const auto n{std::bit_ceil(a.size() + b.size() - 1)};
+  return norm * std::bit_width(n) < 9e14L;
+}
+
+/*
+    description:
+        Powers 1, w, ..., w^(half - 1) of the root of unity w of order
+   2 * half modulo the NTT prime mod, w is a power of the primitive root
+   found with number_theory::modular_pow. Together with each power p the
+   quotient floor(p 2^32 / mod) is stored, which turns the products by p into
+   two multiplications without a division (Shoup).
+*/
+template <std::uint32_t mod>
+auto ntt_powers(std::vector<std::uint32_t> &powers,
+                std::vector<std::uint32_t> &quotients, std::size_t half,
+                bool invert) -> void {
+  std::uint64_t root{number_theory::modular_pow<mod>(std::uint64_t{ntt_root},
+                                                     (mod - 1) / (2 * half))};
+  if (invert) {
+    root = number_theory::modular_pow<mod>(root, mod - 2);
+  }
+  powers[0] = 1;
+  for (std::size_t j = 1; j < half; j++) {
+    powers[j] = static_cast<std::uint32_t>(powers[j - 1] * root % mod);
+  }
+  for (std::size_t j = 0; j < half; j++) {
+    quotients[j] =
+        static_cast<std::uint32_t>((std::uint64_t{powers[j]} << 32) / mod);
+  }
+}
+
+/*
+    description:
+        x * power modulo mod with the quotient of ntt_powers, the arithmetic
+   wraps modulo 2^32 and the error of the estimated quotient is at most one.
+*/
+template <std::uint32_t mod>
+constexpr auto multiply_modulo(std::uint32_t x, std::uint32_t power,
+                               std::uint32_t quotient) -> std::uint32_t {
+  const auto estimate{
+      static_cast<std::uint32_t>((std::uint64_t{x} * quotient) >> 32)};
+  const std::uint32_t r{x * power - estimate * mod};
+  return r >= mod ? r - mod : r;
+}
+
+/*
+    description:
+        Number theoretic transform modulo the NTT prime mod by decimation in
+   frequency, the result is in bit reversed order like the one of
+   fft_forward. a.size() is a power of two dividing mod - 1.
+*/
+template <std::uint32_t mod>
+auto ntt_forward(std::vector<std::uint32_t> &a) -> void {
+  const std::size_t n{a.size()};
+  std::vector<std::uint32_t> powers(std::max<std::size_t>(n / 2, 1));
+  std::vector<std::uint32_t> quotients(powers.size());
+  for (std::size_t k = n / 2; k >= 1; k /= 2) {
+    ntt_powers<mod>(powers, quotients, k, false);
+    for (std::size_t i = 0; i < n; i += 2 * k) {
+      std::uint32_t *low{a.data() + i};
+      std::uint32_t *high{low + k};
+      for (std::size_t j = 0; j < k; j++) {
+        const std::uint32_t u{low[j]};
+        const std::uint32_t v{high[j]};
+        low[j] = u + v < mod ? u + v : u + v - mod;
+        high[j] = multiply_modulo<mod>(u >= v ? u - v : u + mod - v,
+                                       powers[j], quotients[j]);
+      }
+    }
+  }
+}
+
+/*
+    description:
+        Inverse of ntt_forward by decimation in time, including the division
+   by n.
+*/
+template <std::uint32_t mod>
+auto ntt_inverse(std::vector<std::uint32_t> &a) -> void {
+  const std::size_t n{a.size()};
+  std::vector<std::uint32_t> powers(std::max<std::size_t>(n / 2, 1));
+  std::vector<std::uint32_t> quotients(powers.size());
+  for (std::size_t k = 1; k < n; k *= 2) {
+    ntt_powers<mod>(powers, quotients, k, true);
+    for (std::size_t i = 0; i < n; i += 2 * k) {
+      std::uint32_t *low{a.data() + i};
+      std::uint32_t *high{low + k};
+      for (std::size_t j = 0; j < k; j++) {
+        const std::uint32_t u{low[j]};
+        const std::uint32_t v{
+            multiply_modulo<mod>(high[j], powers[j], quotients[j])};
+        low[j] = u + v < mod ? u + v : u + v - mod;
+        high[j] = u >= v ? u - v : u + mod - v;
+      }
+    }
+  }
+  const std::uint64_t n_inverse{
+      number_theory::modular_pow<mod>(std::uint64_t{n}, mod - 2)};
+  for (auto &x : a) {
+    x = static_cast<std::uint32_t>(x * n_inverse % mod);
+  }
+}
+
+/*
+    description:
+        Product of sequences of residues modulo the NTT prime mod.
+    parameters:
+        a, b - residues modulo mod, starting from x^0, a.size() + b.size() - 1
+   <= ntt_max_length
+    return:
+        std::vector<std::uint32_t> - the residues of the product
+*/
+template <std::uint32_t mod>
+auto ntt_multiply(std::span<const std::uint32_t> a,
+                  std::span<const std::uint32_t> b)
+    -> std::vector<std::uint32_t> {
+  const std::size_t size{a.size() + b.size() - 1};
+  const std::size_t n{std::bit_ceil(size)};
+  std::vector<std::uint32_t> fa(n, 0);
+  std::vector<std::uint32_t> fb(n, 0);
+  std::ranges::copy(a, fa.begin());
+  std::ranges::copy(b, fb.begin());
+  ntt_forward<mod>(fa);
+  ntt_forward<mod>(fb);
+  for (std::size_t i = 0; i < n; i++) {
+    fa[i] = static_cast<std::uint32_t>(std::uint64_t{fa[i]} * fb[i] % mod);
+  }
+  ntt_inverse<mod>(fa);
+  fa.resize(size);
+  return fa;
+}
+
+/*
+    description:
+        Product of integer sequences modulo each of the three NTT primes.
+*/
+template <std::uint32_t mod, std::integral T>
+auto residue_product(std::span<const T> a, std::span<const T> b)
+    -> std::vector<std::uint32_t> {
+  const auto residues{[](std::span<const T> values) {
+    std::vector<std::uint32_t> result(values.size());
+    for (std::size_t i = 0; i < values.size(); i++) {
+      if constexpr (std::is_signed_v<T>) {
+        const std::int64_t r{static_cast<std::int64_t>(values[i]) %
+                             std::int64_t{mod}};
+        result[i] = static_cast<std::uint32_t>(r < 0 ? r + mod : r);
+      } else {
+        result[i] = static_cast<std::uint32_t>(values[i] % mod);
+      }
+    }
+    return result;
+  }};
+  const auto ra{residues(a)};
+  const auto rb{residues(b)};
+  return ntt_multiply<mod>(std::span<const std::uint32_t>{ra},
+                           std::span<const std::uint32_t>{rb});
+}
+
+/*
+    description:
+        Exact product of integer sequences: three NTTs and the Chinese
+   remainder theorem in Garner's form x = x1 + x2 p1 + x3 p1 p2. Every
+   coefficient which fits into 64 bits is recovered, the sums are formed
+   modulo 2^64 and x3 > p3 / 2 marks a negative coefficient. The product
+   has at most ntt_max_length coefficients, see ntt_multiply_blocks.
+*/
+template <std::integral T>
+auto ntt_multiply_integers(std::span<const T> a, std::span<const T> b)
+    -> std::vector<T> {
+  constexpr std::uint64_t p1{ntt_prime_1};
+  constexpr std::uint64_t p2{ntt_prime_2};
+  constexpr std::uint64_t p3{ntt_prime_3};
+  const auto r1{residue_product<ntt_prime_1>(a, b)};
+  const auto r2{residue_product<ntt_prime_2>(a, b)};
+  const auto r3{residue_product<ntt_prime_3>(a, b)};
+  const std::uint64_t p1_inverse{
+      number_theory::modular_pow<ntt_prime_2>(p1 % p2, p2 - 2)};
+  const std::uint64_t p1_p2_inverse{
+      number_theory::modular_pow<ntt_prime_3>(p1 * p2 % p3, p3 - 2)};
+  const std::uint64_t modulus{p1 * p2 * p3};  // modulo 2^64
+  std::vector<T> result(r1.size());
+  for (std::size_t i = 0; i < result.size(); i++) {
+    const std::uint64_t x1{r1[i]};
+    const std::uint64_t x2{(r2[i] + p2 - x1 % p2) * p1_inverse % p2};
+    const std::uint64_t x3{
+        (r3[i] + 2 * p3 - x1 % p3 - x2 * p1 % p3) % p3 * p1_p2_inverse % p3};
+    std::uint64_t x{x1 + x2 * p1 + x3 * p1 * p2};
+    if (x3 > p3 / 2) {
+      x -= modulus;
+    }
+    result[i] = static_cast<T>(static_cast<std::int64_t>(x));
+  }
+  return result;
+}
+
+/*
+    description:
+        Exact product of integer sequences whose product is longer than
+   ntt_max_length: both factors are cut into blocks of half that length, the
+   product of two blocks fits into one transform and is added at its offset.
+*/
+template <std::integral T>
+auto ntt_multiply_blocks(std::span<const T> a, std::span<const T> b)
+    -> std::vector<T> {
+  constexpr std::size_t block{ntt_max_length / 2};
+  std::vector<T> result(a.size() + b.size() - 1, T{0});
+  for (std::size_t i = 0; i < a.size(); i += block) {
+    const auto a_block{a.subspan(i, std::min(block, a.size() - i))};
+    for (std::size_t j = 0; j < b.size(); j += block) {
+      const auto b_block{b.subspan(j, std::min(block, b.size() - j))};
+      add_shifted(result, ntt_multiply_integers(a_block, b_block), i + j);
+    }
+  }
+  return result;
+}
+
+/*
+    description:
+        Multiplies two coefficient sequences choosing the algorithm by the
+   length of the shorter factor and the type of the coefficients, see the
+   thresholds above. Coefficients other than float, double and integers are
+   multiplied with schoolbook and Karatsuba only.
+    parameters:
+        a, b - the coefficients of the factors, starting from x^0
+    return:
+        std::vector<T> - the a.size() + b.size() - 1 coefficients of the
+   product
+*/
+template <typename T>
+auto multiply(std::span<const T> a, std::span<const T> b) -> std::vector<T> {
+  if (a.empty() || b.empty()) {
+    return {};
+  }
+  const std::size_t shorter{std::min(a.size(), b.size())};
+  if (shorter < karatsuba_threshold) {
+    return schoolbook(a, b);
+  }
+  if constexpr (std::floating_point<T> && sizeof(T) <= sizeof(double)) {
+    if (shorter >= fft_threshold) {
+      const auto product{fft_multiply(a, b)};
+      return std::vector<T>(product.begin(), product.end());
+    }
+  } else if constexpr (std::integral<T> && !std::same_as<T, bool>) {
+    if (shorter >= fft_threshold && fft_is_exact(a, b)) {
+      const auto product{fft_multiply(a, b)};
+      std::vector<T> result(product.size());
+      for (std::size_t i = 0; i < product.size(); i++) {
+        result[i] = static_cast<T>(std::llround(product[i]));
+      }
+      return result;
+    }
+    if (shorter >= ntt_threshold) {
+      return a.size() + b.size() - 1 <= ntt_max_length
+                 ? ntt_multiply_integers(a, b)
+                 : ntt_multiply_blocks(a, b);
+    }
+  }
+  return karatsuba(a, b);
+}
+}  // namespace polynomial::multiplication
@@ -1,16 +1,23 @@
 #pragma once
 #include <algorithm>
 #include <cmath>
+#include <concepts>
 #include <cstdio>
 #include <format>
 #include <iostream>
 #include <numeric>
 #include <print>
 #include <set>
+#include <span>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "division.hpp"
+#include "evaluation.hpp"
+#include "multiplication.hpp"
+#include "roots.hpp"
+
 namespace polynomial {
 template <typename T>
 struct polynomial {
@@ -33,9 +40,10 @@ struct polynomial {
     }
     for (std::size_t i = 0; i <= p.degree; ++i) {
       coefficients[i] += p.coefficients[i];
-      if (coefficients[i] != 0) {
-        degree = i;
-      }
+    }
+    degree = std::max(degree, p.degree);
+    while (degree > 0 && coefficients[degree] == T{0}) {
+      degree--;
     }
     return *this;
   }
@@ -65,31 +73,27 @@ struct polynomial {
   }
   /*
       description:
-          Multiplies this polynomial by another polynomial.
+          Multiplies this polynomial by another polynomial with schoolbook,
+     Karatsuba, FFT or NTT multiplication depending on the degrees and the
+     type of the coefficients, see multiplication.hpp.
       parameters:
           p - the polynomial to be multiplied
       return:
           polynomial& - the result of the multiplication
   */
   auto operator*=(const polynomial &p) -> polynomial & {
-    std::vector<T> multiplication_vector{};
-    multiplication_vector.resize(p.degree + degree + 1, T{0});
-    coefficients.resize(p.degree + degree + 1, T{0});
-    for (std::size_t i = degree + 1; i > 0; i--) {
-      for (std::size_t j = p.degree + 1; j > 0; j--) {
-        multiplication_vector[i + j - 2] +=
-            coefficients[i - 1] * p.coefficients[j - 1];
-      }
-    }
-    coefficients = multiplication_vector;
+    coefficients = multiplication::multiply(
+        std::span<const T>{coefficients.data(), degree + 1},
+        std::span<const T>{p.coefficients.data(), p.degree + 1});
     degree += p.degree;
     return *this;
   }
   /*
       description:
-          Divides this polynomial by another polynomial.
+          Divides this polynomial by another polynomial, see divmod.
       parameters:
-          p - the polynomial to divide by
+          p - the polynomial to divide by, of degree at least 1 and at most
+     the degree of this polynomial
       return:
           polynomial& - the result of the division
   */
@@ -97,46 +101,80 @@ struct polynomial {
     if ((p.degree > degree) || (p.degree == 0)) {
       throw std::invalid_argument("Division by invalid polynomial");
     }
-    std::vector<T> quo(degree - p.degree + 1, T{0});
-    for (std::size_t i = degree; i > p.degree - 1; i--) {
-      quo[i - p.degree] = coefficients[i] / p.coefficients[p.degree];
-      for (std::size_t j = 0; j < p.degree + 1; j++) {
-        coefficients[i - j] -= quo[i - p.degree] * p.coefficients[p.degree - j];
-      }
-    }
-    degree -= p.degree;
-    coefficients = quo;
+    *this = std::move(divmod(p).first);
     return *this;
   }
   /*
       description:
           Computes the remainder of this polynomial divided by another
-     polynomial. parameters: p - the polynomial to divide by return:
-     polynomial&
-     - the remainder polynomial
+     polynomial, see divmod.
+      parameters:
+          p - the polynomial to divide by
+      return:
+          polynomial& - the remainder polynomial
   */
   auto operator%=(const polynomial &p) -> polynomial & {
     if (p.degree == 0 && p.coefficients[0] == T{0}) {
       throw std::invalid_argument("Division by zero polynomial");
     }
-    *this -= (*this / p) * p;
+    *this = std::move(divmod(p).second);
     return *this;
   }
   /*
       description:
-          Evaluates the polynomial at a given value.
+          Divides this polynomial by another polynomial in a single pass,
+     with long division or, for long quotients and divisors, with Newton
+     inversion, see division.hpp. The remainder keeps as many coefficients as
+     this polynomial, its degree is that of its last nonzero coefficient.
+      parameters:
+          p - the polynomial to divide by, with a nonzero leading coefficient
+      return:
+          std::pair<polynomial, polynomial> - the quotient and the remainder
+  */
+  auto divmod(const polynomial &p) const -> std::pair<polynomial, polynomial> {
+    if (p.degree > degree) {
+      return {polynomial{{T{0}}, 0}, *this};
+    }
+    auto [quotient, low]{division::divmod(
+        std::span<const T>{coefficients.data(), degree + 1},
+        std::span<const T>{p.coefficients.data(), p.degree + 1})};
+    polynomial remainder{std::vector<T>(degree + 1, T{0}), 0};
+    for (std::size_t i = 0; i < low.size(); i++) {
+      remainder.coefficients[i] = low[i];
+      if (low[i] != T{0}) {
+        remainder.degree = i;
+      }
+    }
+    return {polynomial{std::move(quotient), degree - p.degree},
+            std::move(remainder)};
+  }
+  /*
+      description:
+          Evaluates the polynomial at a given value, by Estrin's scheme for
+     long polynomials and by Horner's scheme otherwise.
       parameters:
           value - the value at which to evaluate the polynomial
       return:
           T - the result of the evaluation
   */
  public:
-  auto operator()(T value) {
-    T result = 0;
-    for (int i = this->degree; i >= 0; --i) {
-      result = result * value + this->coefficients[i];
-    }
-    return result;
+  auto operator()(T value) const -> T {
+    return evaluation::evaluate(
+        std::span<const T>{coefficients.data(), degree + 1}, value);
+  }
+  /*
+      description:
+          Evaluates the polynomial at many points, by Horner's scheme run on
+     several points at once, for exact coefficients and large batches with
+     the subproduct tree; large batches are split among the cores, see
+     evaluation.hpp.
+      parameters:
+          xs - the points
+          out - the values, of the same size as xs
+  */
+  auto evaluate(std::span<const T> xs, std::span<T> out) const -> void {
+    evaluation::evaluate(std::span<const T>{coefficients.data(), degree + 1},
+                         xs, out);
   }
 };
 /*
@@ -149,7 +187,7 @@ struct polynomial {
         polynomial<T> - the result of the addition
 */
 template <typename T>
-inline auto operator+(polynomial<T> p, polynomial<T> q) {
+inline auto operator+(polynomial<T> p, const polynomial<T> &q) {
   p += q;
   return p;
 }
@@ -163,7 +201,7 @@ inline auto operator+(polynomial<T> p, polynomial<T> q) {
         polynomial<T> - the result of the subtraction
 */
 template <typename T>
-inline auto operator-(polynomial<T> p, polynomial<T> q) {
+inline auto operator-(polynomial<T> p, const polynomial<T> &q) {
   p -= q;
   return p;
 }
@@ -177,7 +215,7 @@ inline auto operator-(polynomial<T> p, polynomial<T> q) {
         polynomial<T> - the result of the multiplication
 */
 template <typename T>
-inline auto operator*(polynomial<T> p, polynomial<T> q) {
+inline auto operator*(polynomial<T> p, const polynomial<T> &q) {
   p *= q;
   return p;
 }
@@ -191,7 +229,7 @@ inline auto operator*(polynomial<T> p, polynomial<T> q) {
         polynomial<T> - the result of the division
 */
 template <typename T>
-inline auto operator/(polynomial<T> p, polynomial<T> q) {
+inline auto operator/(polynomial<T> p, const polynomial<T> &q) {
   p /= q;
   return p;
 }
@@ -202,7 +240,7 @@ inline auto operator/(polynomial<T> p, polynomial<T> q) {
    polynomial return: polynomial<T> - the remainder polynomial
 */
 template <typename T>
-inline auto operator%(polynomial<T> p, polynomial<T> q) {
+inline auto operator%(polynomial<T> p, const polynomial<T> &q) {
   p %= q;
   return p;
 }
@@ -215,9 +253,9 @@ inline auto operator%(polynomial<T> p, polynomial<T> q) {
    - a pair containing the quotient and the remainder
 */
 template <typename T>
-inline auto divide(polynomial<T> p, polynomial<T> q)
+inline auto divide(const polynomial<T> &p, const polynomial<T> &q)
     -> std::pair<polynomial<T>, polynomial<T>> {
-  return {p / q, p % q};
+  return p.divmod(q);
 }
 /*
     description:
@@ -277,6 +315,39 @@ inline auto root_rational_candidates(polynomial<T> p) -> std::set<T> {
   }
   return factors;
 }
+/*
+    description:
+        Finds the rational roots of a polynomial with integer coefficients.
+   Unlike root_rational_candidates, the candidates are filtered by the
+   Cauchy bound, by f(1) and f(-1) and modulo two primes before an exact
+   test, so coefficients with many divisors stay cheap, see roots.hpp.
+    parameters:
+        p - the polynomial
+    return:
+        std::vector<rational<T>> - the distinct rational roots in increasing
+   order
+*/
+template <std::signed_integral T>
+inline auto rational_roots(const polynomial<T> &p) -> std::vector<rational<T>> {
+  return roots::rational_roots(
+      std::span<const T>{p.coefficients.data(), p.degree + 1});
+}
+/*
+    description:
+        Finds the distinct real roots of the polynomial by Sturm sequence
+   isolation and Newton refinement, see roots.hpp.
+    parameters:
+        p - the polynomial
+        tolerance - relative accuracy of the roots
+    return:
+        std::vector<double> - the roots in increasing order
+*/
+template <typename T>
+inline auto real_roots(const polynomial<T> &p, double tolerance = 1e-12)
+    -> std::vector<double> {
+  return roots::real_roots(
+      std::span<const T>{p.coefficients.data(), p.degree + 1}, tolerance);
+}
 /*
     Description:
         Computes the greatest common divisor (GCD) of two polynomials using
@@ -297,12 +368,38 @@ inline auto gcd(polynomial<T> p, polynomial<T> q)
     -> std::pair<polynomial<T>, std::vector<T>> {
   std::vector<T> steps;
   while (q.degree > 0) {
-    auto [quotient, remainder] = divide(p, q);
-    p = q;
-    q = remainder;
+    auto remainder{std::move(divide(p, q).second)};
+    p = std::exchange(q, std::move(remainder));
     steps.push_back(p.degree);
   }
-  return {p, steps};
+  return {std::move(p), std::move(steps)};
+}
+/*
+    description:
+        Computes the greatest common divisor of two polynomials with the
+   half-GCD algorithm, which for high degrees takes O(M(n) log n) operations
+   for the cost M(n) of a multiplication instead of the O(n^2) of gcd. Meant
+   for exact field coefficients, e.g. rationals or residues modulo a prime;
+   floating point coefficients fall back to the Euclidean algorithm.
+    parameters:
+        p - the first polynomial
+        q - the second polynomial
+    return:
+        polynomial<T> - the GCD of the two polynomials, not normalized
+*/
+template <typename T>
+inline auto fast_gcd(const polynomial<T> &p, const polynomial<T> &q)
+    -> polynomial<T> {
+  auto result{division::fast_gcd(
+      std::vector<T>(p.coefficients.begin(),
+                     p.coefficients.begin() + p.degree + 1),
+      std::vector<T>(q.coefficients.begin(),
+                     q.coefficients.begin() + q.degree + 1))};
+  if (result.empty()) {
+    return polynomial<T>{{T{0}}, 0};
+  }
+  const std::size_t degree{result.size() - 1};
+  return polynomial<T>{std::move(result), degree};
 }
 }  // namespace polynomial
 /*
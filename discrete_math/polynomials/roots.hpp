@@ -0,0 +1,460 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../euclidean_algorithm/big_integer.hpp"
+#include "../rational/rational.hpp"
+#include "division.hpp"
+#include "evaluation.hpp"
+
+namespace polynomial::roots {
+/*
+    description:
+        Primes of the modular filter of rational_roots: a candidate p / q is
+   tested exactly only if q^n f(p / q) vanishes modulo both of them.
+*/
+inline constexpr std::uint64_t filter_prime_1{998244353};
+inline constexpr std::uint64_t filter_prime_2{1000000007};
+
+/*
+    description:
+        Positive divisors of value > 0 in increasing order, generated from
+   its factorisation by trial division instead of testing every number up
+   to value.
+*/
+inline auto divisors(std::uint64_t value) -> std::vector<std::uint64_t> {
+  std::vector<std::uint64_t> result{1};
+  const auto multiply_in{[&](std::uint64_t prime, std::size_t exponent) {
+    const std::size_t size{result.size()};
+    std::uint64_t power{1};
+    for (std::size_t e = 0; e < exponent; e++) {
+      power *= prime;
+      for (std::size_t i = 0; i < size; i++) {
+        result.push_back(result[i] * power);
+      }
+    }
+  }};
+  for (std::uint64_t prime = 2; prime <= value / prime; prime++) {
+    std::size_t exponent{0};
+    while (value % prime == 0) {
+      value /= prime;
+      exponent++;
+    }
+    multiply_in(prime, exponent);
+  }
+  if (value > 1) {
+    multiply_in(value, 1);
+  }
+  std::ranges::sort(result);
+  return result;
+}
+
+/*
+    description:
+        Value of f at 1 or -1, the second element is false on overflow.
+*/
+template <std::signed_integral T>
+auto value_at_unit(std::span<const T> c, bool negative)
+    -> std::pair<T, bool> {
+  T result{0};
+  for (std::size_t i = 0; i < c.size(); i++) {
+    const T term{negative && i % 2 == 1 ? static_cast<T>(-c[i]) : c[i]};
+    if (__builtin_add_overflow(result, term, &result)) {
+      return {T{0}, false};
+    }
+  }
+  return {result, true};
+}
+
+/*
+    description:
+        Values of q^n f(p / q) modulo mod for all candidates at once: p / q
+   is mapped to p q^(-1) and the polynomial is evaluated by Horner's scheme
+   with the loop over the candidates innermost. Candidates with q divisible
+   by mod cannot be tested and pass.
+    return:
+        std::vector<bool> - whether each candidate passes
+*/
+template <std::uint64_t mod, std::signed_integral T>
+auto modular_filter(std::span<const T> c, std::span<const T> ps,
+                    std::span<const T> qs) -> std::vector<bool> {
+  const auto reduce{[](T value) {
+    const auto m{static_cast<std::int64_t>(mod)};
+    return static_cast<std::uint64_t>(
+        (static_cast<std::int64_t>(value) % m + m) % m);
+  }};
+  std::vector<std::uint64_t> points(ps.size());
+  std::vector<bool> testable(ps.size());
+  for (std::size_t k = 0; k < ps.size(); k++) {
+    const std::uint64_t q{reduce(qs[k])};
+    testable[k] = q != 0;
+    points[k] = reduce(ps[k]) *
+                number_theory::modular_pow<mod>(q, mod - 2) % mod;
+  }
+  std::vector<std::uint64_t> values(ps.size(), 0);
+  for (std::size_t i = c.size(); i > 0; i--) {
+    const std::uint64_t coefficient{reduce(c[i - 1])};
+    for (std::size_t k = 0; k < values.size(); k++) {
+      values[k] = (values[k] * points[k] + coefficient) % mod;
+    }
+  }
+  std::vector<bool> passes(ps.size());
+  for (std::size_t k = 0; k < ps.size(); k++) {
+    passes[k] = !testable[k] || values[k] == 0;
+  }
+  return passes;
+}
+
+/*
+    description:
+        q^n f(p / q) = sum of c_i p^i q^(n - i) evaluated by Horner's scheme
+   in arbitrary precision, so the test whether p / q is a root is exact
+   whatever the size of the intermediate values.
+*/
+template <std::signed_integral T>
+auto vanishes_exactly(std::span<const T> c, T p, T q) -> bool {
+  using algorithms::big_integer;
+  const big_integer numerator{p};
+  const big_integer denominator{q};
+  big_integer value{c.back()};
+  big_integer power{1};
+  for (std::size_t i = c.size() - 1; i > 0; i--) {
+    power *= denominator;
+    value = value * numerator + big_integer{c[i - 1]} * power;
+  }
+  return value.is_zero();
+}
+
+/*
+    description:
+        Exact test of the root p / q, gcd(p, q) = 1: by Gauss's lemma it is
+   a root iff q x - p divides f over the integers, so f is divided by
+   q x - p and every step has to be exact. If an intermediate value
+   overflows T the division is abandoned and the candidate is decided by
+   vanishes_exactly instead.
+*/
+template <std::signed_integral T>
+auto divides(std::span<const T> c, T p, T q) -> bool {
+  const std::size_t n{c.size() - 1};
+  if (c[n] % q != 0) {
+    return false;
+  }
+  T g{static_cast<T>(c[n] / q)};
+  for (std::size_t i = n - 1; i > 0; i--) {
+    T t{};
+    if (__builtin_mul_overflow(p, g, &t) ||
+        __builtin_add_overflow(t, c[i], &t)) {
+      return vanishes_exactly(c, p, q);
+    }
+    if (t % q != 0) {
+      return false;
+    }
+    g = static_cast<T>(t / q);
+  }
+  T t{};
+  if (__builtin_mul_overflow(p, g, &t) ||
+      __builtin_add_overflow(t, c[0], &t)) {
+    return vanishes_exactly(c, p, q);
+  }
+  return t == 0;
+}
+
+/*
+    description:
+        Rational roots of a polynomial with integer coefficients. The
+   candidates p / q, p | a_0, q | a_n, are built from the factorisations of
+   a_0 and a_n and pass cheap filters before any evaluation: |p / q| below
+   the Cauchy bound, (q - p) | f(1) and (q + p) | f(-1). The survivors are
+   evaluated modulo two primes in batches split among the cores, and only
+   those which vanish modulo both are divided out exactly.
+    parameters:
+        c - the coefficients, starting from x^0, with c.back() != 0
+    return:
+        std::vector<rational<T>> - the distinct rational roots in increasing
+   order
+*/
+template <std::signed_integral T>
+auto rational_roots(std::span<const T> c) -> std::vector<rational<T>> {
+  std::vector<rational<T>> roots;
+  std::size_t low{0};
+  while (low < c.size() && c[low] == T{0}) {
+    low++;
+  }
+  if (low > 0) {
+    roots.push_back({T{0}, T{1}});
+  }
+  c = c.subspan(low);
+  if (c.size() < 2) {
+    return roots;
+  }
+  const auto magnitude{[](T value) {
+    return value < 0 ? static_cast<std::uint64_t>(-(value + 1)) + 1
+                     : static_cast<std::uint64_t>(value);
+  }};
+  double bound{0};
+  for (std::size_t i = 0; i + 1 < c.size(); i++) {
+    bound = std::max(bound, std::abs(static_cast<double>(c[i]) /
+                                     static_cast<double>(c.back())));
+  }
+  bound += 1;
+  const auto [at_one, one_exact]{value_at_unit(c, false)};
+  const auto [at_minus_one, minus_one_exact]{value_at_unit(c, true)};
+  const auto divides_value{[](bool exact, T value, T a, T b) {
+    T divisor{};
+    return !exact || __builtin_add_overflow(a, b, &divisor) || divisor == 0 ||
+           value % divisor == 0;
+  }};
+  const auto passes_units{[&](T p, T q) {
+    return divides_value(one_exact, at_one, q, static_cast<T>(-p)) &&
+           divides_value(minus_one_exact, at_minus_one, q, p);
+  }};
+  std::vector<T> ps;
+  std::vector<T> qs;
+  const auto max{static_cast<std::uint64_t>(std::numeric_limits<T>::max())};
+  const auto numerators{divisors(magnitude(c.front()))};
+  for (const auto q : divisors(magnitude(c.back()))) {
+    for (const auto p : numerators) {
+      if (p > max || q > max || std::gcd(p, q) != 1 ||
+          static_cast<double>(p) > bound * static_cast<double>(q)) {
+        continue;
+      }
+      for (const T signed_p : {static_cast<T>(p), static_cast<T>(-p)}) {
+        if (passes_units(signed_p, static_cast<T>(q))) {
+          ps.push_back(signed_p);
+          qs.push_back(static_cast<T>(q));
+        }
+      }
+    }
+  }
+  std::vector<char> is_root(ps.size(), 0);
+  evaluation::parallel_chunks(
+      ps.size(), ps.size() * c.size(),
+      [&](std::size_t start, std::size_t size) {
+        const std::span<const T> chunk_ps{ps.data() + start, size};
+        const std::span<const T> chunk_qs{qs.data() + start, size};
+        const auto first{modular_filter<filter_prime_1>(c, chunk_ps,
+                                                        chunk_qs)};
+        const auto second{modular_filter<filter_prime_2>(c, chunk_ps,
+                                                         chunk_qs)};
+        for (std::size_t k = 0; k < size; k++) {
+          is_root[start + k] = static_cast<char>(
+              first[k] && second[k] && divides(c, chunk_ps[k], chunk_qs[k]));
+        }
+      });
+  for (std::size_t k = 0; k < ps.size(); k++) {
+    if (is_root[k] != 0) {
+      roots.push_back({ps[k], qs[k]});
+    }
+  }
+  std::ranges::sort(roots);
+  return roots;
+}
+
+/*
+    description:
+        Sturm sequence of f: f, f', then the negated remainders of the
+   Euclidean algorithm. Every polynomial is scaled to the largest absolute
+   coefficient 1 and coefficients below tolerance are dropped, so the
+   sequence stays usable in floating point for moderate degrees.
+*/
+inline auto sturm_sequence(std::span<const double> c, double tolerance = 1e-12)
+    -> std::vector<std::vector<double>> {
+  const auto normalized{[tolerance](std::vector<double> p) {
+    double scale{0};
+    for (const auto x : p) {
+      scale = std::max(scale, std::abs(x));
+    }
+    for (auto &x : p) {
+      x = std::abs(x) <= tolerance * scale ? 0.0 : x / scale;
+    }
+    while (!p.empty() && p.back() == 0.0) {
+      p.pop_back();
+    }
+    return p;
+  }};
+  std::vector<std::vector<double>> sequence{
+      normalized(std::vector<double>(c.begin(), c.end()))};
+  std::vector<double> derivative;
+  for (std::size_t i = 1; i < sequence[0].size(); i++) {
+    derivative.push_back(static_cast<double>(i) * sequence[0][i]);
+  }
+  derivative = normalized(std::move(derivative));
+  while (!derivative.empty()) {
+    sequence.push_back(std::move(derivative));
+    const auto &a{sequence[sequence.size() - 2]};
+    const auto &b{sequence.back()};
+    if (b.size() == 1) {
+      break;
+    }
+    auto remainder{division::long_division(std::span<const double>{a},
+                                           std::span<const double>{b})
+                       .second};
+    for (auto &x : remainder) {
+      x = -x;
+    }
+    derivative = normalized(std::move(remainder));
+  }
+  return sequence;
+}
+
+/*
+    description:
+        Number of sign changes of the Sturm sequence at x, zeros skipped.
+   The difference at a < b is the number of distinct real roots in (a, b].
+*/
+inline auto sign_changes(const std::vector<std::vector<double>> &sequence,
+                         double x) -> std::size_t {
+  std::size_t changes{0};
+  int last{0};
+  for (const auto &p : sequence) {
+    const double value{evaluation::horner(std::span<const double>{p}, x)};
+    const int sign{(value > 0) - (value < 0)};
+    if (sign != 0) {
+      changes += static_cast<std::size_t>(last != 0 && sign != last);
+      last = sign;
+    }
+  }
+  return changes;
+}
+
+/*
+    description:
+        Isolates the distinct real roots: the interval (-B, B] given by the
+   Cauchy bound B is bisected until every piece holds exactly one root by
+   Sturm's theorem. Clusters narrower than tolerance are kept as one
+   interval.
+    return:
+        std::vector<std::pair<double, double>> - intervals (a, b] in
+   increasing order, each holding one root
+*/
+inline auto isolate_real_roots(const std::vector<std::vector<double>> &sequence,
+                               double tolerance = 1e-12)
+    -> std::vector<std::pair<double, double>> {
+  const auto &f{sequence[0]};
+  std::vector<std::pair<double, double>> isolated;
+  if (f.size() < 2) {
+    return isolated;
+  }
+  double bound{0};
+  for (std::size_t i = 0; i + 1 < f.size(); i++) {
+    bound = std::max(bound, std::abs(f[i] / f.back()));
+  }
+  bound += 1;
+  struct piece {
+    double a, b;
+    std::size_t at_a, at_b;
+  };
+  std::vector<piece> stack{
+      {-bound, bound, sign_changes(sequence, -bound),
+       sign_changes(sequence, bound)}};
+  while (!stack.empty()) {
+    const auto [a, b, at_a, at_b]{stack.back()};
+    stack.pop_back();
+    const std::size_t count{at_a - at_b};
+    if (count == 0) {
+      continue;
+    }
+    if (count == 1 || b - a <= tolerance * (1 + std::abs(a))) {
+      isolated.emplace_back(a, b);
+      continue;
+    }
+    const double middle{a + (b - a) / 2};
+    const std::size_t at_middle{sign_changes(sequence, middle)};
+    stack.push_back({middle, b, at_middle, at_b});
+    stack.push_back({a, middle, at_a, at_middle});
+  }
+  return isolated;
+}
+
+/*
+    description:
+        Refines the root in (a, b]: Newton's method kept inside the bracket
+   by bisection once f changes sign on it, bisection by Sturm counts before
+   that, e.g. for roots of even multiplicity.
+*/
+inline auto refine_root(const std::vector<std::vector<double>> &sequence,
+                        std::pair<double, double> interval,
+                        double tolerance = 1e-12) -> double {
+  const std::span<const double> f{sequence[0]};
+  std::vector<double> derivative;
+  for (std::size_t i = 1; i < f.size(); i++) {
+    derivative.push_back(static_cast<double>(i) * f[i]);
+  }
+  auto [a, b]{interval};
+  const double at_b{evaluation::horner(f, b)};
+  if (at_b == 0) {
+    return b;
+  }
+  const auto changes_sign{[&] {
+    const double at_a{evaluation::horner(f, a)};
+    return at_a != 0 && (at_a < 0) != (at_b < 0);
+  }};
+  bool bracketed{changes_sign()};
+  const std::size_t changes_b{sign_changes(sequence, b)};
+  double x{a + (b - a) / 2};
+  for (int iteration = 0;
+       iteration < 200 && b - a > tolerance * (1 + std::abs(x)); iteration++) {
+    if (!bracketed) {
+      (sign_changes(sequence, x) > changes_b ? a : b) = x;
+      x = a + (b - a) / 2;
+      bracketed = changes_sign();
+      continue;
+    }
+    const double value{evaluation::horner(f, x)};
+    if (value == 0) {
+      return x;
+    }
+    ((value < 0) == (at_b < 0) ? b : a) = x;
+    const double slope{
+        evaluation::horner(std::span<const double>{derivative}, x)};
+    const double newton{x - value / slope};
+    if (slope != 0 && newton > a && newton < b) {
+      if (std::abs(newton - x) <= tolerance * (1 + std::abs(x))) {
+        return newton;
+      }
+      x = newton;
+    } else {
+      x = a + (b - a) / 2;
+    }
+  }
+  return x;
+}
+
+/*
+    description:
+        Distinct real roots of a polynomial: isolation with a Sturm
+   sequence, then refinement of the isolating intervals, split among the
+   cores for many roots. The sequence is computed in floating point, so a
+   root of multiplicity k is only resolved to about the k-th root of the
+   machine precision and may be reported as a cluster of close roots.
+    parameters:
+        c - the coefficients, starting from x^0
+        tolerance - relative width at which refinement stops
+    return:
+        std::vector<double> - the roots in increasing order
+*/
+template <typename T>
+auto real_roots(std::span<const T> c, double tolerance = 1e-12)
+    -> std::vector<double> {
+  const std::vector<double> f(c.begin(), c.end());
+  const auto sequence{sturm_sequence(f)};
+  const auto intervals{isolate_real_roots(sequence, tolerance)};
+  std::vector<double> roots(intervals.size());
+  evaluation::parallel_chunks(
+      intervals.size(), intervals.size() * f.size() * 64,
+      [&](std::size_t start, std::size_t size) {
+        for (std::size_t i = start; i < start + size; i++) {
+          roots[i] = refine_root(sequence, intervals[i], tolerance);
+        }
+      });
+  return roots;
+}
+}  // namespace polynomial::roots
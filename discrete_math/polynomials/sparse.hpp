@@ -0,0 +1,355 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "polynomial.hpp"
+
+namespace polynomial {
+/*
+    description:
+        A polynomial is stored sparse when its length degree + 1 exceeds
+   sparse_ratio times its number of nonzero terms.
+*/
+inline constexpr std::size_t sparse_ratio{8};
+
+template <typename T>
+struct term {
+  std::size_t exponent{};
+  T coefficient{};
+
+  friend auto operator==(const term &, const term &) -> bool = default;
+};
+
+/*
+    description:
+        Polynomial stored as its nonzero terms sorted by increasing exponent,
+   the zero polynomial has no terms. Memory and the cost of the arithmetic
+   depend on the number of terms, not on the degree, so x^1000000 + 1 takes
+   two terms.
+*/
+template <typename T>
+struct sparse_polynomial {
+ public:
+  std::vector<term<T>> terms{};
+
+ public:
+  /*
+      description:
+          Degree of the polynomial, 0 for the zero polynomial.
+  */
+  [[nodiscard]] auto degree() const -> std::size_t {
+    return terms.empty() ? 0 : terms.back().exponent;
+  }
+  /*
+      description:
+          Adds another polynomial to this polynomial by merging the two
+     sorted term sequences, in O(number of terms).
+      parameters:
+          p - the polynomial to be added
+      return:
+          sparse_polynomial& - the result of the addition
+  */
+  auto operator+=(const sparse_polynomial &p) -> sparse_polynomial & {
+    std::vector<term<T>> sum;
+    sum.reserve(terms.size() + p.terms.size());
+    auto i{terms.begin()};
+    auto j{p.terms.begin()};
+    while (i != terms.end() || j != p.terms.end()) {
+      if (j == p.terms.end() ||
+          (i != terms.end() && i->exponent < j->exponent)) {
+        sum.push_back(*i++);
+      } else if (i == terms.end() || j->exponent < i->exponent) {
+        sum.push_back(*j++);
+      } else {
+        const T coefficient{i->coefficient + j->coefficient};
+        if (coefficient != T{0}) {
+          sum.push_back({i->exponent, coefficient});
+        }
+        ++i;
+        ++j;
+      }
+    }
+    terms = std::move(sum);
+    return *this;
+  }
+  /*
+      description:
+          Negates the polynomial.
+      return:
+          sparse_polynomial - the negated polynomial
+  */
+  auto operator-() const -> sparse_polynomial {
+    auto copy{*this};
+    for (auto &t : copy.terms) {
+      t.coefficient = T{0} - t.coefficient;
+    }
+    return copy;
+  }
+  /*
+      description:
+          Subtracts another polynomial from this polynomial.
+      parameters:
+          p - the polynomial to be subtracted
+      return:
+          sparse_polynomial& - the result of the subtraction
+  */
+  auto operator-=(const sparse_polynomial &p) -> sparse_polynomial & {
+    return operator+=(-p);
+  }
+  /*
+      description:
+          Multiplies this polynomial by another polynomial with a heap: each
+     term of the shorter factor walks along the longer factor and the heap
+     always yields the smallest pending exponent, so the product comes out
+     sorted and equal exponents are added at once. Takes O(n m log(min(n,
+     m))) operations for n and m terms, independent of the degrees.
+      parameters:
+          p - the polynomial to be multiplied
+      return:
+          sparse_polynomial& - the result of the multiplication
+  */
+  auto operator*=(const sparse_polynomial &p) -> sparse_polynomial & {
+    const auto &a{terms.size() <= p.terms.size() ? terms : p.terms};
+    const auto &b{terms.size() <= p.terms.size() ? p.terms : terms};
+    std::vector<term<T>> product;
+    if (!a.empty()) {
+      using entry = std::pair<std::size_t, std::size_t>;
+      std::priority_queue<entry, std::vector<entry>, std::greater<>> heap;
+      std::vector<std::size_t> next(a.size(), 0);
+      for (std::size_t i = 0; i < a.size(); i++) {
+        heap.emplace(a[i].exponent + b[0].exponent, i);
+      }
+      while (!heap.empty()) {
+        const auto [exponent, i]{heap.top()};
+        heap.pop();
+        const T coefficient{a[i].coefficient * b[next[i]].coefficient};
+        if (!product.empty() && product.back().exponent == exponent) {
+          product.back().coefficient += coefficient;
+        } else {
+          if (!product.empty() && product.back().coefficient == T{0}) {
+            product.pop_back();
+          }
+          product.push_back({exponent, coefficient});
+        }
+        if (++next[i] < b.size()) {
+          heap.emplace(a[i].exponent + b[next[i]].exponent, i);
+        }
+      }
+      if (product.back().coefficient == T{0}) {
+        product.pop_back();
+      }
+    }
+    terms = std::move(product);
+    return *this;
+  }
+  /*
+      description:
+          Evaluates the polynomial at a given value, the power of value is
+     carried from term to term by squaring over the gaps between exponents.
+      parameters:
+          value - the value at which to evaluate the polynomial
+      return:
+          T - the result of the evaluation
+  */
+  auto operator()(T value) const -> T {
+    T result{0};
+    T power{1};
+    std::size_t exponent{0};
+    for (const auto &t : terms) {
+      T base{value};
+      for (std::size_t gap = t.exponent - exponent; gap > 0; gap /= 2) {
+        if (gap % 2 == 1) {
+          power *= base;
+        }
+        base *= base;
+      }
+      exponent = t.exponent;
+      result += t.coefficient * power;
+    }
+    return result;
+  }
+};
+
+template <typename T>
+inline auto operator+(sparse_polynomial<T> p, const sparse_polynomial<T> &q) {
+  p += q;
+  return p;
+}
+
+template <typename T>
+inline auto operator-(sparse_polynomial<T> p, const sparse_polynomial<T> &q) {
+  p -= q;
+  return p;
+}
+
+template <typename T>
+inline auto operator*(sparse_polynomial<T> p, const sparse_polynomial<T> &q) {
+  p *= q;
+  return p;
+}
+
+/*
+    description:
+        Converts a dense polynomial to the sparse representation.
+*/
+template <typename T>
+inline auto to_sparse(const polynomial<T> &p) -> sparse_polynomial<T> {
+  sparse_polynomial<T> result{};
+  for (std::size_t i = 0; i <= p.degree && i < p.coefficients.size(); i++) {
+    if (p.coefficients[i] != T{0}) {
+      result.terms.push_back({i, p.coefficients[i]});
+    }
+  }
+  return result;
+}
+
+/*
+    description:
+        Converts a sparse polynomial to the dense representation.
+*/
+template <typename T>
+inline auto to_dense(const sparse_polynomial<T> &p) -> polynomial<T> {
+  polynomial<T> result{std::vector<T>(p.degree() + 1, T{0}), p.degree()};
+  for (const auto &t : p.terms) {
+    result.coefficients[t.exponent] = t.coefficient;
+  }
+  return result;
+}
+
+/*
+    description:
+        Checks whether a polynomial of the given degree with at most the
+   given number of nonzero terms should be stored sparse.
+*/
+inline constexpr auto prefers_sparse(std::size_t terms, std::size_t degree)
+    -> bool {
+  return degree / sparse_ratio >= terms;
+}
+
+/*
+    description:
+        Polynomial which holds either representation and switches between
+   them after every operation, by the density of the result. Operations on
+   two sparse operands stay sparse, mixed operations are done in the
+   representation the size of the result favours.
+*/
+template <typename T>
+struct adaptive_polynomial {
+ public:
+  std::variant<polynomial<T>, sparse_polynomial<T>> representation{
+      polynomial<T>{{T{0}}, 0}};
+
+ public:
+  [[nodiscard]] auto is_sparse() const -> bool {
+    return std::holds_alternative<sparse_polynomial<T>>(representation);
+  }
+  [[nodiscard]] auto degree() const -> std::size_t {
+    return std::visit(
+        [](const auto &p) -> std::size_t {
+          if constexpr (requires { p.degree(); }) {
+            return p.degree();
+          } else {
+            return p.degree;
+          }
+        },
+        representation);
+  }
+  [[nodiscard]] auto term_count() const -> std::size_t {
+    if (is_sparse()) {
+      return std::get<sparse_polynomial<T>>(representation).terms.size();
+    }
+    const auto &p{std::get<polynomial<T>>(representation)};
+    return static_cast<std::size_t>(std::count_if(
+        p.coefficients.begin(), p.coefficients.begin() + p.degree + 1,
+        [](const T &c) { return c != T{0}; }));
+  }
+  [[nodiscard]] auto sparse() const -> sparse_polynomial<T> {
+    return is_sparse() ? std::get<sparse_polynomial<T>>(representation)
+                       : to_sparse(std::get<polynomial<T>>(representation));
+  }
+  [[nodiscard]] auto dense() const -> polynomial<T> {
+    return is_sparse() ? to_dense(std::get<sparse_polynomial<T>>(representation))
+                       : std::get<polynomial<T>>(representation);
+  }
+  /*
+      description:
+          Stores the polynomial in the representation its density favours.
+  */
+  auto normalize() -> adaptive_polynomial & {
+    const bool sparse_wanted{prefers_sparse(term_count(), degree())};
+    if (sparse_wanted && !is_sparse()) {
+      representation = sparse();
+    } else if (!sparse_wanted && is_sparse()) {
+      representation = dense();
+    }
+    return *this;
+  }
+  auto operator+=(const adaptive_polynomial &p) -> adaptive_polynomial & {
+    return combine(p, term_count() + p.term_count(),
+                   std::max(degree(), p.degree()),
+                   [](auto &a, const auto &b) { a += b; });
+  }
+  auto operator-=(const adaptive_polynomial &p) -> adaptive_polynomial & {
+    return combine(p, term_count() + p.term_count(),
+                   std::max(degree(), p.degree()),
+                   [](auto &a, const auto &b) { a -= b; });
+  }
+  auto operator*=(const adaptive_polynomial &p) -> adaptive_polynomial & {
+    return combine(p, term_count() * p.term_count(), degree() + p.degree(),
+                   [](auto &a, const auto &b) { a *= b; });
+  }
+  auto operator()(T value) const -> T {
+    return std::visit([&](const auto &p) { return p(value); },
+                      representation);
+  }
+
+ private:
+  /*
+      description:
+          Applies the operation in the sparse representation if both
+     operands are sparse or the bound on the number of terms of the result
+     favours it, in the dense one otherwise, then normalizes.
+  */
+  template <typename Operation>
+  auto combine(const adaptive_polynomial &p, std::size_t terms,
+               std::size_t degree, Operation operation)
+      -> adaptive_polynomial & {
+    if ((is_sparse() && p.is_sparse()) || prefers_sparse(terms, degree)) {
+      auto result{sparse()};
+      operation(result, p.sparse());
+      representation = std::move(result);
+    } else {
+      auto result{dense()};
+      operation(result, p.dense());
+      representation = std::move(result);
+    }
+    return normalize();
+  }
+};
+
+template <typename T>
+inline auto operator+(adaptive_polynomial<T> p,
+                      const adaptive_polynomial<T> &q) {
+  p += q;
+  return p;
+}
+
+template <typename T>
+inline auto operator-(adaptive_polynomial<T> p,
+                      const adaptive_polynomial<T> &q) {
+  p -= q;
+  return p;
+}
+
+template <typename T>
+inline auto operator*(adaptive_polynomial<T> p,
+                      const adaptive_polynomial<T> &q) {
+  p *= q;
+  return p;
+}
+}  // namespace polynomial
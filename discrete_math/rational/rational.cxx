@@ -0,0 +1,26 @@
+module;
+#include <format>
+
+#include "rational.hpp"
+
+export module rational;
+
+
+/*
+    description:
+        module interface of rational.hpp, the header itself is included by the
+   header only projects which can not import modules
+*/
+export using ::add_all;
+export using ::binary_gcd;
+export using ::lazy_rational;
+export using ::multiply_all;
+export using ::normalize_all;
+export using ::rational;
+export using ::subtract_multiple;
+
+
+// names the formatters of the header in the purview, which keeps them
+// reachable for the importers of the module
+static_assert(std::formattable<rational<int>, char>);
+static_assert(std::formattable<lazy_rational<int>, char>);
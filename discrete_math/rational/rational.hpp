@@ -0,0 +1,480 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace rational_detail {
+
+    /*
+        description:
+            absolute value of i as an unsigned integer, also for the smallest
+       signed value
+    */
+    template <std::integral I>
+    constexpr auto magnitude(I i) noexcept -> std::make_unsigned_t<I> {
+        using U = std::make_unsigned_t<I>;
+        return i < 0 ? static_cast<U>(U{0} - static_cast<U>(i))
+                     : static_cast<U>(i);
+    }
+
+
+    /*
+        description:
+            integer type twice as wide as I used for the intermediate values
+       of + - and of comparisons, 128-bit for 64-bit I when the compiler has
+       it and I itself otherwise
+    */
+    template <std::integral I>
+    struct wider {
+        using type = I;
+    };
+
+    template <std::integral I>
+    requires(sizeof(I) <= 4)
+    struct wider<I> {
+        using type = std::
+            conditional_t<std::is_signed_v<I>, std::int64_t, std::uint64_t>;
+    };
+
+#ifdef __SIZEOF_INT128__
+    template <std::integral I>
+    requires(sizeof(I) == 8)
+    struct wider<I> {
+        using type = std::
+            conditional_t<std::is_signed_v<I>, __int128, unsigned __int128>;
+    };
+#endif
+
+    template <std::integral I>
+    using wider_t = typename wider<I>::type;
+
+}  // namespace rational_detail
+
+
+/*
+    description:
+        greatest common divisor of |a| and |b| computed with the binary (Stein)
+   algorithm, it uses shifts, subtractions and min/max instead of divisions.
+   The result is unsigned: for a signed I, gcd(INT_MIN, 0) and gcd(INT_MIN,
+   INT_MIN) are -INT_MIN, which I can not hold
+*/
+template <std::integral I>
+constexpr auto binary_gcd(I a, I b) noexcept -> std::make_unsigned_t<I> {
+    auto u{rational_detail::magnitude(a)};
+    auto v{rational_detail::magnitude(b)};
+    if (u == 0) { return v; }
+    if (v == 0) { return u; }
+    if (u == 1 || v == 1) { return 1; }
+    const int shift{std::countr_zero(static_cast<decltype(u)>(u | v))};
+    u >>= std::countr_zero(u);
+    do {
+        v >>= std::countr_zero(v);
+        const auto smaller{std::min(u, v)};
+        v = std::max(u, v) - smaller;
+        u = smaller;
+    } while (v != 0);
+    return static_cast<decltype(u)>(u << shift);
+}
+
+
+/*
+    description:
+        rational number kept in lowest terms with a positive denominator. It
+   is an aggregate and trivially copyable, every operation is constexpr and
+   noexcept except the divisions, which throw std::invalid_argument for a
+   zero divisor instead of producing a zero denominator. Products
+   cross-cancel their operands (gcd(a, d), gcd(c, b)) and sums use Henrici's
+   scheme with the numerator formed in a twice as wide integer, so
+   operations on reduced rationals give reduced results and only overflow
+   when the result itself does not fit into I
+    members:
+        I numerator
+        I denominator - positive
+*/
+template <std::integral I>
+struct rational {
+    I numerator{0};
+    I denominator{1};
+
+
+    /*
+        description:
+            brings the rational to lowest terms with a positive denominator.
+       The magnitudes are divided as unsigned integers and the sign is put
+       back on the numerator, so INT_MIN in either member is reduced without
+       overflow; only a reduced denominator of -INT_MIN, e.g. in {1,
+       INT_MIN}, can not be made positive and stays INT_MIN
+    */
+    constexpr void reduce() noexcept {
+        const bool negative{(numerator < 0) != (denominator < 0)};
+        auto n{rational_detail::magnitude(numerator)};
+        auto d{rational_detail::magnitude(denominator)};
+        const auto divider{binary_gcd(numerator, denominator)};
+        if (divider > 1) {
+            n /= divider;
+            d /= divider;
+        }
+        numerator = static_cast<I>(negative ? decltype(n){0} - n : n);
+        denominator = static_cast<I>(d);
+    }
+
+
+    constexpr auto operator-=(I i) noexcept -> rational& {
+        numerator -= i * denominator;
+        return *this;
+    }
+
+
+    constexpr auto operator-() const noexcept -> rational {
+        return {-numerator, denominator};
+    }
+
+
+    friend constexpr auto operator+(rational f, rational g) noexcept
+        -> rational {
+        return add(f, g, I{1});
+    }
+
+
+    friend constexpr auto operator-(rational f, rational g) noexcept
+        -> rational {
+        return add(f, g, I{-1});
+    }
+
+
+    friend constexpr auto operator*(rational f, rational g) noexcept
+        -> rational {
+        return multiply(f, g);
+    }
+
+
+    /*throws std::invalid_argument if g is zero*/
+    friend constexpr auto operator/(rational f, rational g) -> rational {
+        if (g.numerator == 0) {
+            throw std::invalid_argument("Division by zero rational.");
+        }
+        return multiply(f, rational{g.denominator, g.numerator});
+    }
+
+
+    friend constexpr auto operator*(rational f, I g) noexcept -> rational {
+        return multiply(f, rational{g, 1});
+    }
+
+
+    /*throws std::invalid_argument if g is zero*/
+    friend constexpr auto operator/(rational f, I g) -> rational {
+        if (g == 0) { throw std::invalid_argument("Division by zero."); }
+        return multiply(f, rational{1, g});
+    }
+
+
+    friend constexpr auto operator+=(rational& f, rational g) noexcept
+        -> rational {
+        return f = f + g;
+    }
+
+
+    friend constexpr auto operator-=(rational& f, rational g) noexcept
+        -> rational {
+        return f = f - g;
+    }
+
+
+    friend constexpr auto operator*=(rational& f, rational g) noexcept
+        -> rational {
+        return f = f * g;
+    }
+
+
+    friend constexpr auto operator/=(rational& f, rational g) -> rational {
+        return f = f / g;
+    }
+
+
+    friend constexpr auto operator*=(rational& f, I g) noexcept -> rational {
+        return f = f * g;
+    }
+
+
+    friend constexpr auto operator/=(rational& f, I g) -> rational {
+        return f = f / g;
+    }
+
+
+    /*
+        description:
+            equality and ordering compare the values by cross multiplying in
+       the wide type, so a rational built with an unreduced aggregate
+       initialiser, e.g. {2, 4}, equals its lowest terms {1, 2}. The two are
+       equivalent but not interchangeable (they print differently), hence
+       the weak ordering
+    */
+    friend constexpr auto operator==(rational f, rational g) noexcept
+        -> bool {
+        using W = rational_detail::wider_t<I>;
+        return W{f.numerator} * g.denominator ==
+               W{g.numerator} * f.denominator;
+    }
+
+
+    friend constexpr auto operator<=>(rational f, rational g) noexcept
+        -> std::weak_ordering {
+        using W = rational_detail::wider_t<I>;
+        return W{f.numerator} * g.denominator <=>
+               W{g.numerator} * f.denominator;
+    }
+
+  private:
+    // gcd which is never 0, so that it can always be divided by; one of
+    // the arguments is always a positive denominator, so the gcd fits into I
+    static constexpr auto divisor(I a, I b) noexcept -> I {
+        const auto d{binary_gcd(a, b)};
+        return d == 0 ? I{1} : static_cast<I>(d);
+    }
+
+
+    /*f + sign * g (Henrici): with d1 = gcd(f.denominator, g.denominator) the
+     * numerator t = f.numerator * g.denominator / d1 + sign * g.numerator *
+     * f.denominator / d1 is formed in the wide type and cancelled by
+     * d2 = gcd(t, d1) = gcd(t mod d1, d1)*/
+    static constexpr auto add(rational f, rational g, I sign) noexcept
+        -> rational {
+        using W = rational_detail::wider_t<I>;
+        const I d1{divisor(f.denominator, g.denominator)};
+        const I f_part{f.denominator / d1};
+        const I g_part{g.denominator / d1};
+        const W t{W{f.numerator} * g_part + W{sign} * g.numerator * f_part};
+        if (t == 0) { return {0, 1}; }
+        if (d1 == 1) {
+            return {static_cast<I>(t), f.denominator * g.denominator};
+        }
+        const I d2{divisor(static_cast<I>(t % d1), d1)};
+        return {static_cast<I>(t / d2), f_part * (g.denominator / d2)};
+    }
+
+
+    static constexpr auto multiply(rational f, rational g) noexcept
+        -> rational {
+        const I d1{divisor(f.numerator, g.denominator)};
+        const I d2{divisor(g.numerator, f.denominator)};
+        rational result{(f.numerator / d1) * (g.numerator / d2),
+                        (f.denominator / d2) * (g.denominator / d1)};
+        if (result.denominator < 0) {
+            result.numerator = -result.numerator;
+            result.denominator = -result.denominator;
+        }
+        return result;
+    }
+};
+
+
+/*
+    description:
+        rational which is not normalised by + - * /, numerator and denominator
+   are only cancelled by reduce(). Comparisons cross multiply and the output
+   prints the reduced value, so the normalisation can be deferred to the end
+   of a chain of operations, e.g. the update a - l * u of the elimination
+   costs one gcd instead of four. The denominator stays positive, the operands
+   grow quickly so a wide I should be used
+*/
+template <std::integral I>
+struct lazy_rational {
+    I numerator{0};
+    I denominator{1};
+
+
+    constexpr void reduce() noexcept {
+        rational<I> r{numerator, denominator};
+        r.reduce();
+        numerator = r.numerator;
+        denominator = r.denominator;
+    }
+
+
+    /*
+        description:
+            reduced value as an eager rational
+    */
+    [[nodiscard]] constexpr auto to_rational() const noexcept -> rational<I> {
+        rational<I> r{numerator, denominator};
+        r.reduce();
+        return r;
+    }
+
+
+    friend constexpr auto operator+(lazy_rational f, lazy_rational g) noexcept
+        -> lazy_rational {
+        return {f.numerator * g.denominator + g.numerator * f.denominator,
+                f.denominator * g.denominator};
+    }
+
+
+    friend constexpr auto operator-(lazy_rational f, lazy_rational g) noexcept
+        -> lazy_rational {
+        return {f.numerator * g.denominator - g.numerator * f.denominator,
+                f.denominator * g.denominator};
+    }
+
+
+    friend constexpr auto operator*(lazy_rational f, lazy_rational g) noexcept
+        -> lazy_rational {
+        return {f.numerator * g.numerator, f.denominator * g.denominator};
+    }
+
+
+    /*throws std::invalid_argument if g is zero*/
+    friend constexpr auto operator/(lazy_rational f, lazy_rational g)
+        -> lazy_rational {
+        if (g.numerator == 0) {
+            throw std::invalid_argument("Division by zero rational.");
+        }
+        const I sign{g.numerator < 0 ? I{-1} : I{1}};
+        return {sign * f.numerator * g.denominator,
+                sign * f.denominator * g.numerator};
+    }
+
+
+    friend constexpr auto operator==(lazy_rational f, lazy_rational g) noexcept
+        -> bool {
+        using W = rational_detail::wider_t<I>;
+        return W{f.numerator} * g.denominator ==
+               W{g.numerator} * f.denominator;
+    }
+
+
+    friend constexpr auto operator<=>(lazy_rational f,
+                                      lazy_rational g) noexcept
+        -> std::weak_ordering {
+        using W = rational_detail::wider_t<I>;
+        return W{f.numerator} * g.denominator <=>
+               W{g.numerator} * f.denominator;
+    }
+};
+
+
+/*
+    description:
+        batch operations over spans of rationals. When every denominator
+   involved is 1, which is the common case for integer input, the loops run on
+   the numerators only and need no gcd at all
+*/
+template <std::integral I>
+constexpr auto all_integral(std::span<const rational<I>> values) noexcept
+    -> bool {
+    return std::ranges::all_of(
+        values, [](const rational<I>& r) { return r.denominator == 1; });
+}
+
+
+/*
+    description:
+        out[i] = a[i] + b[i]
+*/
+template <std::integral I>
+constexpr auto add_all(std::type_identity_t<std::span<const rational<I>>> a,
+                       std::type_identity_t<std::span<const rational<I>>> b,
+                       std::span<rational<I>> out) noexcept -> void {
+    if (all_integral(a) && all_integral(b)) {
+        for (std::size_t i = 0; i < out.size(); i++) {
+            out[i] = {a[i].numerator + b[i].numerator, 1};
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < out.size(); i++) { out[i] = a[i] + b[i]; }
+}
+
+
+/*
+    description:
+        out[i] = a[i] * b[i]
+*/
+template <std::integral I>
+constexpr auto multiply_all(
+    std::type_identity_t<std::span<const rational<I>>> a,
+    std::type_identity_t<std::span<const rational<I>>> b,
+    std::span<rational<I>> out) noexcept -> void {
+    if (all_integral(a) && all_integral(b)) {
+        for (std::size_t i = 0; i < out.size(); i++) {
+            out[i] = {a[i].numerator * b[i].numerator, 1};
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < out.size(); i++) { out[i] = a[i] * b[i]; }
+}
+
+
+/*
+    description:
+        brings every value to lowest terms, integers are skipped
+*/
+template <std::integral I>
+constexpr auto normalize_all(std::span<rational<I>> values) noexcept -> void {
+    for (rational<I>& r : values) {
+        if (r.denominator != 1) { r.reduce(); }
+    }
+}
+
+
+/*
+    description:
+        row[i] -= factor * pivot_row[i], the row update of the gaussian
+   elimination
+*/
+template <std::integral I>
+constexpr auto subtract_multiple(
+    std::span<rational<I>> row,
+    rational<I> factor,
+    std::type_identity_t<std::span<const rational<I>>> pivot_row) noexcept
+    -> void {
+    if (factor.numerator == 0) { return; }
+    if (factor.denominator == 1 &&
+        all_integral(std::span<const rational<I>>{row}) &&
+        all_integral(pivot_row)) {
+        for (std::size_t i = 0; i < row.size(); i++) {
+            row[i].numerator -= factor.numerator * pivot_row[i].numerator;
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < row.size(); i++) {
+        if (pivot_row[i].numerator != 0) { row[i] -= factor * pivot_row[i]; }
+    }
+}
+
+
+/*
+    description:
+        enables formatting of rationals as numerator/denominator
+*/
+template <std::integral I>
+struct std::formatter<rational<I>> {
+
+    template <typename FormatParseContext>
+    constexpr auto parse(FormatParseContext& ctx) {
+        return ctx.begin();
+    }
+
+
+    template <typename FormatContext>
+    auto format(const rational<I>& r, FormatContext& ctx) const {
+        return std::format_to(ctx.out(), "{}/{}", r.numerator, r.denominator);
+    }
+};
+
+
+template <std::integral I>
+struct std::formatter<lazy_rational<I>> : std::formatter<rational<I>> {
+
+    template <typename FormatContext>
+    auto format(const lazy_rational<I>& r, FormatContext& ctx) const {
+        return std::formatter<rational<I>>::format(r.to_rational(), ctx);
+    }
+};
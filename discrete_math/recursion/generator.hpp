@@ -0,0 +1,107 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/*
+    description:
+        Lazy input range of the values a coroutine yields, a minimal
+        std::generator for standard libraries that do not ship it yet. A
+        co_yield suspends the coroutine and hands out a reference to the
+        yielded object, so an enumerator can yield the same buffer over and
+        over and a caller who stops iterating stops the enumeration. Whatever
+        the number of results, the memory is the coroutine frame.
+*/
+template <typename T>
+class generator {
+public:
+    struct promise_type {
+        const T* current{nullptr};
+        std::exception_ptr exception;
+
+        auto get_return_object() -> generator {
+            return generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+        auto final_suspend() noexcept -> std::suspend_always { return {}; }
+        auto yield_value(const T& value) noexcept -> std::suspend_always {
+            current = std::addressof(value);
+            return {};
+        }
+        auto return_void() noexcept -> void {}
+        auto unhandled_exception() -> void { exception = std::current_exception(); }
+    };
+
+    class iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) : coroutine{handle} {}
+
+        auto operator*() const -> const T& { return *coroutine.promise().current; }
+        auto operator++() -> iterator& {
+            advance(coroutine);
+            return *this;
+        }
+        auto operator++(int) -> void { ++*this; }
+        friend auto operator==(const iterator& it, std::default_sentinel_t) -> bool {
+            return !it.coroutine || it.coroutine.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> coroutine{};
+    };
+
+    generator(generator&& other) noexcept : coroutine{std::exchange(other.coroutine, {})} {}
+    auto operator=(generator other) noexcept -> generator& {
+        std::swap(coroutine, other.coroutine);
+        return *this;
+    }
+    ~generator() {
+        if (coroutine) { coroutine.destroy(); }
+    }
+
+    /*
+        description:
+            Runs the coroutine up to its first co_yield; a generator can be
+            iterated once.
+    */
+    auto begin() -> iterator {
+        advance(coroutine);
+        return iterator{coroutine};
+    }
+    auto end() const -> std::default_sentinel_t { return {}; }
+
+private:
+    std::coroutine_handle<promise_type> coroutine;
+
+    explicit generator(std::coroutine_handle<promise_type> handle) : coroutine{handle} {}
+
+    static auto advance(std::coroutine_handle<promise_type> handle) -> void {
+        handle.resume();
+        if (handle.promise().exception) {
+            std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+        }
+    }
+};
+
+
+/*
+    description:
+        Copies every value of a generator into a vector, for callers who want
+        all results at once.
+*/
+template <typename T>
+inline auto to_vector(generator<T> values) -> std::vector<T> {
+    std::vector<T> result;
+    for (const T& value : values) { result.push_back(value); }
+    return result;
+}
@@ -1,19 +1,32 @@
 // NOLINTBEGIN
 module;
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <latch>
 #include <print>
 #include <set>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "../number_theory/factorization.hpp"
+#include "generator.hpp"
+#include "thread_pool.hpp"
+
 export module recursion;
 import recursion_helper;
 
+export using ::work_stealing_pool;
+
 
 /*
     description:
         Given n, of a n x n chessboard, finds the proper placement of queens on
-        chessboard. Displays all possible solutions.
+        chessboard. Displays all possible solutions, each one as soon as it is
+        found, without collecting them first. n <= 64.
 */
 export inline auto queens(int n) -> void {
     if (n == 2 || n == 3) {
@@ -21,11 +34,64 @@ export inline auto queens(int n) -> void {
         return;
     }
 
-    std::vector<std::vector<int>> solutions;
     std::vector<int> board(n, -1);
+    auto print_solution = [n](const std::vector<int>& solution) {
+        for (int i = 0; i < n; i++) {
+            print_solutions_helper(n, i, solution);
+            std::print("\n");
+        }
+        std::print("\n");
+    };
+    place_queens(queens_mask(n), 0, 0, 0, 0, board, print_solution);
+}
+
+
+/*
+    description:
+        Counts the solutions of queens on a n x n chessboard without storing
+        them, 0 <= n <= 64. The queens of the first two rows split the search
+        into independent tasks run by pool. By mirror symmetry only first-row
+        queens in the left half are searched and counted twice; on an odd
+        board a queen in the middle column pins the second-row queen to the
+        left half instead.
+*/
+export inline auto count_queens(int n, work_stealing_pool& pool)
+    -> std::uint64_t {
+    if (n <= 1) { return 1; }
+    const std::uint64_t all = queens_mask(n);
+    const int half = n / 2;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> prefixes;
+    for (int first = 0; first < n - half; first++) {
+        const std::uint64_t a = std::uint64_t{1} << first;
+        std::uint64_t second = all & ~(a | (a << 1) | (a >> 1));
+        if (first == half) { second &= (std::uint64_t{1} << half) - 1; }
+        for (; second != 0; second &= second - 1) {
+            prefixes.emplace_back(a, second & (0 - second));
+        }
+    }
+    std::atomic<std::uint64_t> total{0};
+    std::latch done{static_cast<std::ptrdiff_t>(prefixes.size())};
+    for (const auto& [a, b] : prefixes) {
+        pool.submit([&total, &done, all, a, b] {
+            total += 2 * count_queens_from(all,
+                                           a | b,
+                                           (((a << 1) | b) << 1) & all,
+                                           ((a >> 1) | b) >> 1);
+            done.count_down();
+        });
+    }
+    done.wait();
+    return total;
+}
 
-    solve_n_queens_util(n, 0, board, solutions);
-    print_solutions(solutions, n);
+
+/*
+    description:
+        count_queens on a work_stealing_pool with a thread per core.
+*/
+export inline auto count_queens(int n) -> std::uint64_t {
+    work_stealing_pool pool;
+    return count_queens(n, pool);
 }
 
 
@@ -46,36 +112,91 @@ export inline auto chocolates(std::size_t your_money,
 
 /*
     description:
-        Checks if a number is prime.
+        Numbers below this limit are checked by recursive trial division.
+*/
+constexpr std::size_t recursive_trial_division_limit{std::size_t{1} << 20};
+
+
+/*
+    description:
+        Checks if a number is prime. Below recursive_trial_division_limit by
+        recursive trial division, whose depth stays below 512 there; larger
+        numbers would overflow the stack, they are checked by the deterministic
+        Miller-Rabin test of number_theory instead.
 */
 export inline auto is_prime(std::size_t number) -> bool {
     if (number <= 1) { return false; }
     if (number == 2) { return true; }
     if (number % 2 == 0) { return false; }
+    if (number >= recursive_trial_division_limit) {
+        return number_theory::miller_rabin(number);
+    }
 
     return is_prime_helper(number, 3);
 }
 
 
+/*
+    description:
+        Yields all possible factorizations of number one at a time, into a
+        reused buffer, in the order of factorizations. The search runs on an
+        explicit stack: a factor i of the remaining quotient is tried if
+        i * i <= quotient, above that only the quotient itself can be the
+        last factor.
+*/
+export inline auto lazy_factorizations(std::size_t number)
+    -> generator<std::vector<std::size_t>> {
+    std::vector<std::size_t> factors;
+    std::vector<std::size_t> quotients{number};
+    std::size_t candidate = 2;
+    while (true) {
+        const std::size_t quotient = quotients.back();
+        std::size_t factor = 0;
+        if (quotient == 1) {
+            if (!factors.empty()) { co_yield factors; }
+        } else {
+            for (std::size_t i = candidate; i <= quotient / i; ++i) {
+                if (quotient % i == 0) {
+                    factor = i;
+                    break;
+                }
+            }
+            if (factor == 0 && candidate <= quotient) { factor = quotient; }
+        }
+        if (factor != 0) {
+            factors.push_back(factor);
+            quotients.push_back(quotient / factor);
+            candidate = factor;
+            continue;
+        }
+        if (factors.empty()) { co_return; }
+        candidate = factors.back() + 1;
+        factors.pop_back();
+        quotients.pop_back();
+    }
+}
+
+
 /*
     description:
         Returns a vector of all possible factorizations of number.
 */
 export inline auto factorizations(std::size_t number) {
-    std::vector<std::vector<std::size_t>> all_factors;
-    std::vector<std::size_t> current_factors;
-    find_factors(number, 2, current_factors, all_factors);
-    return all_factors;
+    return to_vector(lazy_factorizations(number));
 }
 
 
 /*
     description:
-        Returns a * b using only `+` operation and recursion.
+        Returns a * b using only `+` operation and recursion. b is halved at
+        every step, a * b = 2 (a * (b / 2)) + a * (b % 2), so the recursion is
+        O(log |b|) deep instead of |b|, and negative b works as well.
 */
 export inline auto product(std::int32_t a, std::int32_t b) -> std::int64_t {
     if (b == 0) { return 0; }
-    return a + product(a, b - 1);
+    const std::int64_t half = product(a, b / 2);
+    if (b % 2 == 0) { return half + half; }
+    return b > 0 ? half + half + a : half + half - a;
 }
 
 
@@ -99,9 +220,9 @@ export inline auto sum_decomposition(std::size_t number,
 */
 export inline auto sum_of_digits(std::size_t number) -> std::size_t {
     const std::size_t reducer = 10;
-    if (number == 0) { return 0; }
-
-    return (number % reducer) + sum_of_digits(number / reducer);
+    std::size_t sum = 0;
+    for (; number != 0; number /= reducer) { sum += number % reducer; }
+    return sum;
 }
 
 
@@ -122,11 +243,10 @@ export inline auto to_binary(std::size_t number) -> std::size_t {
 
 /*
     description:
-        Returns 1 + 2 + ... + up_to.
+        Returns 1 + 2 + ... + up_to, by Gauss' formula up_to (up_to + 1) / 2.
 */
 export inline auto iota_sum(std::uint32_t up_to) -> std::uint64_t {
-    if (up_to == 0) { return 0; }
-    return up_to + iota_sum(up_to - 1);
+    return std::uint64_t{up_to} * (std::uint64_t{up_to} + 1) / 2;
 }
 
 
@@ -162,6 +282,36 @@ export inline auto tower_of_hanoi(std::size_t discs) {
 }
 
 
+/*
+    description:
+        Yields the sequences of sequences_from_a_set one at a time, into a
+        reused string: a sequence shorter than maximal_length is extended by
+        the first letter, otherwise its trailing last letters are dropped and
+        the letter before them is advanced.
+*/
+export inline auto lazy_sequences_from_a_set(std::set<char> letters,
+                                             std::uint8_t maximal_length)
+    -> generator<std::string> {
+    const std::vector<char> alphabet(letters.begin(), letters.end());
+    if (alphabet.empty() || maximal_length == 0) { co_return; }
+    std::string sequence(1, alphabet[0]);
+    std::vector<std::size_t> positions{0};
+    while (!positions.empty()) {
+        co_yield sequence;
+        if (sequence.size() < maximal_length) {
+            sequence.push_back(alphabet[0]);
+            positions.push_back(0);
+            continue;
+        }
+        while (!positions.empty() && positions.back() + 1 == alphabet.size()) {
+            positions.pop_back();
+            sequence.pop_back();
+        }
+        if (!positions.empty()) { sequence.back() = alphabet[++positions.back()]; }
+    }
+}
+
+
 /*
     description:
         Given a set of letters create all possible sequences consisting of these
@@ -171,22 +321,84 @@ export inline auto tower_of_hanoi(std::size_t discs) {
 export inline auto sequences_from_a_set(const std::set<char>& letters,
                                         std::uint8_t maximal_length)
     -> std::vector<std::string> {
-    std::vector<std::string> result;
-    generate_sequences(letters, "", maximal_length, result);
-    return result;
+    return to_vector(lazy_sequences_from_a_set(letters, maximal_length));
+}
+
+
+/*
+    description:
+        Yields the representations of more_ones one at a time, into a reused
+        string. The bits are filled with ones, then the last one that can
+        become a zero, a one with more ones than zeros before it, is turned
+        into a zero and the rest is filled with ones again.
+*/
+export inline auto lazy_more_ones(std::uint8_t number_of_bits)
+    -> generator<std::string> {
+    std::string bits(number_of_bits, '1');
+    std::size_t ones = number_of_bits;
+    std::size_t zeros = 0;
+    while (true) {
+        co_yield bits;
+        while (!bits.empty() && (bits.back() == '0' || ones - 1 <= zeros)) {
+            (bits.back() == '0' ? zeros : ones)--;
+            bits.pop_back();
+        }
+        if (bits.empty()) { co_return; }
+        bits.back() = '0';
+        ones--;
+        zeros++;
+        ones += number_of_bits - bits.size();
+        bits.resize(number_of_bits, '1');
+    }
+}
+
+
+/*
+    description:
+        Calls visit(mask) for every number_of_bits bit mask, read from its
+        highest bit, in which no prefix contains more zeros than ones, in
+        decreasing order. The next mask turns the lowest one into a zero and
+        the bits below it into ones, which can only help, so a single
+        std::popcount checks the prefix ending at the new zero; if it fails,
+        all masks sharing that prefix are skipped. number_of_bits < 64.
+*/
+export template <typename Visit>
+inline auto for_each_more_ones_mask(std::uint8_t number_of_bits, Visit visit)
+    -> void {
+    const std::size_t n = number_of_bits;
+    std::uint64_t mask = (std::uint64_t{1} << n) - 1;
+    while (true) {
+        visit(mask);
+        while (true) {
+            if (mask == 0) { return; }
+            const int lowest = std::countr_zero(mask);
+            mask--;
+            const auto ones =
+                static_cast<std::size_t>(std::popcount(mask >> lowest));
+            if (2 * ones >= n - lowest) { break; }
+            mask = mask >> lowest << lowest;
+        }
+    }
 }
 
 
 /*
     description:
         Returns all possible number_of_bits bit representation of numbers n
-        which satisfy the following condition: each prefix of n contains more
-        ones than zeros.
+        which satisfy the following condition: no prefix of n contains more
+        zeros than ones. number_of_bits < 64.
 */
 export inline auto more_ones(std::uint8_t number_of_bits)
     -> std::vector<std::string> {
     std::vector<std::string> result;
-    generate_bit_representations("", 0, 0, number_of_bits, result);
+    for_each_more_ones_mask(number_of_bits, [&](std::uint64_t mask) {
+        std::string& bits = result.emplace_back(number_of_bits, '0');
+        for (std::size_t i = 0; i < number_of_bits; i++) {
+            if (((mask >> (number_of_bits - 1 - i)) & 1U) != 0) {
+                bits[i] = '1';
+            }
+        }
+    });
     return result;
 }
 
@@ -194,37 +406,158 @@ export inline auto more_ones(std::uint8_t number_of_bits)
 /*
     description:
         Counts all possible decomposition of number into sum of x's such that
-   each x is of the form x = y ^ power for some y.
+   each x is of the form x = y ^ power for some y, the y's distinct. Only a
+   nonnegative integral number has decompositions.
 */
 export inline auto count_decompositions_as_sum_of_powers(double number,
                                                          std::uint8_t power)
     -> std::size_t {
-    std::set<std::vector<int>> decompositions;
-    std::vector<int> current_decomposition;
+    if (number < 0 || number != std::floor(number)) { return 0; }
+    return count_power_sums(static_cast<std::uint64_t>(number), power);
+}
 
-    count_decompositions(
-        number, power, 1, decompositions, current_decomposition);
 
-    return decompositions.size();
+/*
+    description:
+        Yields the subsets of subsets one at a time, into a reused vector: a
+        subset is extended by the element after its last one, and when its
+        last element is the largest it is dropped and the one before it is
+        advanced.
+*/
+export inline auto lazy_subsets(std::set<std::int32_t> numbers)
+    -> generator<std::vector<int>> {
+    const std::vector<int> elements(numbers.begin(), numbers.end());
+    if (elements.empty()) { co_return; }
+    std::vector<int> subset{elements[0]};
+    std::vector<std::size_t> indices{0};
+    while (!indices.empty()) {
+        co_yield subset;
+        if (indices.back() + 1 < elements.size()) {
+            indices.push_back(indices.back() + 1);
+            subset.push_back(elements[indices.back()]);
+            continue;
+        }
+        indices.pop_back();
+        subset.pop_back();
+        if (!indices.empty()) { subset.back() = elements[++indices.back()]; }
+    }
 }
 
 
 /*
     description:
-        Returns all possible non-empty proper subsets of numbers.
+        Returns all possible non-empty subsets of numbers.
 */
 export inline auto subsets(std::set<std::int32_t> numbers) {
+    return to_vector(lazy_subsets(std::move(numbers)));
+}
+
+
+/*
+    description:
+        Calls visit(mask, element, added) for the 2^n - 1 non-empty subsets of
+        {0, ..., n - 1}, as index bitmasks in Gray code order: each subset
+        differs from the previous one in element, the lowest set bit of the
+        step counter, which was added or removed. A step is a
+        std::countr_zero and an xor. n < 64.
+*/
+export template <typename Visit>
+inline auto for_each_gray_subset(std::size_t n, Visit visit) -> void {
+    const std::uint64_t steps = std::uint64_t{1} << n;
+    std::uint64_t mask = 0;
+    for (std::uint64_t step = 1; step < steps; step++) {
+        const auto element = static_cast<std::size_t>(std::countr_zero(step));
+        mask ^= std::uint64_t{1} << element;
+        visit(mask, element, ((mask >> element) & 1U) != 0);
+    }
+}
+
+
+/*
+    description:
+        Calls visit(mask) for the subsets of {0, ..., n - 1} with k elements,
+        as index bitmasks in increasing order, by Gosper's hack: the lowest
+        block of ones moves its highest one a place up and the others down to
+        bit 0. k <= n < 64.
+*/
+export template <typename Visit>
+inline auto for_each_subset_of_size(std::size_t n, std::size_t k, Visit visit)
+    -> void {
+    if (k > n) { return; }
+    const std::uint64_t end = std::uint64_t{1} << n;
+    for (std::uint64_t mask = (std::uint64_t{1} << k) - 1; mask < end;) {
+        visit(mask);
+        if (mask == 0) { return; }
+        const int lowest = std::countr_zero(mask);
+        const std::uint64_t raised = mask + (std::uint64_t{1} << lowest);
+        mask = (((raised ^ mask) >> 2) >> lowest) | raised;
+    }
+}
+
+
+/*
+    description:
+        Writes the elements of elements selected by mask, lowest index first,
+        into subset, reusing its storage, and returns them as a span.
+*/
+export template <typename T>
+inline auto select_subset(const std::vector<T>& elements,
+                          std::uint64_t mask,
+                          std::vector<T>& subset) -> std::span<const T> {
+    subset.clear();
+    for (; mask != 0; mask &= mask - 1) {
+        subset.push_back(elements[std::countr_zero(mask)]);
+    }
+    return subset;
+}
+
+
+/*
+    description:
+        Returns all subsets of numbers with size elements, in the order of
+        for_each_subset_of_size. numbers.size() < 64.
+*/
+export inline auto subsets_of_size(const std::set<std::int32_t>& numbers,
+                                   std::size_t size)
+    -> std::vector<std::vector<int>> {
+    const std::vector<int> elements(numbers.begin(), numbers.end());
     std::vector<std::vector<int>> result;
     std::vector<int> subset;
-    const std::size_t num_size = numbers.size();
-    std::int32_t* num_array;
-    num_array = new (std::nothrow) std::int32_t[num_size];
-    std::copy(numbers.begin(), numbers.end(), num_array);
-    generate_subsets(numbers, num_array, 0, subset, result);
+    for_each_subset_of_size(elements.size(), size, [&](std::uint64_t mask) {
+        const std::span<const int> selected =
+            select_subset(elements, mask, subset);
+        result.emplace_back(selected.begin(), selected.end());
+    });
     return result;
 }
 
 
+/*
+    description:
+        Yields the numbers of increasing_representations in increasing order,
+        as the combinations of number_of_digits of the digits 0 to 9 in
+        lexicographic order.
+*/
+export inline auto lazy_increasing_representations(std::uint8_t number_of_digits)
+    -> generator<int> {
+    const int digit_count = 10;
+    const int k = number_of_digits;
+    if (k > digit_count) { co_return; }
+    std::vector<int> digits(k);
+    for (int i = 0; i < k; ++i) { digits[i] = i; }
+    while (true) {
+        int number = 0;
+        for (const int digit : digits) { number = number * digit_count + digit; }
+        co_yield number;
+        int i = k - 1;
+        while (i >= 0 && digits[i] == digit_count - k + i) { --i; }
+        if (i < 0) { co_return; }
+        ++digits[i];
+        for (int j = i + 1; j < k; ++j) { digits[j] = digits[j - 1] + 1; }
+    }
+}
+
+
 /*
     description:
         Given number of digits number_of_digits in a number, returns all n-digit
@@ -232,9 +565,34 @@ export inline auto subsets(std::set<std::int32_t> numbers) {
         zeros are allowed so for example two digit 01 stands for number 1.
 */
 export inline auto increasing_representations(std::uint8_t number_of_digits) {
-    std::vector<int> results;
-    generate_numbers(0, number_of_digits, -1, results);
-    return results;
+    return to_vector(lazy_increasing_representations(number_of_digits));
+}
+
+
+/*
+    description:
+        Yields the decompositions of non_increasing_decompositions one at a
+        time, into a reused vector. The next one drops the trailing ones,
+        lowers the last part x > 1 to x - 1 and splits what was dropped, plus
+        one, into parts of at most x - 1.
+*/
+export inline auto lazy_non_increasing_decompositions(std::size_t number)
+    -> generator<std::vector<std::size_t>> {
+    std::vector<std::size_t> parts;
+    if (number > 0) { parts.push_back(number); }
+    while (true) {
+        co_yield parts;
+        std::size_t rest = 0;
+        while (!parts.empty() && parts.back() == 1) {
+            parts.pop_back();
+            ++rest;
+        }
+        if (parts.empty()) { co_return; }
+        const std::size_t largest = --parts.back();
+        for (++rest; rest > 0; rest -= parts.back()) {
+            parts.push_back(std::min(largest, rest));
+        }
+    }
 }
 
 
@@ -244,10 +602,7 @@ export inline auto increasing_representations(std::uint8_t number_of_digits) {
    up to number.
 */
 export inline auto non_increasing_decompositions(std::size_t number) {
-    std::vector<std::vector<std::size_t>> result;
-    std::vector<std::size_t> current_sequence;
-    generate_decompositions(number, number, current_sequence, result);
-    return result;
+    return to_vector(lazy_non_increasing_decompositions(number));
 }
 
 
@@ -273,6 +628,44 @@ export inline auto insertion_sort(std::vector<std::int32_t> v) {
 }
 
 
+/*
+    description:
+        Yields the sequences of alternating one at a time, into a reused
+        vector, every sequence after all its extensions. The search runs on
+        an explicit stack of frames, each holding the next candidate from v0
+        or v1 and where the other array continues.
+*/
+export inline auto lazy_alternating(std::vector<int> v0, std::vector<int> v1)
+    -> generator<std::vector<int>> {
+    struct frame {
+        std::size_t next_v0;
+        std::size_t next_v1;
+        bool from_v0;
+        std::size_t cursor;
+    };
+    std::vector<int> sequence;
+    std::vector<frame> frames{{0, 0, true, 0}};
+    while (!frames.empty()) {
+        frame& top = frames.back();
+        const std::vector<int>& source = top.from_v0 ? v0 : v1;
+        if (top.cursor < source.size()) {
+            const std::size_t k = top.cursor++;
+            if (sequence.empty() || source[k] > sequence.back()) {
+                sequence.push_back(source[k]);
+                frames.push_back(
+                    top.from_v0
+                        ? frame{k + 1, top.next_v1, false, top.next_v1}
+                        : frame{top.next_v0, k + 1, true, top.next_v0});
+            }
+            continue;
+        }
+        if (!sequence.empty()) { co_yield sequence; }
+        frames.pop_back();
+        if (!sequence.empty()) { sequence.pop_back(); }
+    }
+}
+
+
 /*
     description:
         Given two strictly increasing arrays v0 and v1 returns all strictly
@@ -281,23 +674,16 @@ export inline auto insertion_sort(std::vector<std::int32_t> v) {
 */
 export inline auto alternating(const std::vector<int>& v0,
                                const std::vector<int>& v1) {
-    std::vector<std::vector<int>> sequences;
-    std::vector<int> current_sequence;
-
-    find_sequences(v0, v1, 0, 0, current_sequence, sequences, true);
-
-    return sequences;
+    return to_vector(lazy_alternating(v0, v1));
 }
 
 
 /*
     description:
-        Finds nth fibinacci number.
+        Finds nth fibinacci number, in O(log(nth)) by fast doubling.
 */
-export inline auto fibonacci(uint8_t nth) {
-    if (nth == 0) { return 0; }
-    if (nth == 1) { return 1; }
-    return fibonacci(nth - 1) + fibonacci(nth - 2);
+export inline auto fibonacci(uint8_t nth) -> std::uint64_t {
+    return fibonacci_pair(nth).first;
 }
 
 
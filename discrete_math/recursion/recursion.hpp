@@ -3,46 +3,228 @@
 #include <iostream>
 #include <print>
 #include <set>
+#include <span>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <print>
 #include <cmath>
+#include <coroutine>
+#include <atomic>
+#include <bit>
+#include <latch>
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <utility>
+
+#include "../number_theory/factorization.hpp"
+#include "generator.hpp"
+#include "thread_pool.hpp"
 
 
 /*
     description:
-        Helper function to check if queen's position is safe on the chessboard
+        Open addressing hash table with linear probing used as the cache of
+        memoize. Keys and values lie in flat arrays, so a lookup touches one
+        or two cache lines instead of chasing the nodes of std::map or
+        std::unordered_map. The capacity is a power of two, doubled at half
+        load.
 */
-inline auto is_safe(const std::vector<int>& board, int row, int col) -> bool {
-    for (int i = 0; i < col; i++) {
-        if (board[i] == row || abs(board[i] - row) == abs(i - col)) {
-            return false;
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class flat_cache {
+public:
+    auto find(const Key& key) const -> const Value* {
+        if (keys.empty()) { return nullptr; }
+        for (std::size_t i = slot(key);; i = (i + 1) & (keys.size() - 1)) {
+            if (occupied[i] == 0) { return nullptr; }
+            if (keys[i] == key) { return &values[i]; }
+        }
+    }
+
+    auto insert(const Key& key, const Value& value) -> void {
+        if (2 * (count + 1) > keys.size()) { grow(); }
+        std::size_t i = slot(key);
+        while (occupied[i] != 0 && !(keys[i] == key)) {
+            i = (i + 1) & (keys.size() - 1);
+        }
+        if (occupied[i] == 0) { count++; }
+        occupied[i] = 1;
+        keys[i] = key;
+        values[i] = value;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+
+private:
+    std::vector<Key> keys;
+    std::vector<Value> values;
+    std::vector<std::uint8_t> occupied;
+    std::size_t count{0};
+
+    auto slot(const Key& key) const -> std::size_t {
+        constexpr std::uint64_t golden = 0x9E3779B97F4A7C15;
+        const std::uint64_t mixed = Hash{}(key) * golden;
+        return (mixed ^ (mixed >> 32)) & (keys.size() - 1);
+    }
+
+    auto grow() -> void {
+        constexpr std::size_t initial_capacity = 16;
+        std::vector<Key> old_keys = std::move(keys);
+        std::vector<Value> old_values = std::move(values);
+        std::vector<std::uint8_t> old_occupied = std::move(occupied);
+        const std::size_t capacity =
+            std::max(initial_capacity, 2 * old_keys.size());
+        keys.assign(capacity, Key{});
+        values.assign(capacity, Value{});
+        occupied.assign(capacity, 0);
+        count = 0;
+        for (std::size_t i = 0; i < old_keys.size(); i++) {
+            if (old_occupied[i] != 0) { insert(old_keys[i], old_values[i]); }
         }
     }
-    return true;
+};
+
+
+/*
+    description:
+        Hash of a tuple of arguments, combined from std::hash of its parts.
+*/
+struct tuple_hash {
+    template <typename... Parts>
+    auto operator()(const std::tuple<Parts...>& key) const -> std::size_t {
+        constexpr std::size_t multiplier = 0x100000001B3;
+        std::size_t seed = 0;
+        std::apply(
+            [&seed](const auto&... part) {
+                ((seed = (seed ^ std::hash<std::remove_cvref_t<decltype(part)>>{}(
+                                     part)) *
+                         multiplier),
+                 ...);
+            },
+            key);
+        return seed;
+    }
+};
+
+
+/*
+    description:
+        Memoised recursive function. function is called as
+        function(self, args...) and recurses through self, so every
+        subproblem is computed once and then looked up in a flat_cache.
+*/
+template <typename Result, typename Function, typename... Args>
+class memoized {
+public:
+    explicit memoized(Function f) : function{std::move(f)} {}
+
+    auto operator()(Args... args) -> Result {
+        const std::tuple<Args...> key{args...};
+        if (const Result* cached = cache.find(key)) { return *cached; }
+        const Result result = function(*this, args...);
+        cache.insert(key, result);
+        return result;
+    }
+
+private:
+    Function function;
+    flat_cache<std::tuple<Args...>, Result, tuple_hash> cache;
+};
+
+
+/*
+    description:
+        Wraps function(self, args...) with signature Result(Args...) into a
+        memoized, e.g. memoize<std::size_t, int>([](auto& self, int n) ...).
+*/
+template <typename Result, typename... Args, typename Function>
+inline auto memoize(Function function) {
+    return memoized<Result, Function, Args...>{std::move(function)};
+}
+
+
+/*
+    description:
+        Returns (F(n), F(n + 1)) modulo 2^64 by fast doubling,
+        F(2k) = F(k) (2 F(k + 1) - F(k)) and F(2k + 1) = F(k)^2 + F(k + 1)^2,
+        in O(log n) steps.
+*/
+inline auto fibonacci_pair(std::uint64_t n)
+    -> std::pair<std::uint64_t, std::uint64_t> {
+    if (n == 0) { return {0, 1}; }
+    const auto [a, b] = fibonacci_pair(n / 2);
+    const std::uint64_t even = a * (2 * b - a);
+    const std::uint64_t odd = a * a + b * b;
+    if (n % 2 == 0) { return {even, odd}; }
+    return {odd, even + odd};
+}
+
+
+/*
+    description:
+        Bit mask of the n squares of a row, n <= 64.
+*/
+inline auto queens_mask(int n) -> std::uint64_t {
+    constexpr int word_bits = 64;
+    return n >= word_bits ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+}
+
+
+/*
+    description:
+        Counts the completions of a placement of queens by bitboard
+        backtracking. The attacked columns and both diagonals of the next row
+        are bit masks, its free squares are all & ~(columns | left | right),
+        and the diagonals move by one bit per row, so there is no scan of the
+        previous rows and the search does not allocate.
+*/
+inline auto count_queens_from(std::uint64_t all,
+                                     std::uint64_t columns,
+                                     std::uint64_t left,
+                                     std::uint64_t right) -> std::uint64_t {
+    if (columns == all) { return 1; }
+    std::uint64_t count = 0;
+    for (std::uint64_t free = all & ~(columns | left | right); free != 0;
+         free &= free - 1) {
+        const std::uint64_t bit = free & (0 - free);
+        count += count_queens_from(
+            all, columns | bit, ((left | bit) << 1) & all, (right | bit) >> 1);
+    }
+    return count;
 }
 
 
 /*
     description:
         Helper recursive function for queens to find all possible solutions of
-        queens on a n x n chessboard
-*/
-inline void solve_n_queens_util(int n,
-                                int col,
-                                std::vector<int>& board,
-                                std::vector<std::vector<int>>& solutions) {
-    if (col == n) {
-        solutions.push_back(board);
+        queens on a n x n chessboard, on bitboards like count_queens_from.
+        Calls found(board) for every solution as soon as it is complete,
+        board[col] being the row of the queen in column col.
+*/
+template <typename Found>
+inline void place_queens(std::uint64_t all,
+                         std::size_t col,
+                         std::uint64_t rows,
+                         std::uint64_t up,
+                         std::uint64_t down,
+                         std::vector<int>& board,
+                         Found& found) {
+    if (rows == all) {
+        found(board);
         return;
     }
-
-    for (int i = 0; i < n; i++) {
-        if (is_safe(board, i, col)) {
-            board[col] = i;
-            solve_n_queens_util(n, col + 1, board, solutions);
-        }
+    for (std::uint64_t free = all & ~(rows | up | down); free != 0;
+         free &= free - 1) {
+        const std::uint64_t bit = free & (0 - free);
+        board[col] = std::countr_zero(bit);
+        place_queens(all,
+                     col + 1,
+                     rows | bit,
+                     ((up | bit) << 1) & all,
+                     (down | bit) >> 1,
+                     board,
+                     found);
     }
 }
 
@@ -62,52 +244,89 @@ inline auto print_solutions_helper(int n,
 
 /*
     description:
-        Prints out solutions for queens
+        Given n, of a n x n chessboard, finds the proper placement of queens on
+        chessboard. Displays all possible solutions, each one as soon as it is
+        found, without collecting them first. n <= 64.
 */
-inline auto print_solutions(const std::vector<std::vector<int>>& solutions,
-                            int n) {
-    for (const std::vector<int>& solution : solutions) {
+inline auto queens(int n) -> void {
+    if (n == 2 || n == 3) {
+        std::print("No solutions for n = {}\n", n);
+        return;
+    }
+
+    std::vector<int> board(n, -1);
+    auto print_solution = [n](const std::vector<int>& solution) {
         for (int i = 0; i < n; i++) {
             print_solutions_helper(n, i, solution);
             std::print("\n");
         }
         std::print("\n");
-    }
+    };
+    place_queens(queens_mask(n), 0, 0, 0, 0, board, print_solution);
 }
 
 
 /*
     description:
-        Given n, of a n x n chessboard, finds the proper placement of queens on
-        chessboard. Displays all possible solutions.
+        Counts the solutions of queens on a n x n chessboard without storing
+        them, 0 <= n <= 64. The queens of the first two rows split the search
+        into independent tasks run by pool. By mirror symmetry only first-row
+        queens in the left half are searched and counted twice; on an odd
+        board a queen in the middle column pins the second-row queen to the
+        left half instead.
 */
-inline auto queens(int n) -> void {
-    if (n == 2 || n == 3) {
-        std::print("No solutions for n = {}\n", n);
-        return;
+inline auto count_queens(int n, work_stealing_pool& pool)
+    -> std::uint64_t {
+    if (n <= 1) { return 1; }
+    const std::uint64_t all = queens_mask(n);
+    const int half = n / 2;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> prefixes;
+    for (int first = 0; first < n - half; first++) {
+        const std::uint64_t a = std::uint64_t{1} << first;
+        std::uint64_t second = all & ~(a | (a << 1) | (a >> 1));
+        if (first == half) { second &= (std::uint64_t{1} << half) - 1; }
+        for (; second != 0; second &= second - 1) {
+            prefixes.emplace_back(a, second & (0 - second));
+        }
+    }
+    std::atomic<std::uint64_t> total{0};
+    std::latch done{static_cast<std::ptrdiff_t>(prefixes.size())};
+    for (const auto& [a, b] : prefixes) {
+        pool.submit([&total, &done, all, a, b] {
+            total += 2 * count_queens_from(all,
+                                           a | b,
+                                           (((a << 1) | b) << 1) & all,
+                                           ((a >> 1) | b) >> 1);
+            done.count_down();
+        });
     }
+    done.wait();
+    return total;
+}
 
-    std::vector<std::vector<int>> solutions;
-    std::vector<int> board(n, -1);
 
-    solve_n_queens_util(n, 0, board, solutions);
-    print_solutions(solutions, n);
+/*
+    description:
+        count_queens on a work_stealing_pool with a thread per core.
+*/
+inline auto count_queens(int n) -> std::uint64_t {
+    work_stealing_pool pool;
+    return count_queens(n, pool);
 }
 
 
 /*
     description:
         Calculates max chocolates that you can buy and trade for wrappers.
+        A trade of wrap wrappers gives a chocolate and so a wrapper back, a
+        net loss of wrap - 1 wrappers, and trading goes on while at least
+        wrap wrappers remain: (wrappers - wrap) / (wrap - 1) + 1 trades, in
+        closed form instead of one recursive call per trade. wrap >= 2.
 */
 inline auto get_max_chocolates(std::size_t wrappers, std::size_t wrap)
     -> std::size_t {
     if (wrappers < wrap) { return 0; }
-
-    const std::size_t new_chocolates = wrappers / wrap;
-    const std::size_t remaining_wrappers = wrappers % wrap;
-
-    return new_chocolates +
-           get_max_chocolates(new_chocolates + remaining_wrappers, wrap);
+    return (wrappers - wrap) / (wrap - 1) + 1;
 }
 
 
@@ -140,12 +359,25 @@ inline auto is_prime_helper(std::size_t number, std::size_t divisor) -> bool {
 
 /*
     description:
-        Checks if a number is prime.
+        Numbers below this limit are checked by recursive trial division.
+*/
+inline constexpr std::size_t recursive_trial_division_limit{std::size_t{1} << 20};
+
+
+/*
+    description:
+        Checks if a number is prime. Below recursive_trial_division_limit by
+        recursive trial division, whose depth stays below 512 there; larger
+        numbers would overflow the stack, they are checked by the deterministic
+        Miller-Rabin test of number_theory instead.
 */
 inline auto is_prime(std::size_t number) -> bool {
     if (number <= 1) { return false; }
     if (number == 2) { return true; }
     if (number % 2 == 0) { return false; }
+    if (number >= recursive_trial_division_limit) {
+        return number_theory::miller_rabin(number);
+    }
 
     return is_prime_helper(number, 3);
 }
@@ -153,26 +385,41 @@ inline auto is_prime(std::size_t number) -> bool {
 
 /*
     description:
-        Helper function to find all possible factorizations of a number.
+        Yields all possible factorizations of number one at a time, into a
+        reused buffer, in the order of factorizations. The search runs on an
+        explicit stack: a factor i of the remaining quotient is tried if
+        i * i <= quotient, above that only the quotient itself can be the
+        last factor.
 */
-inline auto find_factors(std::size_t number,
-                         std::size_t start,
-                         std::vector<std::size_t>& current_factors,
-                         std::vector<std::vector<std::size_t>>& all_factors)
-    -> void {
-    if (number == 1) {
-        if (!current_factors.empty()) {
-            all_factors.push_back(current_factors);
+inline auto lazy_factorizations(std::size_t number)
+    -> generator<std::vector<std::size_t>> {
+    std::vector<std::size_t> factors;
+    std::vector<std::size_t> quotients{number};
+    std::size_t candidate = 2;
+    while (true) {
+        const std::size_t quotient = quotients.back();
+        std::size_t factor = 0;
+        if (quotient == 1) {
+            if (!factors.empty()) { co_yield factors; }
+        } else {
+            for (std::size_t i = candidate; i <= quotient / i; ++i) {
+                if (quotient % i == 0) {
+                    factor = i;
+                    break;
+                }
+            }
+            if (factor == 0 && candidate <= quotient) { factor = quotient; }
         }
-        return;
-    }
-
-    for (std::size_t i = start; i <= number; ++i) {
-        if (number % i == 0) {
-            current_factors.push_back(i);
-            find_factors(number / i, i, current_factors, all_factors);
-            current_factors.pop_back();
+        if (factor != 0) {
+            factors.push_back(factor);
+            quotients.push_back(quotient / factor);
+            candidate = factor;
+            continue;
         }
+        if (factors.empty()) { co_return; }
+        candidate = factors.back() + 1;
+        factors.pop_back();
+        quotients.pop_back();
     }
 }
 
@@ -182,20 +429,21 @@ inline auto find_factors(std::size_t number,
         Returns a vector of all possible factorizations of number.
 */
 inline auto factorizations(std::size_t number) {
-    std::vector<std::vector<std::size_t>> all_factors;
-    std::vector<std::size_t> current_factors;
-    find_factors(number, 2, current_factors, all_factors);
-    return all_factors;
+    return to_vector(lazy_factorizations(number));
 }
 
 
 /*
     description:
-        Returns a * b using only `+` operation and recursion.
+        Returns a * b using only `+` operation and recursion. b is halved at
+        every step, a * b = 2 (a * (b / 2)) + a * (b % 2), so the recursion is
+        O(log |b|) deep instead of |b|, and negative b works as well.
 */
 inline auto product(std::int32_t a, std::int32_t b) -> std::int64_t {
     if (b == 0) { return 0; }
-    return a + product(a, b - 1);
+    const std::int64_t half = product(a, b / 2);
+    if (b % 2 == 0) { return half + half; }
+    return b > 0 ? half + half + a : half + half - a;
 }
 
 
@@ -246,9 +494,9 @@ inline auto sum_decomposition(std::size_t number,
 */
 inline auto sum_of_digits(std::size_t number) -> std::size_t {
     const std::size_t reducer = 10;
-    if (number == 0) { return 0; }
-
-    return (number % reducer) + sum_of_digits(number / reducer);
+    std::size_t sum = 0;
+    for (; number != 0; number /= reducer) { sum += number % reducer; }
+    return sum;
 }
 
 
@@ -269,11 +517,10 @@ inline auto to_binary(std::size_t number) -> std::size_t {
 
 /*
     description:
-        Returns 1 + 2 + ... + up_to.
+        Returns 1 + 2 + ... + up_to, by Gauss' formula up_to (up_to + 1) / 2.
 */
 inline auto iota_sum(std::uint32_t up_to) -> std::uint64_t {
-    if (up_to == 0) { return 0; }
-    return up_to + iota_sum(up_to - 1);
+    return std::uint64_t{up_to} * (std::uint64_t{up_to} + 1) / 2;
 }
 
 
@@ -345,19 +592,30 @@ inline auto tower_of_hanoi(std::size_t discs) {
 
 /*
     description:
-        Helper function to create all possible sequences consisting of given letters.
+        Yields the sequences of sequences_from_a_set one at a time, into a
+        reused string: a sequence shorter than maximal_length is extended by
+        the first letter, otherwise its trailing last letters are dropped and
+        the letter before them is advanced.
 */
-inline auto generate_sequences(const std::set<char>& letters,
-                               const std::string& current_sequence,
-                               std::size_t maxLength,
-                               std::vector<std::string>& result) -> void {
-    if (!current_sequence.empty() && current_sequence.length() <= maxLength) {
-        result.push_back(current_sequence);
-    }
-    if (current_sequence.length() == maxLength) { return; }
-    for (const char letter : letters) {
-        generate_sequences(
-            letters, current_sequence + letter, maxLength, result);
+inline auto lazy_sequences_from_a_set(std::set<char> letters,
+                                      std::uint8_t maximal_length)
+    -> generator<std::string> {
+    const std::vector<char> alphabet(letters.begin(), letters.end());
+    if (alphabet.empty() || maximal_length == 0) { co_return; }
+    std::string sequence(1, alphabet[0]);
+    std::vector<std::size_t> positions{0};
+    while (!positions.empty()) {
+        co_yield sequence;
+        if (sequence.size() < maximal_length) {
+            sequence.push_back(alphabet[0]);
+            positions.push_back(0);
+            continue;
+        }
+        while (!positions.empty() && positions.back() + 1 == alphabet.size()) {
+            positions.pop_back();
+            sequence.pop_back();
+        }
+        if (!positions.empty()) { sequence.back() = alphabet[++positions.back()]; }
     }
 }
 
@@ -371,32 +629,63 @@ inline auto generate_sequences(const std::set<char>& letters,
 inline auto sequences_from_a_set(const std::set<char>& letters,
                                  std::uint8_t maximal_length)
     -> std::vector<std::string> {
-    std::vector<std::string> result;
-    generate_sequences(letters, "", maximal_length, result);
-    return result;
+    return to_vector(lazy_sequences_from_a_set(letters, maximal_length));
 }
 
 
 /*
     description:
-        Helper function to find all possible bit representations
-        for number_of_bits given by function more_ones.
+        Yields the representations of more_ones one at a time, into a reused
+        string. The bits are filled with ones, then the last one that can
+        become a zero, a one with more ones than zeros before it, is turned
+        into a zero and the rest is filled with ones again.
 */
-inline auto generate_bit_representations(const std::string& current,
-                                         int onesCount,
-                                         int zerosCount,
-                                         int remainingBits,
-                                         std::vector<std::string>& result)
-    -> void {
-    if (remainingBits == 0) {
-        result.push_back(current);
-        return;
-    }
-    if (onesCount + 1 >= zerosCount) {
-        generate_bit_representations(current + '1', onesCount + 1, zerosCount, remainingBits - 1, result);
+inline auto lazy_more_ones(std::uint8_t number_of_bits)
+    -> generator<std::string> {
+    std::string bits(number_of_bits, '1');
+    std::size_t ones = number_of_bits;
+    std::size_t zeros = 0;
+    while (true) {
+        co_yield bits;
+        while (!bits.empty() && (bits.back() == '0' || ones - 1 <= zeros)) {
+            (bits.back() == '0' ? zeros : ones)--;
+            bits.pop_back();
+        }
+        if (bits.empty()) { co_return; }
+        bits.back() = '0';
+        ones--;
+        zeros++;
+        ones += number_of_bits - bits.size();
+        bits.resize(number_of_bits, '1');
     }
-    if (onesCount > zerosCount) {
-        generate_bit_representations(current + '0', onesCount, zerosCount + 1, remainingBits - 1, result);
+}
+
+
+/*
+    description:
+        Calls visit(mask) for every number_of_bits bit mask, read from its
+        highest bit, in which no prefix contains more zeros than ones, in
+        decreasing order. The next mask turns the lowest one into a zero and
+        the bits below it into ones, which can only help, so a single
+        std::popcount checks the prefix ending at the new zero; if it fails,
+        all masks sharing that prefix are skipped. number_of_bits < 64.
+*/
+template <typename Visit>
+inline auto for_each_more_ones_mask(std::uint8_t number_of_bits, Visit visit)
+    -> void {
+    const std::size_t n = number_of_bits;
+    std::uint64_t mask = (std::uint64_t{1} << n) - 1;
+    while (true) {
+        visit(mask);
+        while (true) {
+            if (mask == 0) { return; }
+            const int lowest = std::countr_zero(mask);
+            mask--;
+            const auto ones =
+                static_cast<std::size_t>(std::popcount(mask >> lowest));
+            if (2 * ones >= n - lowest) { break; }
+            mask = mask >> lowest << lowest;
+        }
     }
 }
 
@@ -404,115 +693,210 @@ inline auto generate_bit_representations(const std::string& current,
 /*
     description:
         Returns all possible number_of_bits bit representation of numbers n
-        which satisfy the following condition: each prefix of n contains more
-        ones than zeros.
+        which satisfy the following condition: no prefix of n contains more
+        zeros than ones. number_of_bits < 64.
 */
-inline auto more_ones(std::uint8_t number_of_bits) -> std::vector<std::string> {
+inline auto more_ones(std::uint8_t number_of_bits)
+    -> std::vector<std::string> {
     std::vector<std::string> result;
-    generate_bit_representations("", 0, 0, number_of_bits, result);
+    for_each_more_ones_mask(number_of_bits, [&](std::uint64_t mask) {
+        std::string& bits = result.emplace_back(number_of_bits, '0');
+        for (std::size_t i = 0; i < number_of_bits; i++) {
+            if (((mask >> (number_of_bits - 1 - i)) & 1U) != 0) {
+                bits[i] = '1';
+            }
+        }
+    });
     return result;
 }
 
 
 /*
     description:
-        Helper function to count all possible decomposition of number i with condition
-        given in count_decomposition_as_sum_of_powers.
+        Helper function counting the sets of distinct bases whose power-th
+        powers sum up to number, for count_decompositions_as_sum_of_powers.
+        ways(remaining, base) either takes base^power or skips base; it is
+        memoised on (remaining, base), so each subproblem is solved once.
 */
-inline auto count_decompositions(double num,
-                                 int pow,
-                                 int currentBase,
-                                 std::set<std::vector<int>>& decomps,
-                                 std::vector<int>& current) {
-    if (num == 0) {
-        decomps.insert(current);
-        return;
-    }
-    for (int base = currentBase; std::pow(base, pow) <= num; ++base) {
-        current.push_back(base);
-        count_decompositions(
-            num - std::pow(base, pow), pow, base + 1, decomps, current);
-        current.pop_back();
-    }
+inline auto count_power_sums(std::uint64_t number, std::uint8_t power)
+    -> std::size_t {
+    if (power == 0) { return 0; }
+    const auto power_of = [number, power](std::uint64_t base) {
+        std::uint64_t result = 1;
+        for (std::uint8_t k = 0; k < power; k++) {
+            if (result > number / base) { return number + 1; }
+            result *= base;
+        }
+        return result;
+    };
+    auto ways = memoize<std::size_t, std::uint64_t, std::uint64_t>(
+        [&power_of](auto& self,
+                    std::uint64_t remaining,
+                    std::uint64_t base) -> std::size_t {
+            if (remaining == 0) { return 1; }
+            const std::uint64_t term = power_of(base);
+            if (term > remaining) { return 0; }
+            return self(remaining - term, base + 1) + self(remaining, base + 1);
+        });
+    return ways(number, 1);
 }
 
 
 /*
     description:
-        Counts all possible decomposition of number into sum of x's such that each x
-        is of the form x = y ^ power for some y.
+        Counts all possible decomposition of number into sum of x's such that
+   each x is of the form x = y ^ power for some y, the y's distinct. Only a
+   nonnegative integral number has decompositions.
 */
 inline auto count_decompositions_as_sum_of_powers(double number,
                                                   std::uint8_t power)
     -> std::size_t {
-    std::set<std::vector<int>> decompositions;
-    std::vector<int> current_decomposition;
-
-    count_decompositions(
-        number, power, 1, decompositions, current_decomposition);
-
-    return decompositions.size();
+    if (number < 0 || number != std::floor(number)) { return 0; }
+    return count_power_sums(static_cast<std::uint64_t>(number), power);
 }
 
 
 /*
     description:
-        Helper function to find all possible subsets of numbers.
+        Yields the subsets of subsets one at a time, into a reused vector: a
+        subset is extended by the element after its last one, and when its
+        last element is the largest it is dropped and the one before it is
+        advanced.
 */
-inline auto generate_subsets(const std::set<std::int32_t>& numbers,
-                             const std::int32_t* num_array,
-                             std::size_t index,
-                             std::vector<int>& subset,
-                             std::vector<std::vector<int>>& subsets) -> void {
-    if (!subset.empty()) { subsets.push_back(subset); }
-    for (std::size_t i = index; i < numbers.size(); ++i) {
-        subset.push_back(num_array[i]);
-        generate_subsets(numbers, num_array, i + 1, subset, subsets);
+inline auto lazy_subsets(std::set<std::int32_t> numbers)
+    -> generator<std::vector<int>> {
+    const std::vector<int> elements(numbers.begin(), numbers.end());
+    if (elements.empty()) { co_return; }
+    std::vector<int> subset{elements[0]};
+    std::vector<std::size_t> indices{0};
+    while (!indices.empty()) {
+        co_yield subset;
+        if (indices.back() + 1 < elements.size()) {
+            indices.push_back(indices.back() + 1);
+            subset.push_back(elements[indices.back()]);
+            continue;
+        }
+        indices.pop_back();
         subset.pop_back();
+        if (!indices.empty()) { subset.back() = elements[++indices.back()]; }
     }
 }
 
 
 /*
     description:
-        Returns all possible non-empty proper subsets of numbers.
+        Returns all possible non-empty subsets of numbers.
 */
 inline auto subsets(std::set<std::int32_t> numbers) {
+    return to_vector(lazy_subsets(std::move(numbers)));
+}
+
+
+/*
+    description:
+        Calls visit(mask, element, added) for the 2^n - 1 non-empty subsets of
+        {0, ..., n - 1}, as index bitmasks in Gray code order: each subset
+        differs from the previous one in element, the lowest set bit of the
+        step counter, which was added or removed. A step is a
+        std::countr_zero and an xor. n < 64.
+*/
+template <typename Visit>
+inline auto for_each_gray_subset(std::size_t n, Visit visit) -> void {
+    const std::uint64_t steps = std::uint64_t{1} << n;
+    std::uint64_t mask = 0;
+    for (std::uint64_t step = 1; step < steps; step++) {
+        const auto element = static_cast<std::size_t>(std::countr_zero(step));
+        mask ^= std::uint64_t{1} << element;
+        visit(mask, element, ((mask >> element) & 1U) != 0);
+    }
+}
+
+
+/*
+    description:
+        Calls visit(mask) for the subsets of {0, ..., n - 1} with k elements,
+        as index bitmasks in increasing order, by Gosper's hack: the lowest
+        block of ones moves its highest one a place up and the others down to
+        bit 0. k <= n < 64.
+*/
+template <typename Visit>
+inline auto for_each_subset_of_size(std::size_t n, std::size_t k, Visit visit)
+    -> void {
+    if (k > n) { return; }
+    const std::uint64_t end = std::uint64_t{1} << n;
+    for (std::uint64_t mask = (std::uint64_t{1} << k) - 1; mask < end;) {
+        visit(mask);
+        if (mask == 0) { return; }
+        const int lowest = std::countr_zero(mask);
+        const std::uint64_t raised = mask + (std::uint64_t{1} << lowest);
+        mask = (((raised ^ mask) >> 2) >> lowest) | raised;
+    }
+}
+
+
+/*
+    description:
+        Writes the elements of elements selected by mask, lowest index first,
+        into subset, reusing its storage, and returns them as a span.
+*/
+template <typename T>
+inline auto select_subset(const std::vector<T>& elements,
+                          std::uint64_t mask,
+                          std::vector<T>& subset) -> std::span<const T> {
+    subset.clear();
+    for (; mask != 0; mask &= mask - 1) {
+        subset.push_back(elements[std::countr_zero(mask)]);
+    }
+    return subset;
+}
+
+
+/*
+    description:
+        Returns all subsets of numbers with size elements, in the order of
+        for_each_subset_of_size. numbers.size() < 64.
+*/
+inline auto subsets_of_size(const std::set<std::int32_t>& numbers,
+                            std::size_t size)
+    -> std::vector<std::vector<int>> {
+    const std::vector<int> elements(numbers.begin(), numbers.end());
     std::vector<std::vector<int>> result;
     std::vector<int> subset;
-    const std::size_t num_size = numbers.size();
-    std::int32_t* num_array;
-    num_array = new (std::nothrow) std::int32_t[num_size];
-    std::copy(numbers.begin(), numbers.end(), num_array);
-    generate_subsets(numbers, num_array, 0, subset, result);
+    for_each_subset_of_size(elements.size(), size, [&](std::uint64_t mask) {
+        const std::span<const int> selected =
+            select_subset(elements, mask, subset);
+        result.emplace_back(selected.begin(), selected.end());
+    });
     return result;
 }
 
 
 /*
     description:
-        Helper function to find all n-digit numbers 
-        whose digits are strictly increasing from left to right.
+        Yields the numbers of increasing_representations in increasing order,
+        as the combinations of number_of_digits of the digits 0 to 9 in
+        lexicographic order.
 */
-inline auto generate_numbers(int currentNumber,
-                             int num_digits,
-                             int last_digit,
-                             std::vector<int>& results) -> void {
-    const int digit_nine = 9;
-    const int digit_ten = 10;
-    if (num_digits == 0) {
-        results.push_back(currentNumber);
-        return;
-    }
-    for (int next_digit = last_digit + 1; next_digit <= digit_nine;
-         ++next_digit) {
-        generate_numbers(currentNumber * digit_ten + next_digit,
-                         num_digits - 1,
-                         next_digit,
-                         results);
+inline auto lazy_increasing_representations(std::uint8_t number_of_digits)
+    -> generator<int> {
+    const int digit_count = 10;
+    const int k = number_of_digits;
+    if (k > digit_count) { co_return; }
+    std::vector<int> digits(k);
+    for (int i = 0; i < k; ++i) { digits[i] = i; }
+    while (true) {
+        int number = 0;
+        for (const int digit : digits) { number = number * digit_count + digit; }
+        co_yield number;
+        int i = k - 1;
+        while (i >= 0 && digits[i] == digit_count - k + i) { --i; }
+        if (i < 0) { co_return; }
+        ++digits[i];
+        for (int j = i + 1; j < k; ++j) { digits[j] = digits[j - 1] + 1; }
     }
 }
 
+
 /*
     description:
         Given number of digits number_of_digits in a number, returns all n-digit
@@ -520,47 +904,44 @@ inline auto generate_numbers(int currentNumber,
         zeros are allowed so for example two digit 01 stands for number 1.
 */
 inline auto increasing_representations(std::uint8_t number_of_digits) {
-    std::vector<int> results;
-    generate_numbers(0,
-                     number_of_digits,
-                     -1,
-                     results);
-    return results;
+    return to_vector(lazy_increasing_representations(number_of_digits));
 }
 
 
 /*
     description:
-        Helper function to find all non-increasing decompositions of a number.
+        Yields the decompositions of non_increasing_decompositions one at a
+        time, into a reused vector. The next one drops the trailing ones,
+        lowers the last part x > 1 to x - 1 and splits what was dropped, plus
+        one, into parts of at most x - 1.
 */
-inline auto generate_decompositions(
-    std::size_t number,
-    std::size_t max_value,
-    std::vector<std::size_t>& current_sequence,
-    std::vector<std::vector<std::size_t>>& result) -> void {
-    if (number == 0) {
-        result.push_back(current_sequence);
-        return;
-    }
-
-    for (std::size_t i = std::min(max_value, number); i > 0; --i) {
-        current_sequence.push_back(i);
-        generate_decompositions(number - i, i, current_sequence, result);
-        current_sequence.pop_back();
+inline auto lazy_non_increasing_decompositions(std::size_t number)
+    -> generator<std::vector<std::size_t>> {
+    std::vector<std::size_t> parts;
+    if (number > 0) { parts.push_back(number); }
+    while (true) {
+        co_yield parts;
+        std::size_t rest = 0;
+        while (!parts.empty() && parts.back() == 1) {
+            parts.pop_back();
+            ++rest;
+        }
+        if (parts.empty()) { co_return; }
+        const std::size_t largest = --parts.back();
+        for (++rest; rest > 0; rest -= parts.back()) {
+            parts.push_back(std::min(largest, rest));
+        }
     }
 }
 
 
 /*
     description:
-        Given a number, returns all possible non-increasing sequences which sum up to
-        number.
+        Given a number, returns all possible non-increasing sequences which sum
+   up to number.
 */
-inline auto non_increasing_decompositions(std::size_t number){
-    std::vector<std::vector<std::size_t>> result;
-    std::vector<std::size_t> current_sequence;
-    generate_decompositions(number, number, current_sequence, result);
-    return result;
+inline auto non_increasing_decompositions(std::size_t number) {
+    return to_vector(lazy_non_increasing_decompositions(number));
 }
 
 
@@ -599,12 +980,12 @@ inline auto insertion_sort_recursive(std::vector<std::int32_t>& v,
     if (n <= 1) { return; }
     insertion_sort_recursive(v, n - 1);
     const std::int32_t last = v[n - 1];
-    std::size_t j = n - 2;
-    while (j >= 0 && v[j] > last) {
-        v[j + 1] = v[j];
+    std::size_t j = n - 1;
+    while (j > 0 && v[j - 1] > last) {
+        v[j] = v[j - 1];
         j--;
     }
-    v[j + 1] = last;
+    v[j] = last;
 }
 
 
@@ -619,66 +1000,62 @@ inline auto insertion_sort(std::vector<std::int32_t> v) {
 }
 
 
-
-
-// NOLINTBEGIN
 /*
     description:
-        Recursive function to generate strictly increasing sequences.
+        Yields the sequences of alternating one at a time, into a reused
+        vector, every sequence after all its extensions. The search runs on
+        an explicit stack of frames, each holding the next candidate from v0
+        or v1 and where the other array continues.
 */
-inline auto generate_sequences(const std::vector<int>& v0, const
-std::vector<int>& v1, std::vector<int>& current_sequence,
-std::vector<std::vector<int>>& sequences, std::size_t index) -> void {
-    if (index == current_sequence.size()) {
-        sequences.push_back(current_sequence);
-        return;
-    }
-    if (index % 2 == 0) { // If the index is even, choose from v0
-        for (const int num : v0) {
-            if (num > current_sequence.back()) {
-                current_sequence[index] = num;
-                generate_sequences(v0, v1, current_sequence, sequences, index
-                + 1);
-            }
-        }
-    } else {
-        for (int num : v1) {
-            if (num > current_sequence.back()) {
-                current_sequence[index] = num;
-                generate_sequences(v0, v1, current_sequence, sequences, index
-                + 1);
+inline auto lazy_alternating(std::vector<int> v0, std::vector<int> v1)
+    -> generator<std::vector<int>> {
+    struct frame {
+        std::size_t next_v0;
+        std::size_t next_v1;
+        bool from_v0;
+        std::size_t cursor;
+    };
+    std::vector<int> sequence;
+    std::vector<frame> frames{{0, 0, true, 0}};
+    while (!frames.empty()) {
+        frame& top = frames.back();
+        const std::vector<int>& source = top.from_v0 ? v0 : v1;
+        if (top.cursor < source.size()) {
+            const std::size_t k = top.cursor++;
+            if (sequence.empty() || source[k] > sequence.back()) {
+                sequence.push_back(source[k]);
+                frames.push_back(
+                    top.from_v0
+                        ? frame{k + 1, top.next_v1, false, top.next_v1}
+                        : frame{top.next_v0, k + 1, true, top.next_v0});
             }
+            continue;
         }
+        if (!sequence.empty()) { co_yield sequence; }
+        frames.pop_back();
+        if (!sequence.empty()) { sequence.pop_back(); }
     }
 }
 
 
 /*
     description:
-        Given two strictly increasing arrays v0 and v1 returns all strictly increasing
-        sequences satisfying the following condition: a[2i] must be drawn from v0 and
-        a[2i + 1] must be drawn from v1 for every integer i
+        Given two strictly increasing arrays v0 and v1 returns all strictly
+   increasing sequences satisfying the following condition: a[2i] must be drawn
+   from v0 and a[2i + 1] must be drawn from v1 for every integer i
 */
-inline auto alternating(const std::vector<int>& v0, const
-std::vector<int>& v1) {
-    std::vector<std::vector<int>> sequences;
-    std::vector<int> current_sequence((v0.size() + v1.size()), 0);
-    current_sequence[0] = v0[0];
-
-    generate_sequences(v0, v1, current_sequence, sequences, 1);
-    return sequences;
+inline auto alternating(const std::vector<int>& v0,
+                        const std::vector<int>& v1) {
+    return to_vector(lazy_alternating(v0, v1));
 }
-// NOLINTEND
 
 
 /*
     description:
-        Finds nth fibinacci number.
+        Finds nth fibinacci number, in O(log(nth)) by fast doubling.
 */
-inline auto fibonacci(uint8_t nth) {
-    if (nth == 0) { return 0; }
-    if (nth == 1) { return 1; }
-    return fibonacci(nth - 1) + fibonacci(nth - 2);
+inline auto fibonacci(uint8_t nth) -> std::uint64_t {
+    return fibonacci_pair(nth).first;
 }
 
 
@@ -1,9 +1,16 @@
 // NOLINTBEGIN
 module;
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <print>
 #include <set>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 export module recursion_helper;
@@ -11,68 +18,217 @@ export module recursion_helper;
 
 /*
     description:
-        Helper function to check if queen's position is safe on the chessboard
+        Open addressing hash table with linear probing used as the cache of
+        memoize. Keys and values lie in flat arrays, so a lookup touches one
+        or two cache lines instead of chasing the nodes of std::map or
+        std::unordered_map. The capacity is a power of two, doubled at half
+        load.
 */
-export inline auto is_safe(const std::vector<int>& board,
-                           int row,
-                           int col) -> bool {
-    for (int i = 0; i < col; i++) {
-        if (board[i] == row || abs(board[i] - row) == abs(i - col)) {
-            return false;
+export template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class flat_cache {
+public:
+    auto find(const Key& key) const -> const Value* {
+        if (keys.empty()) { return nullptr; }
+        for (std::size_t i = slot(key);; i = (i + 1) & (keys.size() - 1)) {
+            if (occupied[i] == 0) { return nullptr; }
+            if (keys[i] == key) { return &values[i]; }
         }
     }
-    return true;
-}
+
+    auto insert(const Key& key, const Value& value) -> void {
+        if (2 * (count + 1) > keys.size()) { grow(); }
+        std::size_t i = slot(key);
+        while (occupied[i] != 0 && !(keys[i] == key)) {
+            i = (i + 1) & (keys.size() - 1);
+        }
+        if (occupied[i] == 0) { count++; }
+        occupied[i] = 1;
+        keys[i] = key;
+        values[i] = value;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return count; }
+
+private:
+    std::vector<Key> keys;
+    std::vector<Value> values;
+    std::vector<std::uint8_t> occupied;
+    std::size_t count{0};
+
+    auto slot(const Key& key) const -> std::size_t {
+        constexpr std::uint64_t golden = 0x9E3779B97F4A7C15;
+        const std::uint64_t mixed = Hash{}(key) * golden;
+        return (mixed ^ (mixed >> 32)) & (keys.size() - 1);
+    }
+
+    auto grow() -> void {
+        constexpr std::size_t initial_capacity = 16;
+        std::vector<Key> old_keys = std::move(keys);
+        std::vector<Value> old_values = std::move(values);
+        std::vector<std::uint8_t> old_occupied = std::move(occupied);
+        const std::size_t capacity =
+            std::max(initial_capacity, 2 * old_keys.size());
+        keys.assign(capacity, Key{});
+        values.assign(capacity, Value{});
+        occupied.assign(capacity, 0);
+        count = 0;
+        for (std::size_t i = 0; i < old_keys.size(); i++) {
+            if (old_occupied[i] != 0) { insert(old_keys[i], old_values[i]); }
+        }
+    }
+};
 
 
 /*
     description:
-        Helper recursive function for queens to find all possible solutions of
-        queens on a n x n chessboard
+        Hash of a tuple of arguments, combined from std::hash of its parts.
 */
-export inline void solve_n_queens_util(
-    int n,
-    int col,
-    std::vector<int>& board,
-    std::vector<std::vector<int>>& solutions) {
-    if (col == n) {
-        solutions.push_back(board);
-        return;
+export struct tuple_hash {
+    template <typename... Parts>
+    auto operator()(const std::tuple<Parts...>& key) const -> std::size_t {
+        constexpr std::size_t multiplier = 0x100000001B3;
+        std::size_t seed = 0;
+        std::apply(
+            [&seed](const auto&... part) {
+                ((seed = (seed ^ std::hash<std::remove_cvref_t<decltype(part)>>{}(
+                                     part)) *
+                         multiplier),
+                 ...);
+            },
+            key);
+        return seed;
     }
+};
 
-    for (int i = 0; i < n; i++) {
-        if (is_safe(board, i, col)) {
-            board[col] = i;
-            solve_n_queens_util(n, col + 1, board, solutions);
-        }
+
+/*
+    description:
+        Memoised recursive function. function is called as
+        function(self, args...) and recurses through self, so every
+        subproblem is computed once and then looked up in a flat_cache.
+*/
+export template <typename Result, typename Function, typename... Args>
+class memoized {
+public:
+    explicit memoized(Function f) : function{std::move(f)} {}
+
+    auto operator()(Args... args) -> Result {
+        const std::tuple<Args...> key{args...};
+        if (const Result* cached = cache.find(key)) { return *cached; }
+        const Result result = function(*this, args...);
+        cache.insert(key, result);
+        return result;
     }
+
+private:
+    Function function;
+    flat_cache<std::tuple<Args...>, Result, tuple_hash> cache;
+};
+
+
+/*
+    description:
+        Wraps function(self, args...) with signature Result(Args...) into a
+        memoized, e.g. memoize<std::size_t, int>([](auto& self, int n) ...).
+*/
+export template <typename Result, typename... Args, typename Function>
+inline auto memoize(Function function) {
+    return memoized<Result, Function, Args...>{std::move(function)};
 }
 
 
 /*
     description:
-        Helper function for print_solutions
+        Returns (F(n), F(n + 1)) modulo 2^64 by fast doubling,
+        F(2k) = F(k) (2 F(k + 1) - F(k)) and F(2k + 1) = F(k)^2 + F(k + 1)^2,
+        in O(log n) steps.
 */
-export inline auto print_solutions_helper(int n, int i, auto solution) {
-    for (int j = 0; j < n; j++) {
-        solution[j] == i ? std::print("Q ") : std::print(". ");
+export inline auto fibonacci_pair(std::uint64_t n)
+    -> std::pair<std::uint64_t, std::uint64_t> {
+    if (n == 0) { return {0, 1}; }
+    const auto [a, b] = fibonacci_pair(n / 2);
+    const std::uint64_t even = a * (2 * b - a);
+    const std::uint64_t odd = a * a + b * b;
+    if (n % 2 == 0) { return {even, odd}; }
+    return {odd, even + odd};
+}
+
+
+/*
+    description:
+        Bit mask of the n squares of a row, n <= 64.
+*/
+export inline auto queens_mask(int n) -> std::uint64_t {
+    constexpr int word_bits = 64;
+    return n >= word_bits ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+}
+
+
+/*
+    description:
+        Counts the completions of a placement of queens by bitboard
+        backtracking. The attacked columns and both diagonals of the next row
+        are bit masks, its free squares are all & ~(columns | left | right),
+        and the diagonals move by one bit per row, so there is no scan of the
+        previous rows and the search does not allocate.
+*/
+export inline auto count_queens_from(std::uint64_t all,
+                                     std::uint64_t columns,
+                                     std::uint64_t left,
+                                     std::uint64_t right) -> std::uint64_t {
+    if (columns == all) { return 1; }
+    std::uint64_t count = 0;
+    for (std::uint64_t free = all & ~(columns | left | right); free != 0;
+         free &= free - 1) {
+        const std::uint64_t bit = free & (0 - free);
+        count += count_queens_from(
+            all, columns | bit, ((left | bit) << 1) & all, (right | bit) >> 1);
     }
+    return count;
 }
 
 
 /*
     description:
-        Prints out solutions for queens
+        Helper recursive function for queens to find all possible solutions of
+        queens on a n x n chessboard, on bitboards like count_queens_from.
+        Calls found(board) for every solution as soon as it is complete,
+        board[col] being the row of the queen in column col.
 */
-export inline auto print_solutions(
-    const std::vector<std::vector<int>>& solutions,
-    int n) {
-    for (const std::vector<int>& solution : solutions) {
-        for (int i = 0; i < n; i++) {
-            print_solutions_helper(n, i, solution);
-            std::print("\n");
-        }
-        std::print("\n");
+export template <typename Found>
+inline void place_queens(std::uint64_t all,
+                         std::size_t col,
+                         std::uint64_t rows,
+                         std::uint64_t up,
+                         std::uint64_t down,
+                         std::vector<int>& board,
+                         Found& found) {
+    if (rows == all) {
+        found(board);
+        return;
+    }
+    for (std::uint64_t free = all & ~(rows | up | down); free != 0;
+         free &= free - 1) {
+        const std::uint64_t bit = free & (0 - free);
+        board[col] = std::countr_zero(bit);
+        place_queens(all,
+                     col + 1,
+                     rows | bit,
+                     ((up | bit) << 1) & all,
+                     (down | bit) >> 1,
+                     board,
+                     found);
+    }
+}
+
+
+/*
+    description:
+        Helper function for print_solutions
+*/
+export inline auto print_solutions_helper(int n, int i, auto solution) {
+    for (int j = 0; j < n; j++) {
+        solution[j] == i ? std::print("Q ") : std::print(". ");
     }
 }
 
@@ -80,16 +236,15 @@ export inline auto print_solutions(
 /*
     description:
         Calculates max chocolates that you can buy and trade for wrappers.
+        A trade of wrap wrappers gives a chocolate and so a wrapper back, a
+        net loss of wrap - 1 wrappers, and trading goes on while at least
+        wrap wrappers remain: (wrappers - wrap) / (wrap - 1) + 1 trades, in
+        closed form instead of one recursive call per trade. wrap >= 2.
 */
 export inline auto get_max_chocolates(std::size_t wrappers,
                                       std::size_t wrap) -> std::size_t {
     if (wrappers < wrap) { return 0; }
-
-    const std::size_t new_chocolates = wrappers / wrap;
-    const std::size_t remaining_wrappers = wrappers % wrap;
-
-    return new_chocolates +
-           get_max_chocolates(new_chocolates + remaining_wrappers, wrap);
+    return (wrappers - wrap) / (wrap - 1) + 1;
 }
 
 
@@ -107,32 +262,6 @@ export inline auto is_prime_helper(std::size_t number,
 }
 
 
-/*
-    description:
-        Helper function to find all possible factorizations of a number.
-*/
-export inline auto find_factors(
-    std::size_t number,
-    std::size_t start,
-    std::vector<std::size_t>& current_factors,
-    std::vector<std::vector<std::size_t>>& all_factors) -> void {
-    if (number == 1) {
-        if (!current_factors.empty()) {
-            all_factors.push_back(current_factors);
-        }
-        return;
-    }
-
-    for (std::size_t i = start; i <= number; ++i) {
-        if (number % i == 0) {
-            current_factors.push_back(i);
-            find_factors(number / i, i, current_factors, all_factors);
-            current_factors.pop_back();
-        }
-    }
-}
-
-
 /*
     description:
         Helper function to find all possible solutions to x_1 + x_2 + ... +
@@ -197,143 +326,32 @@ export inline auto hanoi(std::size_t n,
 
 /*
     description:
-        Helper function to create all possible sequences consisting of given
-   letters.
-*/
-export inline auto generate_sequences(const std::set<char>& letters,
-                                      const std::string& current_sequence,
-                                      std::size_t maxLength,
-                                      std::vector<std::string>& result)
-    -> void {
-    if (!current_sequence.empty() && current_sequence.length() <= maxLength) {
-        result.push_back(current_sequence);
-    }
-    if (current_sequence.length() == maxLength) { return; }
-    for (const char letter : letters) {
-        generate_sequences(
-            letters, current_sequence + letter, maxLength, result);
-    }
-}
-
-
-/*
-    description:
-        Helper function to find all possible bit representations
-        for number_of_bits given by function more_ones.
-*/
-export inline auto generate_bit_representations(
-    const std::string& current,
-    int onesCount,
-    int zerosCount,
-    int remainingBits,
-    std::vector<std::string>& result) -> void {
-    if (remainingBits == 0) {
-        result.push_back(current);
-        return;
-    }
-    if (onesCount + 1 >= zerosCount) {
-        generate_bit_representations(current + '1',
-                                     onesCount + 1,
-                                     zerosCount,
-                                     remainingBits - 1,
-                                     result);
-    }
-    if (onesCount > zerosCount) {
-        generate_bit_representations(current + '0',
-                                     onesCount,
-                                     zerosCount + 1,
-                                     remainingBits - 1,
-                                     result);
-    }
-}
-
-
-/*
-    description:
-        Helper function to count all possible decomposition of number i with
-   condition given in count_decomposition_as_sum_of_powers.
-*/
-export inline auto count_decompositions(double num,
-                                        int pow,
-                                        int currentBase,
-                                        std::set<std::vector<int>>& decomps,
-                                        std::vector<int>& current) {
-    if (num == 0) {
-        decomps.insert(current);
-        return;
-    }
-    for (int base = currentBase; std::pow(base, pow) <= num; ++base) {
-        current.push_back(base);
-        count_decompositions(
-            num - std::pow(base, pow), pow, base + 1, decomps, current);
-        current.pop_back();
-    }
-}
-
-
-/*
-    description:
-        Helper function to find all possible subsets of numbers.
-*/
-export inline auto generate_subsets(const std::set<std::int32_t>& numbers,
-                                    const std::int32_t* num_array,
-                                    std::size_t index,
-                                    std::vector<int>& subset,
-                                    std::vector<std::vector<int>>& subsets)
-    -> void {
-    if (!subset.empty()) { subsets.push_back(subset); }
-    for (std::size_t i = index; i < numbers.size(); ++i) {
-        subset.push_back(num_array[i]);
-        generate_subsets(numbers, num_array, i + 1, subset, subsets);
-        subset.pop_back();
-    }
-}
-
-
-/*
-    description:
-        Helper function to find all n-digit numbers
-        whose digits are strictly increasing from left to right.
-*/
-export inline auto generate_numbers(int currentNumber,
-                                    int num_digits,
-                                    int last_digit,
-                                    std::vector<int>& results) -> void {
-    const int digit_nine = 9;
-    const int digit_ten = 10;
-    if (num_digits == 0) {
-        results.push_back(currentNumber);
-        return;
-    }
-    for (int next_digit = last_digit + 1; next_digit <= digit_nine;
-         ++next_digit) {
-        generate_numbers(currentNumber * digit_ten + next_digit,
-                         num_digits - 1,
-                         next_digit,
-                         results);
-    }
-}
-
-
-/*
-    description:
-        Helper function to find all non-increasing decompositions of a number.
+        Helper function counting the sets of distinct bases whose power-th
+        powers sum up to number, for count_decompositions_as_sum_of_powers.
+        ways(remaining, base) either takes base^power or skips base; it is
+        memoised on (remaining, base), so each subproblem is solved once.
 */
-export inline auto generate_decompositions(
-    std::size_t number,
-    std::size_t max_value,
-    std::vector<std::size_t>& current_sequence,
-    std::vector<std::vector<std::size_t>>& result) -> void {
-    if (number == 0) {
-        result.push_back(current_sequence);
-        return;
-    }
-
-    for (std::size_t i = std::min(max_value, number); i > 0; --i) {
-        current_sequence.push_back(i);
-        generate_decompositions(number - i, i, current_sequence, result);
-        current_sequence.pop_back();
-    }
+export inline auto count_power_sums(std::uint64_t number, std::uint8_t power)
+    -> std::size_t {
+    if (power == 0) { return 0; }
+    const auto power_of = [number, power](std::uint64_t base) {
+        std::uint64_t result = 1;
+        for (std::uint8_t k = 0; k < power; k++) {
+            if (result > number / base) { return number + 1; }
+            result *= base;
+        }
+        return result;
+    };
+    auto ways = memoize<std::size_t, std::uint64_t, std::uint64_t>(
+        [&power_of](auto& self,
+                    std::uint64_t remaining,
+                    std::uint64_t base) -> std::size_t {
+            if (remaining == 0) { return 1; }
+            const std::uint64_t term = power_of(base);
+            if (term > remaining) { return 0; }
+            return self(remaining - term, base + 1) + self(remaining, base + 1);
+        });
+    return ways(number, 1);
 }
 
 
@@ -364,12 +382,12 @@ export inline auto insertion_sort_recursive(std::vector<std::int32_t>& v,
     if (n <= 1) { return; }
     insertion_sort_recursive(v, n - 1);
     const std::int32_t last = v[n - 1];
-    std::size_t j = n - 2;
-    while (j >= 0 && v[j] > last) {
-        v[j + 1] = v[j];
+    std::size_t j = n - 1;
+    while (j > 0 && v[j - 1] > last) {
+        v[j] = v[j - 1];
         j--;
     }
-    v[j + 1] = last;
+    v[j] = last;
 }
 
 
@@ -385,38 +403,4 @@ export inline auto is_valid_move(const std::vector<bool>& maze,
     return x >= 0 && x < rows && y >= 0 && y < columns &&
            !maze[x * columns + y];
 }
-
-
-export inline auto find_sequences(const std::vector<int>& v0,
-                                  const std::vector<int>& v1,
-                                  int indexi,
-                                  int indexj,
-                                  std::vector<int>& current_sequence,
-                                  std::vector<std::vector<int>>& sequences,
-                                  bool fromV0)
-    -> std::vector<std::vector<int>> {
-    if (fromV0) {
-        for (int i = indexi; i < v0.size(); ++i) {
-            if (current_sequence.empty() || v0[i] > current_sequence.back()) {
-                current_sequence.push_back(v0[i]);
-                find_sequences(
-                    v0, v1, i + 1, indexj, current_sequence, sequences, false);
-                current_sequence.pop_back();
-            }
-        }
-    } else {
-        for (int j = indexj; j < v1.size(); ++j) {
-            if (v1[j] > current_sequence.back()) {
-                current_sequence.push_back(v1[j]);
-                find_sequences(
-                    v0, v1, indexi, j + 1, current_sequence, sequences, true);
-                current_sequence.pop_back();
-            }
-        }
-    }
-
-    if (!current_sequence.empty()) { sequences.push_back(current_sequence); }
-
-    return sequences;
-}
 // NOLINTEND
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/*
+    description:
+        Work-stealing thread pool. Every worker owns a deque of tasks: it
+        takes its own tasks from the back, newest first, and when it runs out
+        it steals the oldest task from the front of another deque, so workers
+        that finish early take over the remaining work of the others instead
+        of idling. Tasks submitted by a worker go to its own deque, tasks
+        submitted from outside are dealt round-robin.
+*/
+class work_stealing_pool {
+public:
+    explicit work_stealing_pool(
+        std::size_t threads = std::max(1U, std::thread::hardware_concurrency())) {
+        for (std::size_t i = 0; i < threads; i++) {
+            queues.push_back(std::make_unique<task_queue>());
+        }
+        for (std::size_t i = 0; i < threads; i++) {
+            workers.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    auto operator=(const work_stealing_pool&) -> work_stealing_pool& = delete;
+
+    ~work_stealing_pool() {
+        {
+            const std::scoped_lock lock{state};
+            stopping = true;
+        }
+        work_available.notify_all();
+    }
+
+    auto submit(std::function<void()> task) -> void {
+        const std::size_t target =
+            current_pool == this ? current_worker : next_queue++ % queues.size();
+        {
+            const std::scoped_lock lock{queues[target]->mutex};
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        {
+            const std::scoped_lock lock{state};
+            queued++;
+            pending++;
+        }
+        work_available.notify_one();
+    }
+
+    /*
+        description:
+            Blocks until every submitted task, including the tasks they
+            submitted in turn, has finished.
+    */
+    auto wait() -> void {
+        std::unique_lock lock{state};
+        all_done.wait(lock, [this] { return pending == 0; });
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return queues.size(); }
+
+private:
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::mutex state;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    std::size_t queued{0};
+    std::size_t pending{0};
+    std::atomic<std::size_t> next_queue{0};
+    bool stopping{false};
+    std::vector<std::jthread> workers;
+
+    static inline thread_local const work_stealing_pool* current_pool{nullptr};
+    static inline thread_local std::size_t current_worker{0};
+
+    auto try_take(std::size_t self, std::function<void()>& task) -> bool {
+        for (std::size_t k = 0; k < queues.size(); k++) {
+            task_queue& queue = *queues[(self + k) % queues.size()];
+            const std::scoped_lock lock{queue.mutex};
+            if (!queue.tasks.empty()) {
+                if (k == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto work(std::size_t self) -> void {
+        current_pool = this;
+        current_worker = self;
+        for (std::function<void()> task;;) {
+            {
+                std::unique_lock lock{state};
+                work_available.wait(lock,
+                                    [this] { return stopping || queued > 0; });
+                if (queued == 0) { return; }
+                queued--;
+            }
+            while (!try_take(self, task)) {}
+            task();
+            const std::scoped_lock lock{state};
+            if (--pending == 0) { all_done.notify_all(); }
+        }
+    }
+};
@@ -4,84 +4,32 @@
 #include <cmath>
 #include <charconv>
 #include <algorithm>
+#include <bit>
 #include <ranges>
 #include <concepts>
 #include <format>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <print>
 
+#include "../rational/rational.hpp"
+
 namespace representation {
 
 	/*
 		description:
-			defines the fraction structure to represent
-			a fraction with integer numerator and denominator.
-		members:
-			I numerator - integer numerator of the fraction
-			I denominator - integer denominator of the fraction
-		methods:
-			operator-= - subtracts an integer value from the fraction
+			fraction with integer numerator and denominator,
+			the rational type shared with the other projects
+			of the repository
 	*/
 	template <std::integral I>
-	struct fraction {
-		I numerator{ 0 };
-		I denominator{ 1 };
-
-		constexpr fraction<I>& operator-=(I i) {
-			numerator -= i * denominator;
-			return *this;
-		}
-		/*
-		description:
-			reduce fraction
-	*/
-		void reduce() {
-			I divider = std::gcd(numerator, denominator);
-			numerator /= divider;
-			denominator /= divider;
-		}
-
-	};
-
-
-
-	/*
-		description:
-			overloads the addition operator for fractions,
-			allowing addition of fractions
-	*/
-	template <std::integral I>
-	constexpr fraction<I> operator+(fraction<I> f, fraction<I> g) {
-		fraction<I> result{};
-		result.numerator =
-			f.numerator * g.denominator + g.numerator * f.denominator;
-		result.denominator = f.denominator * g.denominator;
-		result.reduce();
-		return result;
-	}
+	using fraction = ::rational<I>;
 
 } // namespace representation
 
-	/*
-		description:
-			enables formatting of output data
-			for representation::fraction<I>
-	*/
-template <std::integral I>
-struct std::formatter<representation::fraction<I>> {
-
-	template <typename FormatParseContext>
-	constexpr auto parse(FormatParseContext& ctx) { return ctx.begin(); }
-
-
-	template <typename FormatContext>
-	auto format(const representation::fraction<I>& f,
-		FormatContext& ctx) const {
-		return std::format_to(ctx.out(), "{}/{}", f.numerator, f.denominator);
-	}
-};
-
 /*
 	description:
 		defines the expansion structure to represent
@@ -152,49 +100,157 @@ namespace representation {
 
 	/*
 		description:
-			expands the repeating part of a fraction in the specified base
+			characters of the digits 0 to 35, the digits above 9
+			are written as capital letters
 	*/
-	template <std::uint8_t base, std::integral I>
-	inline auto expand_period_part(expansion<base>& expan, fraction<I> frac,
-		I remainder, std::vector<I> rs, std::string result)
+	inline constexpr std::string_view digit_characters{
+		"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" };
+
+	/*
+		description:
+			unsigned type twice as wide as I in which the remainders
+			of the long division are kept, so that remainder * base
+			does not overflow
+	*/
+	template <std::integral I>
+	using remainder_t = rational_detail::wider_t<std::make_unsigned_t<I>>;
+
+	/*
+		description:
+			finds the length of the non-repeating part and of the period
+			of the remainder sequence r -> r * base % denominator with
+			Brent's cycle detection, in O(pre-period + period) steps
+			and constant memory
+	*/
+	template <std::uint8_t base, typename U>
+	inline auto find_cycle(U remainder, U denominator)
+		-> std::pair<std::size_t, std::size_t> {
+		const auto next = [denominator](U r) { return r * base % denominator; };
+		std::size_t power{ 1 };
+		std::size_t period{ 1 };
+		U tortoise{ remainder };
+		U hare{ next(remainder) };
+		while (tortoise != hare) {
+			if (power == period) {
+				tortoise = hare;
+				power *= 2;
+				period = 0;
+			}
+			hare = next(hare);
+			++period;
+		}
+		tortoise = hare = remainder;
+		for (std::size_t i = 0; i < period; ++i)
+			hare = next(hare);
+		std::size_t pre_period{ 0 };
+		while (tortoise != hare) {
+			tortoise = next(tortoise);
+			hare = next(hare);
+			++pre_period;
+		}
+		return { pre_period, period };
+	}
+
+	/*
+		description:
+			writes count digits of remainder / denominator to out and
+			returns the remainder left; for bases which are powers of two
+			one division gives as many digits as fit into the remainder
+			type, they are cut out with shifts and masks
+	*/
+	template <std::uint8_t base, typename U>
+	inline auto write_digits(char* out, std::size_t count, U remainder,
+		U denominator, std::size_t denominator_bits) -> U {
+		if constexpr (base > 1 && std::has_single_bit(unsigned{ base })) {
+			constexpr std::size_t bits{ static_cast<std::size_t>(
+				std::countr_zero(unsigned{ base })) };
+			const std::size_t chunk{ std::max<std::size_t>(1,
+				(8 * sizeof(U) - denominator_bits) / bits) };
+			for (; count >= chunk; count -= chunk) {
+				const U shifted{ remainder << (bits * chunk) };
+				U block{ shifted / denominator };
+				remainder = shifted % denominator;
+				for (std::size_t i = chunk; i > 0; --i) {
+					out[i - 1] = digit_characters[
+						static_cast<std::size_t>(block & (base - 1))];
+					block >>= bits;
+				}
+				out += chunk;
+			}
+		}
+		for (; count > 0; --count) {
+			const U shifted{ remainder * base };
+			*out++ = digit_characters[
+				static_cast<std::size_t>(shifted / denominator)];
+			remainder = shifted % denominator;
+		}
+		return remainder;
+	}
+
+	/*
+		description:
+			expands the repeating part of a fraction in the specified base,
+			remainder is the one the period starts with, a remainder 0
+			means the expansion terminates and the period is empty
+	*/
+	template <std::uint8_t base, typename U>
+	inline auto expand_period_part(expansion<base>& expan, U remainder,
+		std::size_t period, U denominator, std::size_t denominator_bits)
 		-> void {
-		int index = std::ranges::distance(rs.begin(), 
-			std::ranges::find(rs, remainder));
-		expan.period = result.substr(index, result.size() - index);
-		expan.fractial = result.substr(0, index);
+		if (remainder == 0) {
+			expan.period.clear();
+			return;
+		}
+		expan.period.resize(period);
+		write_digits<base>(expan.period.data(), period, remainder,
+			denominator, denominator_bits);
+	}
+
+	/*
+		description:
+			writes the non-repeating part and the period of
+			remainder / denominator, the lengths of both are known from
+			find_cycle before any digit is written, so every digit is
+			produced once into a buffer of its final size
+	*/
+	template <std::uint8_t base, typename U>
+	inline auto expand_remainder(expansion<base>& expan, U remainder,
+		U denominator, std::size_t denominator_bits) -> void {
+		const auto [pre_period, period] =
+			find_cycle<base>(remainder, denominator);
+		expan.fractial.resize(pre_period);
+		const U start{ write_digits<base>(expan.fractial.data(), pre_period,
+			remainder, denominator, denominator_bits) };
+		expand_period_part(expan, start, period, denominator,
+			denominator_bits);
 	}
 
 	/*
 		 description:
-			 expands the fractional part of a fraction in the specified base
+			 expands the fractional part of a fraction in the specified base,
+			 in 64-bit remainders whenever the denominator is small enough,
+			 128-bit division is several times slower
 	*/
 	template <std::uint8_t base, std::integral I>
 	inline auto expand_fractional_part(expansion<base>& expan,
 		fraction<I> frac)
 		-> void {
-		const int ascii_table_chars_start = 55;
-		std::string result = "";
-		I remainder = frac.numerator % frac.denominator;
-		auto num = frac.numerator;
-		auto den = frac.denominator;
-		std::vector<I> rs;
-		while (remainder != 0 && std::find(rs.begin(), rs.end(), remainder) 
-			== rs.end()) {
-			rs.push_back(remainder);
-			frac.numerator = remainder * base;
-			if (frac.numerator / frac.denominator < 10)
-				result += std::to_string(frac.numerator / frac.denominator);
-			else
-				result += static_cast<char>(frac.numerator / frac.denominator
-					+ ascii_table_chars_start);
-			remainder = frac.numerator % frac.denominator;
+		using unsigned_type = std::make_unsigned_t<I>;
+		const auto magnitude = [](I i) -> unsigned_type {
+			return i < 0 ? unsigned_type{ 0 } - static_cast<unsigned_type>(i)
+				: static_cast<unsigned_type>(i);
+		};
+		const unsigned_type denominator{ magnitude(frac.denominator) };
+		const unsigned_type remainder{ magnitude(frac.numerator) % denominator };
+		const std::size_t denominator_bits{
+			static_cast<std::size_t>(std::bit_width(denominator)) };
+		if (denominator_bits + std::bit_width(unsigned{ base }) <= 64) {
+			expand_remainder<base, std::uint64_t>(expan, remainder,
+				denominator, denominator_bits);
 		}
-
-		if (remainder != 0)
-			expand_period_part(expan, frac, remainder, rs, result);
 		else {
-			expan.fractial = result;
-			expan.period = "";
+			expand_remainder<base, remainder_t<I>>(expan, remainder,
+				denominator, denominator_bits);
 		}
 	}
 
@@ -269,6 +325,7 @@ namespace representation {
 			fractional.numerator = 0;
 			fractional.denominator = 1;
 		}
+		fractional.reduce();
 		return fractional;
 	}
 
@@ -288,6 +345,7 @@ namespace representation {
 		else {
 			period.denominator = pow(base, exp.period.size()) - 1;
 		}
+		period.reduce();
 		return period;
 	}
 
@@ -373,6 +431,8 @@ void representation_tests() {
 	representation_test<binary>(3, 2, "1", "1", "0");
 	representation_test<octal>(75, 56, "1", "2", "3");
 	representation_test<hexal>(91, 80, "1", "2", "3");
+	representation_test<hexal>(10, 7, "1", "", "6DB");
+	representation_test<decimal>(1, 7, "0", "", "142857");
 	representation_test<decimal>("1", "0", "1", 91, 90);
 	representation_test<binary>("1", "00", "01", 13, 12);
 	representation_test<octal>("10", "01", "12", 32329, 4032);
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+
+import sorting;
+import recursion;
+
+
+namespace {
+
+    // the recursive sorts of the recursion module are quadratic and recurse
+    // once per element, insertion_sort is quadratic
+    constexpr std::size_t quadratic_cap{10'000};
+    constexpr std::array small_sizes{std::size_t{4},
+                                     std::size_t{8},
+                                     sorting::network_size};
+    constexpr std::size_t small_batch{1024};
+
+    struct options {
+        benchmark::settings settings{.min_size = 10,
+                                     .max_size = 100'000'000};
+        std::size_t threads{std::max(1U, std::thread::hardware_concurrency())};
+        std::string csv{};
+    };
+
+    auto random_input(std::size_t n) -> std::vector<std::int32_t> {
+        std::mt19937 random{static_cast<std::uint32_t>(n)};
+        std::vector<std::int32_t> result(n);
+        for (auto& x : result) { x = static_cast<std::int32_t>(random()); }
+        return result;
+    }
+
+    // powers of ten from s.min_size up to s.max_size
+    auto sizes(const benchmark::settings& s) -> std::vector<std::size_t> {
+        std::vector<std::size_t> result{};
+        for (std::size_t n = 1; n <= s.max_size; n *= 10) {
+            if (n >= s.min_size) { result.push_back(n); }
+        }
+        return result;
+    }
+
+    // every kernel sorts a fresh copy of the input, the copy is part of the
+    // measured time of all of them alike
+    template <typename F>
+    auto run(std::string_view kernel,
+             const std::vector<std::int32_t>& input,
+             const benchmark::settings& s,
+             std::vector<benchmark::record>& records,
+             F&& sort) -> void {
+        if (!benchmark::selected(s, kernel)) { return; }
+        records.push_back(
+            benchmark::measure(kernel, "int32", input.size(), 0, s, [&] {
+                auto v{sort(input)};
+                benchmark::keep(v);
+            }));
+    }
+
+    // a small input sorted over and over trains the branch predictor, so
+    // every call sorts a batch of different inputs, the time is per input
+    template <typename F>
+    auto run_small(std::string_view kernel,
+                   std::size_t n,
+                   const benchmark::settings& s,
+                   std::vector<benchmark::record>& records,
+                   F&& sort) -> void {
+        if (!benchmark::selected(s, kernel)) { return; }
+        const auto input{random_input(n * small_batch)};
+        auto v{input};
+        auto r{benchmark::measure(kernel, "int32", n, 0, s, [&] {
+            std::ranges::copy(input, v.begin());
+            for (std::size_t i = 0; i < input.size(); i += n) {
+                sort(std::span{v}.subspan(i, n));
+            }
+            benchmark::keep(v);
+        })};
+        r.ns_per_op /= small_batch;
+        r.allocations_per_op /= small_batch;
+        records.push_back(r);
+    }
+
+    auto small_benchmarks(const benchmark::settings& s,
+                          std::vector<benchmark::record>& records) -> void {
+        for (const std::size_t n : small_sizes) {
+            run_small("sorting::network_sort", n, s, records, [](auto v) {
+                sorting::network_sort(v);
+            });
+            run_small("sorting::insertion_sort", n, s, records, [](auto v) {
+                sorting::insertion_sort(v);
+            });
+            run_small("std::ranges::sort", n, s, records, [](auto v) {
+                std::ranges::sort(v);
+            });
+        }
+    }
+
+    auto large_benchmarks(const options& o,
+                          std::vector<benchmark::record>& records) -> void {
+        const benchmark::settings& s{o.settings};
+        work_stealing_pool pool{o.threads};
+        for (const std::size_t n : sizes(s)) {
+            const auto input{random_input(n)};
+            if (n <= quadratic_cap) {
+                run("recursion::bubble_sort", input, s, records, [](auto v) {
+                    return bubble_sort(std::move(v));
+                });
+                run("recursion::insertion_sort",
+                    input,
+                    s,
+                    records,
+                    [](auto v) { return insertion_sort(std::move(v)); });
+                run("sorting::insertion_sort", input, s, records, [](auto v) {
+                    return sorting::insertion_sort(std::move(v));
+                });
+            }
+            run("std::ranges::sort", input, s, records, [](auto v) {
+                std::ranges::sort(v);
+                return v;
+            });
+            run("sorting::radix_sort", input, s, records, [](auto v) {
+                return sorting::radix_sort(std::move(v));
+            });
+            run("sorting::sequential_sort", input, s, records, [](auto v) {
+                sorting::sequential_sort(std::span{v});
+                return v;
+            });
+            run("sorting::parallel_sort", input, s, records, [&pool](auto v) {
+                sorting::parallel_sort(std::span{v}, pool);
+                return v;
+            });
+        }
+    }
+
+    auto parse(int argc, char** argv) -> std::optional<options> {
+        options result{};
+        const std::vector<std::string_view> args(argv + 1, argv + argc);
+        for (std::size_t i = 0; i < args.size(); i++) {
+            const bool has_value{i + 1 < args.size()};
+            if (args[i] == "--help" || !has_value) { return std::nullopt; }
+            const std::string value{args[++i]};
+            if (args[i - 1] == "--min-size") {
+                result.settings.min_size = std::stoul(value);
+            } else if (args[i - 1] == "--max-size") {
+                result.settings.max_size = std::stoul(value);
+            } else if (args[i - 1] == "--min-time") {
+                result.settings.min_time =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>{std::stod(value)});
+            } else if (args[i - 1] == "--filter") {
+                result.settings.filter = value;
+            } else if (args[i - 1] == "--threads") {
+                result.threads = std::stoul(value);
+            } else if (args[i - 1] == "--csv") {
+                result.csv = value;
+            } else {
+                return std::nullopt;
+            }
+        }
+        if (result.threads == 0) { return std::nullopt; }
+        return result;
+    }
+
+    auto usage() -> void {
+        std::println(
+            "usage: bench_sorting [--min-size N] [--max-size N] "
+            "[--min-time SECONDS] [--filter KERNEL] [--threads N] "
+            "[--csv FILE]");
+    }
+
+}  // namespace
+
+
+auto main(int argc, char** argv) -> int {
+    const auto parsed{parse(argc, argv)};
+    if (!parsed) {
+        usage();
+        return 2;
+    }
+    const options& o{*parsed};
+    std::vector<benchmark::record> records{};
+    small_benchmarks(o.settings, records);
+    large_benchmarks(o, records);
+
+    std::println("{:<26} {:>10} {:>16} {:>11} {:>10}",
+                 "kernel",
+                 "size",
+                 "ns/op",
+                 "ns/element",
+                 "allocs/op");
+    for (const auto& r : records) {
+        std::println("{:<26} {:>10} {:>16.1f} {:>11.2f} {:>10.1f}",
+                     r.kernel,
+                     r.size,
+                     r.ns_per_op,
+                     r.ns_per_op / static_cast<double>(r.size),
+                     r.allocations_per_op);
+    }
+    if (!o.csv.empty()) { benchmark::write_csv(records, o.csv); }
+    return 0;
+}
@@ -0,0 +1,30 @@
+module;
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "sorting.hpp"
+
+export module sorting;
+
+
+/*
+    description:
+        module interface of sorting.hpp, the header itself is included by the
+   header only projects which can not import modules
+*/
+export namespace sorting {
+    using sorting::insertion_limit;
+    using sorting::insertion_sort;
+    using sorting::network_size;
+    using sorting::network_sort;
+    using sorting::network_threshold;
+    using sorting::parallel_limit;
+    using sorting::parallel_sort;
+    using sorting::radix_sort;
+    using sorting::radix_threshold;
+    using sorting::sequential_sort;
+    using sorting::sort;
+}  // namespace sorting
+
+export using ::work_stealing_pool;
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../recursion/thread_pool.hpp"
+
+
+namespace sorting_detail {
+
+    /*
+        description:
+            four lanes of int32_t, a 128-bit register on every target
+    */
+    using quad = std::int32_t __attribute__((vector_size(16)));
+
+    using block = std::array<quad, 4>;
+
+
+    template <std::size_t distance>
+    inline auto exchange_lanes(quad q) -> quad {
+        return quad{q[0 ^ distance],
+                    q[1 ^ distance],
+                    q[2 ^ distance],
+                    q[3 ^ distance]};
+    }
+
+
+    /*
+        description:
+            all ones in the lanes of quad r which keep the minimum in the
+       stage of the bitonic sort merging runs of k elements at distance
+    */
+    template <std::size_t k, std::size_t distance>
+    constexpr auto low_lanes(std::size_t r) -> quad {
+        const auto low = [r](std::size_t l) -> std::int32_t {
+            const std::size_t lane{(4 * r) + l};
+            return ((lane & distance) == 0) == ((lane & k) == 0) ? -1 : 0;
+        };
+        return quad{low(0), low(1), low(2), low(3)};
+    }
+
+
+    template <std::size_t k, std::size_t distance, std::size_t r>
+    inline auto bitonic_quad(const block& b) -> quad {
+        quad other;
+        if constexpr (distance >= 4) {
+            other = b[r ^ (distance / 4)];
+        } else {
+            other = exchange_lanes<distance>(b[r]);
+        }
+        const quad smaller = b[r] < other;
+        const quad minimum = (b[r] & smaller) | (other & ~smaller);
+        const quad maximum = (other & smaller) | (b[r] & ~smaller);
+        constexpr quad low = low_lanes<k, distance>(r);
+        return (minimum & low) | (maximum & ~low);
+    }
+
+
+    template <std::size_t k, std::size_t distance>
+    inline auto bitonic_stage(block& b) -> void {
+        b = block{bitonic_quad<k, distance, 0>(b),
+                  bitonic_quad<k, distance, 1>(b),
+                  bitonic_quad<k, distance, 2>(b),
+                  bitonic_quad<k, distance, 3>(b)};
+    }
+
+}  // namespace sorting_detail
+
+
+namespace sorting {
+
+    /*
+        description:
+            number of elements sorted by network_sort
+    */
+    inline constexpr std::size_t network_size{16};
+
+
+    /*
+        description:
+            sequential_sort hands int32_t inputs from this size up to
+       network_size to network_sort, below it copying the padded block costs
+       more than insertion_sort
+    */
+    inline constexpr std::size_t network_threshold{8};
+
+
+    /*
+        description:
+            sequential_sort hands other inputs up to this size to
+       insertion_sort
+    */
+    inline constexpr std::size_t insertion_limit{16};
+
+
+    /*
+        description:
+            sequential_sort hands int32_t inputs from this size on to
+       radix_sort, whose histograms and buffer do not pay for themselves on
+       shorter ones
+    */
+    inline constexpr std::size_t radix_threshold{1024};
+
+
+    /*
+        description:
+            parallel_sort sorts inputs below this size sequentially, the
+       phases of the sample sort do not pay for themselves there
+    */
+    inline constexpr std::size_t parallel_limit{std::size_t{1} << 16};
+
+
+    /*
+        description:
+            sorts v in place by insertion sort. A loop replaces the recursion
+       of insertion_sort of the recursion module, so the stack does not grow
+       with v. O(n^2) comparisons, O(n) for nearly sorted input
+    */
+    template <typename T, typename Compare = std::ranges::less>
+    auto insertion_sort(std::span<T> v, Compare less = {}) -> void {
+        for (std::size_t i = 1; i < v.size(); i++) {
+            T value = std::move(v[i]);
+            std::size_t j = i;
+            for (; j > 0 && less(value, v[j - 1]); j--) {
+                v[j] = std::move(v[j - 1]);
+            }
+            v[j] = std::move(value);
+        }
+    }
+
+
+    /*
+        description:
+            sorts v and returns the sorted vector
+    */
+    template <typename T>
+    auto insertion_sort(std::vector<T> v) -> std::vector<T> {
+        insertion_sort(std::span<T>{v});
+        return v;
+    }
+
+
+    /*
+        description:
+            sorts up to network_size integers in place by a bitonic sorting
+       network on four 128-bit vectors of the GCC and Clang vector extension,
+       padded with the largest value. A stage compares every lane with the
+       lane at a power of two distance: within a vector through a shuffle,
+       across vectors whole vectors at once, and keeps the minimum or the
+       maximum by masks, so no branch depends on the data. Throws
+       std::invalid_argument for longer v
+    */
+    inline auto network_sort(std::span<std::int32_t> v) -> void {
+        using sorting_detail::bitonic_stage;
+        if (v.size() > network_size) {
+            throw std::invalid_argument("Too many elements for the network.");
+        }
+        std::array<std::int32_t, network_size> padded;
+        padded.fill(std::numeric_limits<std::int32_t>::max());
+        std::ranges::copy(v, padded.begin());
+        sorting_detail::block block;
+        std::memcpy(block.data(), padded.data(), sizeof(block));
+        bitonic_stage<2, 1>(block);
+        bitonic_stage<4, 2>(block);
+        bitonic_stage<4, 1>(block);
+        bitonic_stage<8, 4>(block);
+        bitonic_stage<8, 2>(block);
+        bitonic_stage<8, 1>(block);
+        bitonic_stage<16, 8>(block);
+        bitonic_stage<16, 4>(block);
+        bitonic_stage<16, 2>(block);
+        bitonic_stage<16, 1>(block);
+        std::memcpy(padded.data(), block.data(), sizeof(block));
+        std::ranges::copy_n(padded.begin(),
+                            static_cast<std::ptrdiff_t>(v.size()),
+                            v.begin());
+    }
+
+
+    /*
+        description:
+            sorts v and returns the sorted vector, v.size() <= network_size
+    */
+    inline auto network_sort(std::vector<std::int32_t> v)
+        -> std::vector<std::int32_t> {
+        network_sort(std::span<std::int32_t>{v});
+        return v;
+    }
+
+
+    /*
+        description:
+            sorts v in place by a least significant digit radix sort, one
+       stable counting pass per byte with the sign bit flipped, so negative
+       numbers come first. The histograms of all four bytes are counted in a
+       single read of v and a pass in which all keys share the byte is
+       skipped. O(n) time and an auxiliary buffer of n elements
+    */
+    inline auto radix_sort(std::span<std::int32_t> v) -> void {
+        constexpr std::size_t bytes{4};
+        constexpr std::size_t radix{256};
+        const auto digit = [](std::int32_t x, std::size_t byte) {
+            const std::uint32_t key{std::bit_cast<std::uint32_t>(x) ^
+                                    0x8000'0000U};
+            return (key >> (8 * byte)) & (radix - 1);
+        };
+        std::array<std::array<std::size_t, radix>, bytes> counts{};
+        for (const std::int32_t x : v) {
+            for (std::size_t byte = 0; byte < bytes; byte++) {
+                counts[byte][digit(x, byte)]++;
+            }
+        }
+        std::vector<std::int32_t> buffer(v.size());
+        std::span<std::int32_t> from{v};
+        std::span<std::int32_t> to{buffer};
+        for (std::size_t byte = 0; byte < bytes; byte++) {
+            auto& offsets = counts[byte];
+            if (std::ranges::find(offsets, v.size()) != offsets.end()) {
+                continue;
+            }
+            std::size_t offset{0};
+            for (std::size_t& count : offsets) {
+                offset += std::exchange(count, offset);
+            }
+            for (const std::int32_t x : from) {
+                to[offsets[digit(x, byte)]++] = x;
+            }
+            std::swap(from, to);
+        }
+        if (from.data() != v.data()) { std::ranges::copy(from, v.begin()); }
+    }
+
+
+    /*
+        description:
+            sorts v and returns the sorted vector
+    */
+    inline auto radix_sort(std::vector<std::int32_t> v)
+        -> std::vector<std::int32_t> {
+        radix_sort(std::span<std::int32_t>{v});
+        return v;
+    }
+
+
+    /*
+        description:
+            sorts v in place on the calling thread. int32_t in increasing
+       order goes to network_sort from network_threshold to network_size
+       elements and to radix_sort from radix_threshold elements on, short
+       inputs otherwise to insertion_sort and the rest to std::ranges::sort
+    */
+    template <typename T, typename Compare = std::ranges::less>
+    auto sequential_sort(std::span<T> v, Compare less = {}) -> void {
+        constexpr bool ascending_int32{
+            std::same_as<T, std::int32_t> &&
+            std::same_as<Compare, std::ranges::less>};
+        if constexpr (ascending_int32) {
+            if (v.size() >= network_threshold && v.size() <= network_size) {
+                network_sort(v);
+                return;
+            }
+            if (v.size() >= radix_threshold) {
+                radix_sort(v);
+                return;
+            }
+        }
+        if (v.size() <= insertion_limit) {
+            insertion_sort(v, less);
+        } else {
+            std::ranges::sort(v, less);
+        }
+    }
+
+
+    /*
+        description:
+            sorts v in place by a sample sort on pool. A random sample of v,
+       sorted, gives the splitters of buckets, several per worker so that
+       stealing evens out unequal buckets. v is cut into blocks, at most one
+       per worker and few enough that the table of per block bucket counts
+       stays below n / 8 entries. The work runs in three parallel phases
+       separated by a std::latch: each block finds the bucket of every element
+       by binary search over the splitters and counts them, each block moves
+       its elements to their bucket in uninitialized storage, at offsets from
+       the prefix sums of the counts, and each bucket is sorted by
+       sequential_sort and moved back. An exception thrown by less in a task
+       is rethrown here once every task of the phase has finished, the
+       elements of v then have valid but unspecified values. Elements whose
+       move constructor may throw are sorted by sequential_sort. Must not be
+       called from a task of pool, whose worker would block in the wait
+    */
+    template <typename T, typename Compare = std::ranges::less>
+    auto parallel_sort(std::span<T> v,
+                       work_stealing_pool& pool,
+                       Compare less = {}) -> void {
+        if (v.size() < parallel_limit || pool.size() == 1 ||
+            !std::is_nothrow_move_constructible_v<T>) {
+            sequential_sort(v, less);
+            return;
+        }
+        constexpr std::size_t oversampling{16};
+        const std::size_t n{v.size()};
+        const std::size_t buckets{std::min<std::size_t>(4 * pool.size(),
+                                                        1 << 12)};
+        const std::size_t blocks{
+            std::clamp<std::size_t>(n / (8 * buckets), 1, pool.size())};
+
+        std::vector<T> sample;
+        std::mt19937_64 random{n};
+        std::uniform_int_distribution<std::size_t> index{0, n - 1};
+        for (std::size_t i = 0; i < buckets * oversampling; i++) {
+            sample.push_back(v[index(random)]);
+        }
+        std::ranges::sort(sample, less);
+        std::vector<T> splitters;
+        for (std::size_t b = 1; b < buckets; b++) {
+            splitters.push_back(sample[b * oversampling]);
+        }
+
+        const auto block = [n, blocks](std::size_t b) {
+            return std::pair{b * n / blocks, (b + 1) * n / blocks};
+        };
+        // a task always counts down, even when phase throws, so the wait
+        // cannot hang, the first exception is rethrown after the wait
+        const auto in_parallel = [&pool](std::size_t tasks, auto phase) {
+            std::latch done{static_cast<std::ptrdiff_t>(tasks)};
+            std::vector<std::exception_ptr> errors(tasks);
+            for (std::size_t t = 0; t < tasks; t++) {
+                pool.submit([&phase, &done, &errors, t] {
+                    try {
+                        phase(t);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                    done.count_down();
+                });
+            }
+            done.wait();
+            for (const auto& error : errors) {
+                if (error) { std::rethrow_exception(error); }
+            }
+        };
+
+        std::vector<std::uint16_t> bucket_of(n);
+        std::vector<std::size_t> counts(buckets * blocks);
+        in_parallel(blocks, [&](std::size_t b) {
+            const auto [begin, end] = block(b);
+            for (std::size_t i = begin; i < end; i++) {
+                const auto bucket = static_cast<std::uint16_t>(
+                    std::ranges::upper_bound(splitters, v[i], less) -
+                    splitters.begin());
+                bucket_of[i] = bucket;
+                counts[(bucket * blocks) + b]++;
+            }
+        });
+
+        std::vector<std::size_t> bounds(buckets + 1);
+        std::size_t offset{0};
+        for (std::size_t bucket = 0; bucket < buckets; bucket++) {
+            bounds[bucket] = offset;
+            for (std::size_t b = 0; b < blocks; b++) {
+                offset += std::exchange(counts[(bucket * blocks) + b], offset);
+            }
+        }
+        bounds[buckets] = n;
+
+        // the moves of the second phase do not throw, so all n elements of
+        // the buffer are constructed once it is done
+        std::allocator<T> allocator;
+        const auto release = [&allocator, n](T* p) {
+            std::destroy_n(p, n);
+            allocator.deallocate(p, n);
+        };
+        const std::unique_ptr<T, decltype(release)> buffer{
+            allocator.allocate(n), release};
+        in_parallel(blocks, [&](std::size_t b) {
+            const auto [begin, end] = block(b);
+            for (std::size_t i = begin; i < end; i++) {
+                std::construct_at(
+                    buffer.get() + counts[(bucket_of[i] * blocks) + b]++,
+                    std::move(v[i]));
+            }
+        });
+
+        in_parallel(buckets, [&](std::size_t bucket) {
+            const std::span<T> sorted{buffer.get() + bounds[bucket],
+                                      buffer.get() + bounds[bucket + 1]};
+            sequential_sort(sorted, less);
+            std::ranges::move(sorted, v.begin() + bounds[bucket]);
+        });
+    }
+
+
+    /*
+        description:
+            sorts v on a pool of one worker per core and returns the sorted
+       vector
+    */
+    template <typename T>
+    auto parallel_sort(std::vector<T> v) -> std::vector<T> {
+        work_stealing_pool pool;
+        parallel_sort(std::span<T>{v}, pool);
+        return v;
+    }
+
+
+    /*
+        description:
+            sorts v and returns the sorted vector, sequentially below
+       parallel_limit elements or on a single core and by parallel_sort
+       otherwise
+    */
+    template <typename T>
+    auto sort(std::vector<T> v) -> std::vector<T> {
+        if (v.size() < parallel_limit ||
+            std::thread::hardware_concurrency() <= 1) {
+            sequential_sort(std::span<T>{v});
+            return v;
+        }
+        return parallel_sort(std::move(v));
+    }
+
+}  // namespace sorting
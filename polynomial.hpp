@@ -6,10 +6,15 @@
 #include <iostream>
 #include <print>
 #include <set>
+#include <span>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "discrete_math/polynomials/division.hpp"
+#include "discrete_math/polynomials/evaluation.hpp"
+#include "discrete_math/polynomials/multiplication.hpp"
+
 
 namespace polynomial {
 template <typename T>
@@ -45,16 +50,9 @@ struct polynomial {
   }
   
   auto operator*=(const polynomial &p) -> polynomial & {
-    std::vector<T> multiplication_vector{};
-    multiplication_vector.resize(p.degree + degree + 1, T{0});
-    coefficients.resize(p.degree + degree + 1, T{0});
-    for (std::size_t i = degree + 1; i > 0; i--) {
-      for (std::size_t j = p.degree + 1; j > 0; j--) {
-        multiplication_vector[i + j - 2] +=
-            coefficients[i - 1] * p.coefficients[j - 1];
-      }
-    }
-    coefficients = multiplication_vector;
+    coefficients = multiplication::multiply(
+        std::span<const T>{coefficients.data(), degree + 1},
+        std::span<const T>{p.coefficients.data(), p.degree + 1});
     degree += p.degree;
     return *this;
   }
@@ -65,21 +63,11 @@ struct polynomial {
     } else if (p.degree > degree) {
       throw std::invalid_argument("Division by invalid polynomial");
     }
-    std::vector<T> division_vector{};
-    division_vector.resize(degree - p.degree + 1, T{0});
-    for (std::size_t i = degree; i > p.degree - 1; i--) {
-      division_vector[i - p.degree] =
-          coefficients[i] / p.coefficients[p.degree];
-      if (i - 1 > 0) {
-        for (std::size_t j = p.degree + 1; j > 0; j--) {
-          coefficients[j + i - p.degree - 1] -=
-              division_vector[i - p.degree] * p.coefficients[j - 1];
-        }
-      }
-    }
-    coefficients.resize(degree - p.degree + 1, T{0});
+    auto [quotient, remainder]{division::divmod(
+        std::span<const T>{coefficients.data(), degree + 1},
+        std::span<const T>{p.coefficients.data(), p.degree + 1})};
+    coefficients = std::move(quotient);
     degree -= p.degree;
-    coefficients = division_vector;
     return *this;
   }
   
@@ -87,21 +75,27 @@ struct polynomial {
     if (p.degree == 0 && p.coefficients[0] == T{0}) {
       throw std::invalid_argument("Division by zero polynomial");
     }
-    polynomial quotient;
-    polynomial remainder = *this;
-    quotient = *this / p;
-    remainder -= quotient * p;
-    *this = remainder;
+    if (p.degree > degree) {
+      return *this;
+    }
+    auto [quotient, remainder]{division::divmod(
+        std::span<const T>{coefficients.data(), degree + 1},
+        std::span<const T>{p.coefficients.data(), p.degree + 1})};
+    std::fill(coefficients.begin(), coefficients.end(), T{0});
+    degree = 0;
+    for (std::size_t i = 0; i < remainder.size(); i++) {
+      coefficients[i] = remainder[i];
+      if (remainder[i] != T{0}) {
+        degree = i;
+      }
+    }
     return *this;
   }
 
  public:
-  auto operator()(T value) {
-    T result = 0;
-    for (int i = this->degree; i >= 0; --i) {
-      result = result * value + this->coefficients[i];
-    }
-    return result;
+  auto operator()(T value) const -> T {
+    return evaluation::evaluate(
+        std::span<const T>{coefficients.data(), degree + 1}, value);
   }
 };
 
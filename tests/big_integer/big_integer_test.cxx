@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+
+#include "../../discrete_math/euclidean_algorithm/big_integer.hpp"
+
+import expect;
+
+using algorithms::big_integer;
+
+
+// Bezout's identity and the gcd of all three methods on random pairs with a
+// common factor, half of them with a negative second number
+auto test_big() -> bool {
+    std::mt19937_64 engine{2024};
+    for (std::size_t k = 0; k < 60; k++) {
+        const auto factor{algorithms::random_big_integer(1 + engine() % 200,
+                                                         engine)};
+        const auto a{
+            algorithms::random_big_integer(1 + engine() % 4000, engine) *
+            factor};
+        const auto b{
+            (k % 2 == 0 ? big_integer{1} : big_integer{-1}) *
+            algorithms::random_big_integer(1 + engine() % 4000, engine) *
+            factor};
+        const auto expected{algorithms::gcd_extended_euclid(a, b)};
+        for (const auto& result : {expected,
+                                   algorithms::gcd_extended_lehmer(a, b),
+                                   algorithms::gcd_extended(a, b)}) {
+            const auto& [x, y]{result.coefficients};
+            if (result.GCD != expected.GCD || x * a + y * b != result.GCD ||
+                !(result.GCD % factor).is_zero()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+auto test_small() -> bool {
+    const auto result{
+        algorithms::gcd_extended(big_integer{240}, big_integer{-46})};
+    const auto& [x, y]{result.coefficients};
+    return testing::expect_equal(result.GCD.to_string(), std::string{"2"}) &&
+           testing::expect_equal(
+               (x * big_integer{240} + y * big_integer{-46}).to_string(),
+               std::string{"2"});
+}
+
+
+int main() {
+    return std::ranges::all_of(std::array{test_big(), test_small()},
+                               std::identity{})
+               ? 0
+               : 1;
+}
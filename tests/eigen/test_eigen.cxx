@@ -1,6 +1,9 @@
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <complex>
 #include <cstdint>
+#include <numbers>
 #include <vector>
 
 import eigen;
@@ -119,6 +122,140 @@ auto test_jacobi() -> bool {
     return check_tolerance(eigen::jacobi(m), v_expected);
 };
 
+// second differences matrix, its eigenvalues are 2 - 2cos(j pi / (n + 1))
+auto second_differences(std::size_t n) -> matrix<double> {
+    matrix<double> m{n, n, 0};
+    for (std::size_t i = 0; i < n; i++) {
+        m[i, i] = 2;
+        if (i + 1 < n) {
+            m[i, i + 1] = -1;
+            m[i + 1, i] = -1;
+        }
+    }
+    return m;
+}
+
+auto second_differences_eigenvalue(std::size_t n, std::size_t j) -> double {
+    return 2 - 2 * std::cos(static_cast<double>(j) * std::numbers::pi /
+                            static_cast<double>(n + 1));
+}
+
+auto test_power_method_iteration_cap() -> bool {
+    // eigenvalues +-i have equal modulus so the iteration never settles
+    matrix<double> m{2, 2, 0};
+    m[0, 1] = 1;
+    m[1, 0] = -1;
+    const auto v{eigen::power_method(m, 100)};
+    return std::abs(v[0, 0] * v[0, 0] + v[1, 0] * v[1, 0] - 1) < 1e-12;
+};
+
+auto test_lanczos() -> bool {
+    const std::size_t n{100};
+    const matrix<double> m{second_differences(n)};
+    const auto result{eigen::lanczos(eigen::dense_operator(m), n, 3)};
+    bool ok{result.converged};
+    for (std::size_t i = 0; i < 3; i++) {
+        ok = ok && std::abs(result.values[i] -
+                            second_differences_eigenvalue(n, n - i)) < 1e-8;
+    }
+    return ok;
+};
+
+auto test_block_lanczos() -> bool {
+    const std::size_t n{100};
+    const matrix<double> m{second_differences(n)};
+    const auto result{
+        eigen::block_lanczos(eigen::dense_block_operator(m), n, 3, 3)};
+    bool ok{result.converged};
+    for (std::size_t i = 0; i < 3; i++) {
+        ok = ok && std::abs(result.values[i] -
+                            second_differences_eigenvalue(n, n - i)) < 1e-8;
+    }
+    return ok;
+};
+
+auto test_lanczos_zero_eigenvalue() -> bool {
+    // second differences shifted so that the largest eigenvalue is 0, the
+    // residual is measured against the norm of the matrix there
+    const std::size_t n{100};
+    matrix<double> m{second_differences(n)};
+    const double largest{second_differences_eigenvalue(n, n)};
+    for (std::size_t i = 0; i < n; i++) { m[i, i] -= largest; }
+    const auto result{eigen::lanczos(eigen::dense_operator(m), n, 2)};
+    const auto block{
+        eigen::block_lanczos(eigen::dense_block_operator(m), n, 2, 2)};
+    const double second{second_differences_eigenvalue(n, n - 1) - largest};
+    return result.converged && block.converged &&
+           std::abs(result.values[0]) < 1e-8 &&
+           std::abs(result.values[1] - second) < 1e-8 &&
+           std::abs(block.values[0]) < 1e-8 &&
+           std::abs(block.values[1] - second) < 1e-8;
+};
+
+auto test_arnoldi() -> bool {
+    // upper triangular apart from a 2 x 2 rotation block giving 3 +- 9.5i
+    const std::size_t n{40};
+    matrix<double> m{n, n, 0};
+    for (std::size_t i = 0; i < n; i++) {
+        m[i, i] = static_cast<double>(i + 1) / 10;
+        for (std::size_t j = i + 1; j < n; j++) { m[i, j] = 0.01; }
+    }
+    m[0, 0] = 3;
+    m[0, 1] = 9.5;
+    m[1, 0] = -9.5;
+    m[1, 1] = 3;
+    const auto result{eigen::arnoldi(eigen::dense_operator(m), n, 3)};
+    return result.converged &&
+           std::abs(result.values[0] - std::complex{3.0, 9.5}) < 1e-8 &&
+           std::abs(result.values[1] - std::complex{3.0, -9.5}) < 1e-8 &&
+           std::abs(result.values[2] - std::complex{4.0, 0.0}) < 1e-8;
+};
+
+auto test_arnoldi_restarts() -> bool {
+    // 2 x 2 rotation blocks with the eigenvalues r e^(+-i phi), r = 1 + j / 10
+    // and phi = 0.3 + 0.05 j, coupled above the diagonal. A subspace of 14
+    // vectors forces many restarts, each applying conjugate pairs of shifts
+    const std::size_t n{60};
+    const auto eigenvalue{[](std::size_t j) {
+        return std::polar(1 + static_cast<double>(j) / 10,
+                          0.3 + 0.05 * static_cast<double>(j));
+    }};
+    matrix<double> m{n, n, 0};
+    for (std::size_t j = 0; j < n / 2; j++) {
+        const std::complex<double> lambda{eigenvalue(j)};
+        const std::size_t i{2 * j};
+        m[i, i] = lambda.real();
+        m[i, i + 1] = lambda.imag();
+        m[i + 1, i] = -lambda.imag();
+        m[i + 1, i + 1] = lambda.real();
+        for (std::size_t col = i + 2; col < n; col++) { m[i, col] = 0.01; }
+    }
+    const auto result{eigen::arnoldi(eigen::dense_operator(m),
+                                     n,
+                                     4,
+                                     {.subspace_dimension = 14})};
+    // |A x - lambda x| of the returned Ritz pairs, small only if the restarts
+    // kept A V = V H + f e^T
+    double residual{0};
+    for (std::size_t i = 0; i < 4; i++) {
+        double squares{0};
+        for (std::size_t row = 0; row < n; row++) {
+            std::complex<double> value{-result.values[i] *
+                                       result.vectors[row, i]};
+            for (std::size_t col = 0; col < n; col++) {
+                value += m[row, col] * result.vectors[col, i];
+            }
+            squares += std::norm(value);
+        }
+        residual = std::max(residual, std::sqrt(squares));
+    }
+    return result.converged && result.restarts > 3 && residual < 1e-9 &&
+           std::abs(result.values[0] - eigenvalue(29)) < 1e-8 &&
+           std::abs(result.values[1] - std::conj(eigenvalue(29))) < 1e-8 &&
+           std::abs(result.values[2] - eigenvalue(28)) < 1e-8 &&
+           std::abs(result.values[3] - std::conj(eigenvalue(28))) < 1e-8;
+};
+
 int main(int argc, char const *argv[]) {
 
 
@@ -131,7 +268,13 @@ int main(int argc, char const *argv[]) {
                                           test_inverse_power_method(),
                                           test_rayleigh(),
                                           test_qr(),
-                                          test_jacobi()},
+                                          test_jacobi(),
+                                          test_power_method_iteration_cap(),
+                                          test_lanczos(),
+                                          test_block_lanczos(),
+                                          test_lanczos_zero_eigenvalue(),
+                                          test_arnoldi(),
+                                          test_arnoldi_restarts()},
                                std::identity{})
                ? 0
                : 1;
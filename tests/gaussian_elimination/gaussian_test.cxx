@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <print>
 #include <set>
 #include <valarray>
@@ -105,6 +106,94 @@ auto test_inverse() {
     return matrix_equal(utils::matrix::inverse(m).value(), inverse_test);
 }
 
+auto test_echelon_swap() {
+    matrix<fraction<int>> m{3, 3, {0}};
+    std::array<fraction<int>, 9> m_array{
+        {{0}, {1}, {1}, {1}, {0}, {1}, {2}, {1}, {0}}};
+    std::vector<std::string> steps_test{
+        "swap R2 with R1", "R3 - 2/1 * R1", "R3 - 1/1 * R2"};
+    std::size_t iterator = 0;
+    for (std::size_t i = 0; i < 3; i++) {
+        for (std::size_t j = 0; j < 3; j++) {
+            m[i, j] = m_array[iterator];
+            iterator++;
+        }
+    }
+    return testing::expect_equal(utils::matrix::show_steps(m), steps_test) &&
+           testing::expect_equal(utils::matrix::determinant(m).value(),
+                                 fraction<int>{3, 1});
+}
+
+
+auto test_lu_pivoting() {
+    using utils::matrix::pivoting;
+    matrix<double> m{3, 3, 0.0};
+    std::array<double, 9> m_array{0, 2, 1, 4, -6, 0, -2, 7, 3};
+    std::vector<double> x{1, 2, 3};
+    std::vector<double> b(3, 0.0);
+    for (std::size_t i = 0; i < 3; i++) {
+        for (std::size_t j = 0; j < 3; j++) {
+            m[i, j] = m_array[(i * 3) + j];
+            b[i] += m[i, j] * x[j];
+        }
+    }
+    bool ok{true};
+    for (auto strategy : {pivoting::partial,
+                          pivoting::scaled_partial,
+                          pivoting::rook,
+                          pivoting::complete}) {
+        auto lu = utils::matrix::lu_decomposition(m, strategy).value();
+        auto solution = utils::matrix::lu_solve(lu, b).value();
+        for (std::size_t i = 0; i < 3; i++) {
+            ok = ok && std::abs(solution[i] - x[i]) < 1e-12;
+        }
+        ok = ok && std::abs(utils::matrix::lu_determinant(lu) + 8) < 1e-12;
+        auto inverse = utils::matrix::lu_inverse(m, strategy).value();
+        for (std::size_t i = 0; i < 3; i++) {
+            for (std::size_t j = 0; j < 3; j++) {
+                double entry{0};
+                for (std::size_t k = 0; k < 3; k++) {
+                    entry += m[i, k] * inverse[k, j];
+                }
+                ok = ok && std::abs(entry - (i == j ? 1.0 : 0.0)) < 1e-12;
+            }
+        }
+    }
+    return ok;
+}
+
+
+auto test_lu_singular() {
+    using utils::matrix::pivoting;
+    matrix<double> m{3, 3, 0.0};
+    std::array<double, 9> m_array{1, 2, 3, 2, 4, 6, 1, 1, 1};
+    for (std::size_t i = 0; i < 9; i++) { m[i / 3, i % 3] = m_array[i]; }
+    auto lu = utils::matrix::lu_decomposition(m, pivoting::complete).value();
+    return testing::expect_equal(lu.rank, 2zU) &&
+           testing::expect_equal(utils::matrix::lu_determinant(lu), 0.0) &&
+           !utils::matrix::lu_solve(lu, std::vector<double>(3, 1.0)) &&
+           !utils::matrix::lu_decomposition(matrix<double>{2, 3, 0.0});
+}
+
+auto test_fraction_arithmetic() {
+    const fraction<int> a{3, 4};
+    const fraction<int> b{3, 5};
+    const lazy_fraction<long> c{6, 8};
+    const lazy_fraction<long> d{9, 15};
+    return testing::expect_equal(binary_gcd(-84, 36), 12U) &&
+           (a != b) && !(a != a) && (a != fraction<int>{1, 4}) &&
+           testing::expect_equal(a * b, fraction<int>{9, 20}) &&
+           testing::expect_equal(a / b, fraction<int>{5, 4}) &&
+           testing::expect_equal(a - b, fraction<int>{3, 20}) &&
+           testing::expect_equal(b - a, fraction<int>{-3, 20}) &&
+           testing::expect_equal(a + a, fraction<int>{3, 2}) &&
+           testing::expect_equal(a / fraction<int>{-3, 2},
+                                 fraction<int>{-1, 2}) &&
+           (c * d == lazy_fraction<long>{9, 20}) &&
+           testing::expect_equal((c - d).to_rational(),
+                                 fraction<long>{3, 20});
+}
+
 int main() {
     bool ok{testing::expect_equal(1, 1) &&
             testing::expect_equal(std::vector<std::int64_t>{1, 2},
@@ -115,7 +204,11 @@ int main() {
                                           test_reduction(),
                                           test_steps(),
                                           test_determinant(),
-                                          test_inverse()},
+                                          test_inverse(),
+                                          test_echelon_swap(),
+                                          test_lu_pivoting(),
+                                          test_lu_singular(),
+                                          test_fraction_arithmetic()},
                                std::identity{})
                ? 0
                : 1;
@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../../discrete_math/polynomials/polynomial.hpp"
+#include "../../discrete_math/polynomials/sparse.hpp"
+
+import expect;
+
+
+namespace {
+
+    using modular = number_theory::static_modint<998244353>;
+
+    // n pseudo random values drawn from [-range, range]
+    template <typename T>
+    auto random_coefficients(std::size_t n,
+                             std::int64_t range,
+                             std::uint64_t seed) -> std::vector<T> {
+        std::mt19937_64 random{seed};
+        std::uniform_int_distribution<std::int64_t> value{-range, range};
+        std::vector<T> result(n);
+        for (auto& x : result) { x = static_cast<T>(value(random)); }
+        return result;
+    }
+
+    template <typename T>
+    auto product(const std::vector<T>& a, const std::vector<T>& b)
+        -> std::vector<T> {
+        return polynomial::multiplication::multiply(std::span<const T>{a},
+                                                    std::span<const T>{b});
+    }
+
+    template <typename T>
+    auto schoolbook(const std::vector<T>& a, const std::vector<T>& b)
+        -> std::vector<T> {
+        return polynomial::multiplication::schoolbook(std::span<const T>{a},
+                                                      std::span<const T>{b});
+    }
+
+    // the rounding error of the FFT is relative to the largest coefficient
+    auto close(const std::vector<double>& a, const std::vector<double>& b)
+        -> bool {
+        double scale{1};
+        for (const double x : b) { scale = std::max(scale, std::abs(x)); }
+        return a.size() == b.size() &&
+               std::ranges::equal(a, b, [scale](double x, double y) {
+                   return std::abs(x - y) <= 1e-9 * scale;
+               });
+    }
+
+    // values of c at the points xs by one of the multipoint schemes
+    template <typename T>
+    auto values_at(const std::vector<T>& c,
+                   const std::vector<T>& xs,
+                   void (*evaluate)(std::span<const T>,
+                                    std::span<const T>,
+                                    std::span<T>)) -> std::vector<T> {
+        std::vector<T> result(xs.size());
+        evaluate(std::span<const T>{c},
+                 std::span<const T>{xs},
+                 std::span<T>{result});
+        return result;
+    }
+
+    template <typename T>
+    auto horner_at(const std::vector<T>& c, const std::vector<T>& xs)
+        -> std::vector<T> {
+        std::vector<T> result(xs.size());
+        for (std::size_t i = 0; i < xs.size(); i++) {
+            result[i] =
+                polynomial::evaluation::horner(std::span<const T>{c}, xs[i]);
+        }
+        return result;
+    }
+
+    // the coefficients up to the degree, those above it are not part of
+    // the polynomial
+    template <typename T>
+    auto significant(const polynomial::polynomial<T>& p) -> std::vector<T> {
+        return {p.coefficients.begin(),
+                p.coefficients.begin() +
+                    static_cast<std::ptrdiff_t>(p.degree) + 1};
+    }
+
+    // terms at the given exponents with random nonzero coefficients
+    auto random_sparse(std::initializer_list<std::size_t> exponents,
+                       std::uint64_t seed)
+        -> polynomial::sparse_polynomial<modular> {
+        polynomial::sparse_polynomial<modular> result{};
+        const auto coefficients{
+            random_coefficients<modular>(exponents.size(), 1'000'000, seed)};
+        std::size_t i{0};
+        for (const std::size_t exponent : exponents) {
+            const modular c{coefficients[i++]};
+            result.terms.push_back({exponent, c == modular{0} ? 1 : c});
+        }
+        return result;
+    }
+
+    // product of the factors given by their coefficients
+    template <typename T>
+    auto expand(std::initializer_list<std::vector<T>> factors)
+        -> std::vector<T> {
+        std::vector<T> result{1};
+        for (const auto& factor : factors) { result = product(result, factor); }
+        return result;
+    }
+
+    template <typename T>
+    auto monic(std::vector<T> a) -> std::vector<T> {
+        const T lead{a.back()};
+        for (auto& x : a) { x = x / lead; }
+        return a;
+    }
+
+}  // namespace
+
+
+// lengths of the shorter factor just below, at and above every threshold,
+// the longer factor is cut into pieces by Karatsuba; small integers take
+// the exact FFT, large ones Karatsuba or from ntt_threshold on the NTT
+auto test_multiplication() -> bool {
+    namespace multiplication = polynomial::multiplication;
+    bool ok{true};
+    for (const std::size_t threshold : {multiplication::karatsuba_threshold,
+                                        multiplication::fft_threshold,
+                                        multiplication::ntt_threshold}) {
+        for (const std::size_t n : {threshold - 1, threshold, threshold + 1}) {
+            const std::size_t longer{3 * n + 5};
+            const auto small_a{random_coefficients<std::int64_t>(n, 100, 1)};
+            const auto small_b{
+                random_coefficients<std::int64_t>(longer, 100, 2)};
+            const auto large_a{
+                random_coefficients<std::int64_t>(n, 1'000'000, 3)};
+            const auto large_b{
+                random_coefficients<std::int64_t>(longer, 1'000'000, 4)};
+            const auto real_a{random_coefficients<double>(n, 100, 5)};
+            const auto real_b{random_coefficients<double>(longer, 100, 6)};
+            ok = ok &&
+                 testing::expect_equal(product(small_a, small_b),
+                                       schoolbook(small_a, small_b)) &&
+                 testing::expect_equal(product(large_a, large_b),
+                                       schoolbook(large_a, large_b)) &&
+                 testing::expect_equal(product(large_b, large_a),
+                                       schoolbook(large_a, large_b)) &&
+                 testing::expect_equal(
+                     multiplication::karatsuba(
+                         std::span<const std::int64_t>{large_a},
+                         std::span<const std::int64_t>{large_a}),
+                     schoolbook(large_a, large_a)) &&
+                 close(product(real_a, real_b), schoolbook(real_a, real_b));
+        }
+    }
+    return ok;
+}
+
+
+// quotient and divisor lengths on both sides of newton_threshold, exact
+// modular coefficients so that Newton inversion and long division agree
+auto test_division() -> bool {
+    namespace division = polynomial::division;
+    bool ok{true};
+    constexpr std::array<std::pair<std::size_t, std::size_t>, 5> lengths{
+        {{40, 17}, {600, 300}, {511, 256}, {1000, 255}, {800, 256}}};
+    for (const auto& [na, nb] : lengths) {
+        const auto a{random_coefficients<modular>(na, 1'000'000, na)};
+        auto b{random_coefficients<modular>(nb, 1'000'000, nb)};
+        b.back() = modular{7};
+        const std::span<const modular> sa{a};
+        const std::span<const modular> sb{b};
+        const auto expected{division::long_division(sa, sb)};
+        auto [quotient, remainder]{division::divmod(sa, sb)};
+        auto rebuilt{product(quotient, b)};
+        for (std::size_t i = 0; i < remainder.size(); i++) {
+            rebuilt[i] += remainder[i];
+        }
+        ok = ok &&
+             testing::expect_equal(division::newton_division(sa, sb),
+                                   expected) &&
+             testing::expect_equal(std::pair{quotient, remainder},
+                                   expected) &&
+             testing::expect_equal(rebuilt, a);
+    }
+    return ok;
+}
+
+
+// a = g u and b = g v for random u and v, which are coprime with high
+// probability over GF(998244353), so the gcd is g up to a constant; the
+// half-GCD has to end at the pair of the Euclidean remainder sequence
+// whose second degree first drops below half the degree of a
+auto test_gcd() -> bool {
+    namespace division = polynomial::division;
+    bool ok{true};
+    constexpr std::array<std::array<std::size_t, 3>, 3> degrees{
+        {{0, 300, 200}, {1, 40, 40}, {150, 700, 650}}};
+    for (const auto& [dg, du, dv] : degrees) {
+        const auto g{random_coefficients<modular>(dg + 1, 1'000'000, 7)};
+        const auto u{random_coefficients<modular>(du + 1, 1'000'000, 8)};
+        const auto v{random_coefficients<modular>(dv + 1, 1'000'000, 9)};
+        ok = ok && testing::expect_equal(
+                       monic(division::fast_gcd(product(g, u), product(g, v))),
+                       monic(g));
+    }
+
+    const auto a{random_coefficients<modular>(2001, 1'000'000, 10)};
+    const auto b{random_coefficients<modular>(2000, 1'000'000, 11)};
+    const auto [c, d]{division::apply(division::half_gcd(a, b), a, b)};
+    const std::ptrdiff_t half{(division::degree(a) + 1) / 2};
+    auto e{a};
+    auto f{b};
+    while (division::degree(f) >= half) {
+        auto remainder{division::remainder_step(e, f).second};
+        e = std::exchange(f, std::move(remainder));
+    }
+
+    // floating point coefficients take the Euclidean algorithm
+    const std::vector<double> p{2, -3, 1};
+    const std::vector<double> q{3, -4, 1};
+    return ok && testing::expect_equal(c, e) && testing::expect_equal(d, f) &&
+           testing::expect_equal(monic(division::fast_gcd(p, q)),
+                                 std::vector<double>{-1, 1});
+}
+
+
+// every scheme against Horner's on exact modular coefficients: Estrin's
+// around its block length, batched Horner with and without a partial group
+// of lanes, the subproduct tree and the parallel split of a large batch
+auto test_evaluation() -> bool {
+    namespace evaluation = polynomial::evaluation;
+    bool ok{true};
+    for (const std::size_t n : {1, 15, 16, 17, 63, 64, 65, 200}) {
+        const auto c{random_coefficients<modular>(n, 1'000'000, n)};
+        for (const std::int64_t x : {0, 1, -1, 2, 123'456'789}) {
+            ok = ok && testing::expect_equal(
+                           evaluation::estrin(std::span<const modular>{c},
+                                              modular{x}),
+                           evaluation::horner(std::span<const modular>{c},
+                                              modular{x}));
+        }
+    }
+    for (const std::size_t points : {1, 7, 8, 9, 17, 100}) {
+        const auto c{random_coefficients<modular>(150, 1'000'000, 12)};
+        const auto xs{random_coefficients<modular>(points, 1'000'000, 13)};
+        ok = ok &&
+             testing::expect_equal(
+                 values_at(c, xs, evaluation::horner_batch<modular>),
+                 horner_at(c, xs)) &&
+             testing::expect_equal(
+                 values_at(c, xs, evaluation::subproduct_evaluate<modular>),
+                 horner_at(c, xs));
+    }
+    const auto xs{random_coefficients<modular>(1000, 1'000'000, 14)};
+    for (const std::size_t n : {20, 1500}) {
+        const auto c{random_coefficients<modular>(n, 1'000'000, 15)};
+        ok = ok &&
+             testing::expect_equal(
+                 values_at(c, xs, evaluation::subproduct_evaluate<modular>),
+                 horner_at(c, xs));
+    }
+
+    // above parallel_threshold the points are split among the cores
+    const auto c{random_coefficients<modular>(1024, 1'000'000, 16)};
+    const auto many_xs{random_coefficients<modular>(
+        evaluation::parallel_threshold / 1024 + 999, 1'000'000, 17)};
+    const auto real_c{random_coefficients<double>(1024, 1, 18)};
+    std::vector<double> real_xs(many_xs.size());
+    for (std::size_t i = 0; i < real_xs.size(); i++) {
+        real_xs[i] = -1 + 2 * static_cast<double>(i) /
+                              static_cast<double>(real_xs.size());
+    }
+    const auto values{values_at(real_c, real_xs, evaluation::evaluate<double>)};
+    const auto expected{horner_at(real_c, real_xs)};
+    for (std::size_t i = 0; i < values.size(); i++) {
+        ok = ok && std::abs(values[i] - expected[i]) <=
+                       1e-9 * std::max(1.0, std::abs(expected[i]));
+    }
+    return ok && testing::expect_equal(
+                     values_at(c, many_xs, evaluation::evaluate<modular>),
+                     horner_at(c, many_xs));
+}
+
+
+// the degree of a sum is the larger degree, lowered only by leading
+// coefficients which cancel
+auto test_addition() -> bool {
+    using dense = polynomial::polynomial<int>;
+    const dense p{{1, 2, 3}, 2};
+    dense longer{p};
+    longer += dense{{1, -2}, 1};
+    dense shorter{{1, -2}, 1};
+    shorter += p;
+    dense cancelled{p};
+    cancelled += dense{{0, 0, -3}, 2};
+    dense zero{p};
+    zero -= p;
+    return testing::expect_equal(longer.degree, 2U) &&
+           testing::expect_equal(significant(longer),
+                                 std::vector<int>{2, 0, 3}) &&
+           testing::expect_equal(shorter.degree, 2U) &&
+           testing::expect_equal(significant(shorter),
+                                 std::vector<int>{2, 0, 3}) &&
+           testing::expect_equal(cancelled.degree, 1U) &&
+           testing::expect_equal(significant(cancelled),
+                                 std::vector<int>{1, 2}) &&
+           testing::expect_equal(zero.degree, 0U) &&
+           testing::expect_equal(significant(zero), std::vector<int>{0});
+}
+
+
+// sparse arithmetic against the dense one on the converted operands, and
+// the adaptive polynomial choosing its representation by density
+auto test_sparse() -> bool {
+    using sparse = polynomial::sparse_polynomial<modular>;
+    using polynomial::to_dense;
+    using polynomial::to_sparse;
+    const auto a{random_sparse({0, 3, 4, 100, 101, 700}, 20)};
+    const auto b{random_sparse({1, 3, 99, 100, 650}, 21)};
+    const auto dense_a{to_dense(a)};
+    const auto dense_b{to_dense(b)};
+    bool ok{testing::expect_equal(to_sparse(dense_a).terms, a.terms) &&
+            testing::expect_equal((a + b).terms,
+                                  to_sparse(dense_a + dense_b).terms) &&
+            testing::expect_equal((a - b).terms,
+                                  to_sparse(dense_a - dense_b).terms) &&
+            testing::expect_equal((a * b).terms,
+                                  to_sparse(dense_a * dense_b).terms) &&
+            testing::expect_equal((a - a).terms, sparse{}.terms) &&
+            testing::expect_equal(significant(to_dense(sparse{})),
+                                  std::vector<modular>{0})};
+    for (const std::int64_t x : {0, 1, -1, 3, 987'654'321}) {
+        ok = ok && testing::expect_equal(a(modular{x}), dense_a(modular{x}));
+    }
+
+    // (x - 1)(x + 1) = x^2 - 1 and x^1000000 + 1 keep two terms
+    const sparse x_minus_1{{{0, modular{-1}}, {1, modular{1}}}};
+    const sparse x_plus_1{{{0, modular{1}}, {1, modular{1}}}};
+    const sparse high{{{0, modular{1}}, {1'000'000, modular{1}}}};
+    const sparse top{{{1'000'000, modular{1}}}};
+    ok = ok &&
+         testing::expect_equal(
+             (x_minus_1 * x_plus_1).terms,
+             sparse{{{0, modular{-1}}, {2, modular{1}}}}.terms) &&
+         testing::expect_equal((high - top).terms,
+                               sparse{{{0, modular{1}}}}.terms) &&
+         testing::expect_equal(high(modular{2}),
+                               modular{2}.pow(1'000'000) + modular{1});
+
+    using adaptive = polynomial::adaptive_polynomial<modular>;
+    const adaptive sparse_high{high};
+    const adaptive sparse_a{a};
+    const adaptive dense_ones{polynomial::polynomial<modular>{
+        std::vector<modular>(10, modular{1}), 9}};
+    const auto product{sparse_high * dense_ones};
+    auto sum{dense_ones + dense_ones};
+    sum.normalize();
+    const auto cancelled{sparse_high - adaptive{top}};
+    return ok && product.is_sparse() && product.term_count() == 20 &&
+           testing::expect_equal(product(modular{3}),
+                                 high(modular{3}) * dense_ones(modular{3})) &&
+           !sum.is_sparse() &&
+           testing::expect_equal(significant(sum.dense()),
+                                 std::vector<modular>(10, modular{2})) &&
+           !cancelled.is_sparse() && cancelled.degree() == 0 &&
+           testing::expect_equal((sparse_a * sparse_a).sparse().terms,
+                                 (a * a).terms);
+}
+
+
+// polynomials built from known roots: rational ones with multiplicity, a
+// zero root, irreducible quadratic factors and coefficients with many
+// divisors for rational_roots, irrational and double roots for real_roots
+auto test_roots() -> bool {
+    namespace roots = polynomial::roots;
+    using q = rational<std::int64_t>;
+    // (3x - 2)^2 (2x + 5) (x - 7) x (x^2 + 2)
+    const auto f{expand<std::int64_t>(
+        {{-2, 3}, {-2, 3}, {5, 2}, {-7, 1}, {0, 1}, {2, 0, 1}})};
+    const std::span<const std::int64_t> sf{f};
+    // (x - 720720) (720720 x + 1) (x^2 - 2), 720720 has 240 divisors
+    const auto g{expand<std::int64_t>({{-720720, 1}, {1, 720720}, {-2, 0, 1}})};
+    const std::vector<std::int64_t> no_roots{-2, 0, 1};
+    const polynomial::polynomial<std::int64_t> dense_f{f, f.size() - 1};
+    bool ok{testing::expect_equal(
+                roots::rational_roots(sf),
+                std::vector<q>{{-5, 2}, {0, 1}, {2, 3}, {7, 1}}) &&
+            testing::expect_equal(
+                polynomial::rational_roots(dense_f),
+                std::vector<q>{{-5, 2}, {0, 1}, {2, 3}, {7, 1}}) &&
+            testing::expect_equal(
+                roots::rational_roots(std::span<const std::int64_t>{g}),
+                std::vector<q>{{-1, 720720}, {720720, 1}}) &&
+            roots::rational_roots(
+                std::span<const std::int64_t>{no_roots})
+                .empty() &&
+            testing::expect_equal(roots::divisors(720720).size(), 240U)};
+
+    // the modular filter keeps the roots 2/3 and 7, drops 1 and 2, and
+    // passes the untestable denominator 998244353
+    const std::vector<std::int64_t> ps{2, 7, 1, 2, 1};
+    const std::vector<std::int64_t> qs{3, 1, 1, 1, 998244353};
+    ok = ok && testing::expect_equal(
+                   roots::modular_filter<roots::filter_prime_1>(
+                       sf,
+                       std::span<const std::int64_t>{ps},
+                       std::span<const std::int64_t>{qs}),
+                   std::vector<bool>{true, true, false, false, true});
+
+    // (x - 3) (a x + 10) with 3 a just above the int64 range: dividing by
+    // x - 3 overflows, so the root 3 is confirmed and the perturbed
+    // constant term is rejected by the exact evaluation, as is 2^62 for
+    // x^2 + 1
+    constexpr std::int64_t a{3074457345618258603};
+    const std::vector<std::int64_t> wide{-30, -9223372036854775799, a};
+    const std::vector<std::int64_t> perturbed{-31, -9223372036854775799, a};
+    const std::vector<std::int64_t> square{1, 0, 1};
+    ok = ok &&
+         roots::divides(std::span<const std::int64_t>{wide},
+                        std::int64_t{3}, std::int64_t{1}) &&
+         !roots::divides(std::span<const std::int64_t>{perturbed},
+                         std::int64_t{3}, std::int64_t{1}) &&
+         !roots::divides(std::span<const std::int64_t>{square},
+                         std::int64_t{1} << 62, std::int64_t{1});
+
+    // (2x + 5) (3x - 1) (x^2 - 2) (x - 4)^3, a root of multiplicity k is
+    // only resolved to about the k-th root of the machine precision and may
+    // come as a cluster, so every root found has to be close to a known one
+    // and every known one close to a root found
+    const auto h{expand<double>(
+        {{5, 2}, {-1, 3}, {-2, 0, 1}, {-4, 1}, {-4, 1}, {-4, 1}})};
+    const std::vector<std::pair<double, double>> known{{-2.5, 1e-10},
+                                                       {-std::sqrt(2.0), 1e-10},
+                                                       {1.0 / 3, 1e-10},
+                                                       {std::sqrt(2.0), 1e-10},
+                                                       {4, 1e-4}};
+    const auto found{roots::real_roots(std::span<const double>{h})};
+    const auto near{[](double x, const std::pair<double, double>& root) {
+        return std::abs(x - root.first) <= root.second;
+    }};
+    ok = ok && std::ranges::is_sorted(found) &&
+         std::ranges::all_of(found,
+                             [&](double x) {
+                                 return std::ranges::any_of(
+                                     known, [&](const auto& root) {
+                                         return near(x, root);
+                                     });
+                             }) &&
+         std::ranges::all_of(known, [&](const auto& root) {
+             return std::ranges::any_of(
+                 found, [&](double x) { return near(x, root); });
+         });
+    const polynomial::polynomial<int> cubic{{-6, 11, -6, 1}, 3};
+    const auto integral{polynomial::real_roots(cubic)};
+    return ok && integral.size() == 3 &&
+           std::abs(integral[0] - 1) <= 1e-10 &&
+           std::abs(integral[1] - 2) <= 1e-10 &&
+           std::abs(integral[2] - 3) <= 1e-10;
+}
+
+
+int main() {
+    return std::ranges::all_of(std::array{test_multiplication(),
+                                          test_division(),
+                                          test_gcd(),
+                                          test_evaluation(),
+                                          test_addition(),
+                                          test_sparse(),
+                                          test_roots()},
+                               std::identity{})
+               ? 0
+               : 1;
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+import rational;
+import expect;
+
+
+using q = rational<int>;
+using q64 = rational<std::int64_t>;
+
+static_assert(q{1, 2} + q{1, 3} == q{5, 6});
+static_assert(q{3, 4} - q{3, 4} == q{0, 1});
+static_assert(q{2, 3} * q{3, 4} == q{1, 2});
+static_assert(q{2, 3} / q{-4, 3} == q{-1, 2});
+static_assert(q{-1, 2} < q{0, 1} && q{1, 3} < q{1, 2});
+static_assert(q{2, 4} == q{1, 2} && q{-3, -9} == q{1, 3});
+static_assert((q{2, 4} <=> q{1, 2}) == std::weak_ordering::equivalent);
+static_assert(binary_gcd(-84, 36) == 12U);
+static_assert(binary_gcd(std::numeric_limits<int>::min(), 0) == 1U << 31);
+
+
+auto test_arithmetic() -> bool {
+    q a{6, -8};
+    a.reduce();
+    q b{1, 6};
+    b += q{1, 3};
+    q c{5, 2};
+    c -= 2;
+    return testing::expect_equal(a, q{-3, 4}) &&
+           testing::expect_equal(b, q{1, 2}) &&
+           testing::expect_equal(c, q{1, 2}) &&
+           testing::expect_equal(-a * 4, q{3, 1}) &&
+           testing::expect_equal(a / 3, q{-1, 4}) &&
+           testing::expect_equal(std::max(a, b), b);
+}
+
+
+// the smallest value has no positive counterpart, reduce() still brings it
+// to lowest terms
+auto test_smallest() -> bool {
+    constexpr int min{std::numeric_limits<int>::min()};
+    q whole{min, min};
+    whole.reduce();
+    q zero{0, min};
+    zero.reduce();
+    q half{min, -2};
+    half.reduce();
+    q negative{6, min};
+    negative.reduce();
+    return testing::expect_equal(whole, q{1, 1}) &&
+           testing::expect_equal(zero, q{0, 1}) &&
+           testing::expect_equal(half, q{1 << 30, 1}) &&
+           testing::expect_equal(negative, q{-3, 1 << 30});
+}
+
+
+// a zero divisor throws instead of leaving a zero denominator behind
+auto test_division_by_zero() -> bool {
+    const auto throws{[](auto divide) {
+        try {
+            divide();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    }};
+    using lazy = lazy_rational<int>;
+    return throws([] { return q{1, 2} / q{0, 1}; }) &&
+           throws([] { return q{1, 2} / 0; }) &&
+           throws([] { return lazy{1, 2} / lazy{0, 1}; });
+}
+
+
+// the sums and comparisons of 64-bit rationals use a 128-bit intermediate
+auto test_wide_intermediate() -> bool {
+    constexpr std::int64_t max{std::numeric_limits<std::int64_t>::max()};
+    return testing::expect_equal(q64{max, 2} + q64{max, 2}, q64{max, 1}) &&
+           testing::expect_equal(q64{max, 2} - q64{-max, 2}, q64{max, 1}) &&
+           (q64{max - 1, max} < q64{max, max - 1});
+}
+
+
+auto test_batch() -> bool {
+    std::vector<q> row{{1, 1}, {2, 1}, {3, 1}};
+    const std::vector<q> pivot{{1, 1}, {1, 1}, {1, 1}};
+    subtract_multiple(std::span{row}, q{2, 1}, std::span{pivot});
+    const bool integral{
+        testing::expect_equal(row, std::vector<q>{{-1, 1}, {0, 1}, {1, 1}})};
+    subtract_multiple(std::span{row}, q{1, 2}, std::span{pivot});
+    std::vector<q> sum(3);
+    add_all(std::span{row}, std::span{pivot}, std::span{sum});
+    std::vector<q> product(3);
+    multiply_all(std::span{row}, std::span{row}, std::span{product});
+    std::vector<q> unreduced{{2, 4}, {-3, -9}, {5, 1}};
+    normalize_all(std::span{unreduced});
+    return integral &&
+           testing::expect_equal(row,
+                                 std::vector<q>{{-3, 2}, {-1, 2}, {1, 2}}) &&
+           testing::expect_equal(sum,
+                                 std::vector<q>{{-1, 2}, {1, 2}, {3, 2}}) &&
+           testing::expect_equal(product,
+                                 std::vector<q>{{9, 4}, {1, 4}, {1, 4}}) &&
+           testing::expect_equal(unreduced,
+                                 std::vector<q>{{1, 2}, {1, 3}, {5, 1}});
+}
+
+
+auto test_lazy() -> bool {
+    const lazy_rational<std::int64_t> a{6, 8};
+    const lazy_rational<std::int64_t> b{9, 15};
+    return (a * b == lazy_rational<std::int64_t>{9, 20}) && (b < a) &&
+           testing::expect_equal((a - b).to_rational(), q64{3, 20}) &&
+           testing::expect_equal((a / b).to_rational(), q64{5, 4});
+}
+
+
+int main() {
+    return std::ranges::all_of(std::array{test_arithmetic(),
+                                          test_smallest(),
+                                          test_division_by_zero(),
+                                          test_wide_intermediate(),
+                                          test_batch(),
+                                          test_lazy()},
+                               std::identity{})
+               ? 0
+               : 1;
+}
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <print>
 #include <set>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 import recursion;
@@ -15,6 +17,8 @@ import expect;
 auto recursion_tests() -> bool {
     return testing::expect_equal(chocolates(15, 3, 3), 7) &&
            testing::expect_equal(is_prime(17), true) &&
+           testing::expect_equal(is_prime(18446744073709551557U), true) &&
+           testing::expect_equal(is_prime(1000000007ULL * 998244353ULL), false) &&
            testing::expect_equal(product(15, 5), 75) &&
            testing::expect_equal(sum_of_digits(4523), 14) &&
            testing::expect_equal(to_binary(18), 10010) &&
@@ -22,7 +26,41 @@ auto recursion_tests() -> bool {
            testing::expect_equal(tiles(5, 5), 25) &&
            testing::expect_equal(count_decompositions_as_sum_of_powers(26, 2),
                                  2) &&
-           testing::expect_equal(fibonacci(4), 3);
+           testing::expect_equal(fibonacci(4), 3) &&
+           testing::expect_equal(fibonacci(90), 2880067194370816120ULL) &&
+           testing::expect_equal(product(-7, 9), -63) &&
+           testing::expect_equal(iota_sum(4000000000U), 8000000002000000000ULL) &&
+           testing::expect_equal(count_decompositions_as_sum_of_powers(100, 2),
+                                 3) &&
+           testing::expect_equal(count_queens(8), 92) &&
+           testing::expect_equal(count_queens(13), 73712);
+}
+
+
+auto test_queens_on_pool() -> bool {
+    work_stealing_pool pool{2};
+    return testing::expect_equal(count_queens(1, pool), 1) &&
+           testing::expect_equal(count_queens(6, pool), 4) &&
+           testing::expect_equal(count_queens(9, pool), 352);
+}
+
+
+// the first k values of a lazy enumerator, the loop breaks after the k-th
+// value and the abandoned coroutine is destroyed with the generator
+auto first(auto values, std::size_t k) {
+    std::vector<std::remove_cvref_t<decltype(*values.begin())>> result;
+    if (k == 0) { return result; }
+    for (const auto& value : values) {
+        result.push_back(value);
+        if (result.size() == k) { break; }
+    }
+    return result;
+}
+
+
+auto prefix(auto all, std::size_t k) {
+    all.resize(std::min(all.size(), k));
+    return all;
 }
 
 
@@ -68,6 +106,14 @@ auto test_vectors() -> bool {
                                                         {3},
                                                         {5, 6},
                                                         {5}};
+    std::vector<std::string> ones_first{
+        "1111", "1110", "1101", "1100", "1011", "1010"};
+    std::vector<std::vector<int>> pairs{
+        {1, 2}, {1, 3}, {2, 3}, {1, 4}, {2, 4}, {3, 4}};
+    std::vector<std::uint64_t> gray_masks;
+    for_each_gray_subset(3, [&](std::uint64_t mask, std::size_t, bool) {
+        gray_masks.push_back(mask);
+    });
 
     return testing::expect_equal(factorizations(16), factorization) &&
            testing::expect_equal(sum_decomposition(8, 4), decompositions_sum) &&
@@ -79,7 +125,50 @@ auto test_vectors() -> bool {
            testing::expect_equal(increasing_representations(2),
                                  representations_increased) &&
            testing::expect_equal(alternating({1, 3, 5}, {2, 4, 6}),
-                                 alternating_sequences);
+                                 alternating_sequences) &&
+           testing::expect_equal(more_ones(4), ones_first) &&
+           testing::expect_equal(subsets_of_size({1, 2, 3, 4}, 2), pairs) &&
+           testing::expect_equal(gray_masks,
+                                 std::vector<std::uint64_t>{1, 3, 2, 6, 7, 5, 4});
+}
+
+
+auto test_lazy() -> bool {
+    const std::set<char> letters{'a', 'b', 'c'};
+    // 2^40 subsets and 26^12 sequences, only their beginning is enumerated
+    std::set<std::int32_t> many;
+    for (std::int32_t i = 1; i <= 40; i++) { many.insert(i); }
+    std::set<char> alphabet;
+    for (char c = 'a'; c <= 'z'; c++) { alphabet.insert(c); }
+    const std::vector<std::vector<int>> first_subsets{
+        {1}, {1, 2}, {1, 2, 3}, {1, 2, 3, 4}};
+    const std::vector<std::string> first_sequences{"a", "aa", "aaa"};
+
+    return testing::expect_equal(first(lazy_factorizations(16), 3),
+                                 prefix(factorizations(16), 3)) &&
+           testing::expect_equal(
+               first(lazy_sequences_from_a_set(letters, 2), 5),
+               prefix(sequences_from_a_set(letters, 2), 5)) &&
+           testing::expect_equal(first(lazy_more_ones(4), 2),
+                                 prefix(more_ones(4), 2)) &&
+           testing::expect_equal(first(lazy_subsets({1, 2, 3}), 4),
+                                 prefix(subsets({1, 2, 3}), 4)) &&
+           testing::expect_equal(
+               first(lazy_increasing_representations(2), 10),
+               prefix(increasing_representations(2), 10)) &&
+           testing::expect_equal(
+               first(lazy_non_increasing_decompositions(6), 4),
+               prefix(non_increasing_decompositions(6), 4)) &&
+           testing::expect_equal(
+               first(lazy_alternating({1, 3, 5}, {2, 4, 6}), 6),
+               prefix(alternating({1, 3, 5}, {2, 4, 6}), 6)) &&
+           testing::expect_equal(first(lazy_factorizations(16), 0).size(), 0) &&
+           testing::expect_equal(first(lazy_factorizations(16), 100),
+                                 factorizations(16)) &&
+           testing::expect_equal(first(lazy_subsets(many), 4), first_subsets) &&
+           testing::expect_equal(
+               first(lazy_sequences_from_a_set(alphabet, 12), 3),
+               first_sequences);
 }
 
 
@@ -113,7 +202,9 @@ int main() {
 
     return std::ranges::all_of(std::array{ok,
                                           recursion_tests(),
+                                          test_queens_on_pool(),
                                           test_vectors(),
+                                          test_lazy(),
                                           test_sorts(),
                                           test_maze()},
                                std::identity{})
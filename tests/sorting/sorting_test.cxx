@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+import sorting;
+import expect;
+
+
+namespace {
+
+    // n pseudo random values drawn from [-range, range], so small ranges
+    // give many duplicates
+    auto random_input(std::size_t n, std::int32_t range)
+        -> std::vector<std::int32_t> {
+        std::mt19937 random{static_cast<std::uint32_t>(n)};
+        std::uniform_int_distribution<std::int32_t> value{-range, range};
+        std::vector<std::int32_t> result(n);
+        for (auto& x : result) { x = value(random); }
+        return result;
+    }
+
+    auto sorted(std::vector<std::int32_t> v) -> std::vector<std::int32_t> {
+        std::ranges::sort(v);
+        return v;
+    }
+
+}  // namespace
+
+
+auto test_small() -> bool {
+    constexpr std::int32_t lowest{std::numeric_limits<std::int32_t>::min()};
+    constexpr std::int32_t highest{std::numeric_limits<std::int32_t>::max()};
+    const std::vector<std::int32_t> extremes{
+        highest, 3, lowest, -1, highest, 0, lowest, 7, 2};
+    bool ok{testing::expect_equal(sorting::insertion_sort(extremes),
+                                  sorted(extremes)) &&
+            testing::expect_equal(sorting::network_sort(extremes),
+                                  sorted(extremes)) &&
+            testing::expect_equal(sorting::network_sort(
+                                      std::vector<std::int32_t>{}),
+                                  std::vector<std::int32_t>{})};
+    for (std::size_t n = 1; n <= sorting::network_size; n++) {
+        const auto input{random_input(n, 1000)};
+        ok = ok &&
+             testing::expect_equal(sorting::network_sort(input),
+                                   sorted(input)) &&
+             testing::expect_equal(sorting::insertion_sort(input),
+                                   sorted(input));
+    }
+    return ok;
+}
+
+
+auto test_radix() -> bool {
+    const std::vector<std::int32_t> signs{5, -3, 0, -2147483647, 12, -3};
+    const auto wide{random_input(100'000, 2'000'000'000)};
+    const auto narrow{random_input(100'000, 100)};
+    return testing::expect_equal(sorting::radix_sort(signs),
+                                 sorted(signs)) &&
+           testing::expect_equal(sorting::radix_sort(wide), sorted(wide)) &&
+           testing::expect_equal(sorting::radix_sort(narrow),
+                                 sorted(narrow)) &&
+           testing::expect_equal(sorting::sort(wide), sorted(wide));
+}
+
+
+auto test_parallel() -> bool {
+    work_stealing_pool pool{4};
+    const auto input{random_input(300'000, 2'000'000'000)};
+    auto wide{input};
+    auto equal{std::vector<std::int32_t>(200'000, 42)};
+    sorting::parallel_sort(std::span{wide}, pool);
+    sorting::parallel_sort(std::span{equal}, pool);
+
+    std::vector<std::string> words;
+    for (const std::int32_t x : random_input(100'000, 1'000'000)) {
+        words.push_back(std::to_string(x));
+    }
+    auto expected{words};
+    std::ranges::sort(expected, std::ranges::greater{});
+    sorting::parallel_sort(std::span{words}, pool, std::ranges::greater{});
+
+    return testing::expect_equal(wide, sorted(input)) &&
+           testing::expect_equal(equal,
+                                 std::vector<std::int32_t>(200'000, 42)) &&
+           testing::expect_equal(words, expected);
+}
+
+
+// elements without a default constructor are moved into uninitialized
+// storage, a throwing comparator reaches the caller instead of a worker
+auto test_parallel_failures() -> bool {
+    struct wrapped {
+        explicit wrapped(std::int32_t x) : value{x} {}
+        std::int32_t value;
+    };
+    work_stealing_pool pool{4};
+    const auto input{random_input(200'000, 1'000'000)};
+    std::vector<wrapped> values;
+    for (const std::int32_t x : input) { values.emplace_back(x); }
+    sorting::parallel_sort(
+        std::span{values}, pool, [](const wrapped& a, const wrapped& b) {
+            return a.value < b.value;
+        });
+    std::vector<std::int32_t> unwrapped;
+    for (const auto& w : values) { unwrapped.push_back(w.value); }
+
+    constexpr std::int32_t poison{std::numeric_limits<std::int32_t>::max()};
+    auto failing{input};
+    failing[failing.size() / 2] = poison;
+    bool thrown{false};
+    try {
+        sorting::parallel_sort(std::span{failing},
+                               pool,
+                               [](std::int32_t a, std::int32_t b) {
+                                   if (a == poison || b == poison) {
+                                       throw std::runtime_error{"poison"};
+                                   }
+                                   return a < b;
+                               });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    return testing::expect_equal(unwrapped, sorted(input)) && thrown;
+}
+
+
+int main() {
+    return std::ranges::all_of(
+               std::array{test_small(),
+                          test_radix(),
+                          test_parallel(),
+                          test_parallel_failures()},
+               std::identity{})
+               ? 0
+               : 1;
+}
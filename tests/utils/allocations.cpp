@@ -0,0 +1,31 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "benchmark.hpp"
+
+
+namespace {
+
+    std::atomic<std::size_t> allocation_counter{0};
+
+}  // namespace
+
+
+auto benchmark::allocations() -> std::size_t {
+    return allocation_counter.load(std::memory_order_relaxed);
+}
+
+
+auto operator new(std::size_t size) -> void* {
+    allocation_counter.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc{};
+}
+
+
+auto operator delete(void* p) noexcept -> void { std::free(p); }
+
+
+auto operator delete(void* p, std::size_t) noexcept -> void { std::free(p); }
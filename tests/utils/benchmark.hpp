@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace benchmark {
+
+    /*one measured point of the sweep. gflops is 0 for kernels without a
+     * flop model (iterative eigen solvers, file input/output)*/
+    struct record {
+        std::string kernel;
+        std::string type;
+        std::size_t size{0};
+        std::size_t iterations{0};
+        double ns_per_op{0};
+        double gflops{0};
+        double allocations_per_op{0};
+    };
+
+    /*every kernel is run once as a warm up and then repeated until
+     * min_time elapsed or max_iterations runs were made*/
+    struct settings {
+        std::size_t min_size{4};
+        std::size_t max_size{4096};
+        std::chrono::nanoseconds min_time{std::chrono::milliseconds{200}};
+        std::size_t max_iterations{1'000'000};
+        std::string filter{};
+    };
+
+    /*number of calls to the global operator new made so far, the counting
+     * operator new lives in allocations.cpp of libbenchmark*/
+    auto allocations() -> std::size_t;
+
+    /*keeps the compiler from discarding a result that is never read*/
+    template <typename T>
+    inline auto keep(T&& value) -> void {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /*sizes of the sweep: powers of two from s.min_size up to
+     * min(s.max_size, cap)*/
+    inline auto sizes(const settings& s, std::size_t cap) {
+        std::vector<std::size_t> result{};
+        for (std::size_t n = s.min_size; n <= std::min(s.max_size, cap);
+             n *= 2) {
+            result.push_back(n);
+        }
+        return result;
+    }
+
+    inline auto selected(const settings& s, std::string_view kernel) -> bool {
+        return s.filter.empty() || kernel.find(s.filter) != kernel.npos;
+    }
+
+    /*times f, flops is the number of floating point (or fraction)
+     * operations of one call, 0 when there is no model*/
+    template <typename F>
+    auto measure(std::string_view kernel,
+                 std::string_view type,
+                 std::size_t n,
+                 double flops,
+                 const settings& s,
+                 F&& f) -> record {
+        using clock = std::chrono::steady_clock;
+        f();
+        const std::size_t allocations_before{allocations()};
+        std::size_t iterations{0};
+        const auto start{clock::now()};
+        auto elapsed{clock::duration{}};
+        do {
+            f();
+            iterations++;
+            elapsed = clock::now() - start;
+        } while (elapsed < s.min_time && iterations < s.max_iterations);
+        const auto count{static_cast<double>(iterations)};
+        const double ns{
+            std::chrono::duration<double, std::nano>(elapsed).count() / count};
+        return record{
+            .kernel = std::string{kernel},
+            .type = std::string{type},
+            .size = n,
+            .iterations = iterations,
+            .ns_per_op = ns,
+            .gflops = flops > 0 ? flops / ns : 0,
+            .allocations_per_op =
+                static_cast<double>(allocations() - allocations_before) /
+                count};
+    }
+
+    inline auto write_csv(const std::vector<record>& records,
+                          const std::string& path) -> void {
+        std::ofstream out{path};
+        std::println(
+            out, "kernel,type,size,iterations,ns_per_op,gflops,allocations");
+        for (const auto& r : records) {
+            std::println(out,
+                         "{},{},{},{},{:.1f},{:.4f},{:.1f}",
+                         r.kernel,
+                         r.type,
+                         r.size,
+                         r.iterations,
+                         r.ns_per_op,
+                         r.gflops,
+                         r.allocations_per_op);
+        }
+    }
+
+    inline auto write_json(const std::vector<record>& records,
+                           const std::string& path) -> void {
+        std::ofstream out{path};
+        std::println(out, "{{\n  \"benchmarks\": [");
+        for (std::size_t i = 0; i < records.size(); i++) {
+            const auto& r{records[i]};
+            std::print(out,
+                       "    {{\"kernel\": \"{}\", \"type\": \"{}\", "
+                       "\"size\": {}, \"iterations\": {}, \"ns_per_op\": "
+                       "{:.1f}, \"gflops\": {}, \"allocations\": {:.1f}}}",
+                       r.kernel,
+                       r.type,
+                       r.size,
+                       r.iterations,
+                       r.ns_per_op,
+                       r.gflops > 0 ? std::format("{:.4f}", r.gflops)
+                                    : std::string{"null"},
+                       r.allocations_per_op);
+            std::println(out, "{}", i + 1 < records.size() ? "," : "");
+        }
+        std::println(out, "  ]\n}}");
+    }
+
+    using key = std::tuple<std::string, std::string, std::size_t>;
+
+    /*reads ns_per_op from a csv file written by write_csv*/
+    inline auto read_baseline(const std::string& path)
+        -> std::optional<std::map<key, double>> {
+        std::ifstream in{path};
+        if (!in) { return std::nullopt; }
+        std::map<key, double> baseline{};
+        std::string line{};
+        std::getline(in, line);
+        while (std::getline(in, line)) {
+            std::vector<std::string> fields{};
+            std::istringstream row{line};
+            for (std::string field{}; std::getline(row, field, ',');) {
+                fields.push_back(field);
+            }
+            if (fields.size() < 5) { continue; }
+            baseline[{fields[0], fields[1], std::stoul(fields[2])}] =
+                std::stod(fields[4]);
+        }
+        return baseline;
+    }
+
+    /*prints every measured point next to its baseline and returns the number
+     * of points slower than baseline * (1 + threshold)*/
+    inline auto compare(const std::vector<record>& records,
+                        const std::map<key, double>& baseline,
+                        double threshold) -> std::size_t {
+        std::size_t regressions{0};
+        for (const auto& r : records) {
+            const auto found{baseline.find({r.kernel, r.type, r.size})};
+            if (found == baseline.end()) { continue; }
+            const double ratio{r.ns_per_op / found->second};
+            const bool regressed{ratio > 1.0 + threshold};
+            if (regressed) { regressions++; }
+            std::println("{:<26} {:<8} {:>5} {:>8.3f}x {}",
+                         r.kernel,
+                         r.type,
+                         r.size,
+                         ratio,
+                         regressed ? "REGRESSION" : "ok");
+        }
+        return regressions;
+    }
+
+}  // namespace benchmark